@@ -15,6 +15,7 @@
  * along with this program; if not, write to the Free Software Foundation,
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
+#include <QApplication>
 #include <QFileDialog>
 #include <QStringDecoder>
 #include <QTableView>
@@ -27,12 +28,19 @@
 #include <QProgressDialog>
 #include <QInputDialog>
 #include <QKeyEvent>
+#include <QMouseEvent>
 #include <QSaveFile>
 #include <QClipboard>
 #include <QToolTip>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStyle>
+#include <QTimer>
+#include <QEventLoop>
 
 #include <filesystem>
 #include <iostream>
@@ -46,6 +54,30 @@
 #include "tqtsettings.h"
 #include "tconfig.h"
 #include "tlogger.h"
+#include "tjsonreader.h"
+#include "tlogindex.h"
+#include "tlineparser.h"
+#include "tformatdetector.h"
+#include "ttimeparser.h"
+#include "tsearch.h"
+#include "ttrigramindex.h"
+#include "tfilterproxy.h"
+#include "tcolumnstore.h"
+#include "tfilterquery.h"
+#include "tvalidator.h"
+#include "tcalltree.h"
+#include "thotmethods.h"
+#include "ttraceexport.h"
+#include "tblockindex.h"
+#include "ttimelinedata.h"
+#include "ttimeline.h"
+#include "thistogramdata.h"
+#include "thistogram.h"
+#include "tminimap.h"
+#include "ttemplateminer.h"
+#include "ttemplatelist.h"
+#include "texceptiongroups.h"
+#include "texceptionlist.h"
 
 #define BUFFER_SIZE     16384
 #define APPNAME         "logviewer"
@@ -56,6 +88,11 @@
 #define TYPE_INFO       3
 #define TYPE_DEBUG      4
 
+#define ROLE_RECORD     (Qt::UserRole + 1)      // The index of the record in TLogIndex
+#define ROLE_COLLAPSED  (Qt::UserRole + 2)      // The text of an expanded cell before it was expanded
+#define ROLE_LINES      (Qt::UserRole + 3)      // The number of lines of a record with continuation lines
+#define ROLE_FOLDED     (Qt::UserRole + 4)      // TRUE = the row is the entry of a folded block
+
 namespace fs = std::filesystem;
 using std::string;
 using std::vector;
@@ -89,7 +126,10 @@ MainWindow::MainWindow(QString& file, QWidget *parent)
         return;
 
     if (!mFile.isEmpty() && fs::exists(file.toStdString()) && fs::is_regular_file(file.toStdString()))
+    {
+        mDetectFormat = true;                                                           // A file of the command line is new as well
         parseFile();
+    }
     else
         QMessageBox::warning(this, APPNAME, tr("The logfile is not valid or not readable!"));
 }
@@ -99,6 +139,28 @@ MainWindow::~MainWindow()
     DECL_TRACER("MainWindow::~MainWindow()");
 
     delete ui;
+
+    if (mSearchJob)                                 // Uses the index, so delete it first
+        delete mSearchJob;
+
+    reapSearches(true);
+
+    if (mTrigrams)
+        delete mTrigrams;
+
+    if (mColumnStore)
+        delete mColumnStore;
+
+    if (mBlocks)
+        delete mBlocks;
+
+    if (mMiner)
+        delete mMiner;
+
+    if (mIndex)
+        delete mIndex;
+
+    TConfig::restoreFormat();                                                           // Don't save a format detected for one file
     TConfig::saveConfig();
 }
 
@@ -108,12 +170,41 @@ void MainWindow::initialize()
 
     ui->setupUi(this);
 
+    mIconCollapsed = style()->standardIcon(QStyle::SP_ArrowRight);                 // Available in every Qt version, unlike the theme icons
+    mIconExpanded = style()->standardIcon(QStyle::SP_ArrowDown);
+    mIconFolded = style()->standardIcon(QStyle::SP_ToolBarVerticalExtensionButton);
     ui->actionFilter_thread->setChecked(true);
     ui->textEditResult->setAcceptRichText(true);
     ui->textEditResult->setReadOnly(true);
     ui->tableViewLog->setWordWrap(true);                                            // Enable word wrap
     ui->tableViewLog->setTextElideMode(Qt::ElideRight);                             // Draws elipses at the end of a line if the line is larger then the cell
     connect(ui->tableViewLog, &QTableView::pressed, this, &MainWindow::pressed);
+    connect(ui->tableViewLog, &QTableView::doubleClicked, this, &MainWindow::doubleClicked);
+    connect(ui->lineEditSearch, &QLineEdit::textChanged, this, &MainWindow::startSearch);
+    connect(ui->lineEditSearch, &QLineEdit::returnPressed, this, [this]() {
+        int current = currentSourceRow();
+        mLastSearchLine = showHit(current + 1, true);                               // Enter moves to the next hit
+    });
+    ui->widgetSearchBar->hide();
+
+    mProxy = new TFilterProxy(this);                                                // Shows only the rows matching the filter query
+    ui->tableViewLog->setModel(mProxy);
+
+    mMinimap = new TMinimap(ui->tableViewLog->verticalScrollBar(), this);            // The overview of the levels and hits beside the table
+    ui->horizontalLayoutTable->addWidget(mMinimap);
+
+    mHistogram = new THistogram(this);                                              // The rows per time bucket, shown on demand
+    ui->verticalLayout->insertWidget(1, mHistogram);
+    mHistogram->hide();
+    connect(mHistogram, &THistogram::rangeSelected, this, &MainWindow::filterTime);
+    connect(mHistogram, &THistogram::rangeCleared, this, [this]() {
+        mTimeRows.clear();
+        mTimeActive = false;
+        applyRowFilter();
+    });
+
+    if (!mIndex)
+        mIndex = new TLogIndex;
 
     QRect geom = TConfig::lastGeometry();
 
@@ -142,10 +233,59 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
 {
     DECL_TRACER("MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QString& thread_filter)");
 
-    if (ui->tableViewLog->model())
+    if (mModel)
+        mModel->removeRows(0, mModel->rowCount());
+
+    if (mColumnStore)                                                   // The encoded columns belong to the old rows
+    {
+        delete mColumnStore;
+        mColumnStore = nullptr;
+    }
+
+    mProxy->clearRows();                                                // Filters refer to the old rows
+    mQueryRows.clear();
+    mQueryActive = false;
+    mLevelMask = LEVEL_ALL;
+    mFoldedBlocks.clear();
+    mFoldedRows.clear();
+    mTimeRows.clear();
+    mTimeActive = false;
+    mHistogram->setData(nullptr, QStringList(), QList<QColor>());
+    mTemplateRows.clear();
+    mTemplateActive = false;
+
+    if (mTemplateList)                                                  // The patterns belong to the old rows
+        mTemplateList->close();
+
+    if (mExceptionList)
+        mExceptionList->close();
+
+    if (mMiner)
+    {
+        delete mMiner;
+        mMiner = nullptr;
+    }
+
+    if (mBlocks)                                                        // The blocks are paired again while loading
+        delete mBlocks;
+
+    mBlocks = new TBlockIndex(TConfig::getBlockEntry(), TConfig::getBlockExit());
+
+    if (mSearchJob)                                                     // A running search refers to the mapped file
+    {
+        dropSearch(mSearchJob);
+        mSearchJob = nullptr;
+    }
+
+    reapSearches(true);                                                 // The canceled ones stop within a record
+
+    mBarRecords.clear();
+    mBarDone = false;
+
+    if (mTrigrams)                                                      // The search index refers to the mapped file
     {
-        auto model = ui->tableViewLog->model();
-        model->removeRows(0, model->rowCount());
+        delete mTrigrams;
+        mTrigrams = nullptr;
     }
 
     if (mFile.isEmpty())
@@ -157,6 +297,8 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
         ui->tableViewLog->setWordWrap(true);
 
     mThreads.clear();
+    mSearchHits.clear();                                                // The rows will change
+    mMinimap->reset(0);
     QProgressDialog *progress = nullptr;
     bool canceled = false;
     QString target = mFile;
@@ -181,6 +323,29 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
         mTempFile = target;
     }
 
+    if (mDetectFormat)                                                                  // Is this a newly opened file?
+    {
+        mDetectFormat = false;
+        mFormatInfo.clear();
+        TConfig::restoreFormat();                                                       // The format detected for the previous file is dropped
+
+        if (TConfig::getAutoDetect() && !filter.startsWith("JSon", Qt::CaseInsensitive))
+        {
+            TFormatDetector detector;
+
+            if (detector.detect(target) && !detector.fitsConfig())                      // Doesn't the current profile fit the file?
+            {
+                TConfig::backupFormat();                                                // Only for this file
+
+                if (detector.apply())                                                   // Then take the detected format
+                {
+                    mFormatInfo = detector.description();
+                    MSG_INFO("Detected format: " << mFormatInfo.toStdString());
+                }
+            }
+        }
+    }
+
     QStringList colAligns;
     QString cas = TConfig::getColAligns();
 
@@ -188,7 +353,6 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
         colAligns = cas.split(",", Qt::SkipEmptyParts);
 
     TColoring coloring;
-    ifstream inFile;                                                                    // The stream used to read the file
     QStandardItemModel *model = new QStandardItemModel;                                 // The standard model holding each cell of the table
     model->setColumnCount(TConfig::getColumns());                                       // We're setting the number of columns
     QStringList headers = TConfig::headers();                                           // Get the headers from configuration
@@ -205,7 +369,18 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
     int bopen = 0;      // Detects block starts
     int bclose = 0;     // Detects block ends
 
-    if (filter.startsWith("JSon", Qt::CaseInsensitive))
+    TConfig::FORMAT_t format = TConfig::getFormat();                                    // The format of the lines
+    bool json = filter.startsWith("JSon", Qt::CaseInsensitive) || format == TConfig::FORMAT_JSON;  // TRUE = the file contains JSON records
+    mJsonRecords = json;
+    vector<TJsonReader::ROW_t> jsonRows;                                                // The parsed JSON records
+
+    if (!mIndex->open(target))                                                          // Map the file into memory
+    {
+        QMessageBox::warning(this, APPNAME, tr("Error reading a logfile!"));
+        return false;
+    }
+
+    if (json)
     {
         MSG_INFO("Parsing a JSON file ...");
 
@@ -214,12 +389,74 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
             QMessageBox::warning(this, APPNAME, tr("JSON parsing was not configured!<br>Please configure JSON values first in the <i>settings</i>."));
             return false;
         }
+
+        if (mTimeWindow)                                                                // The records of a JSON file are found by TJsonReader
+            MSG_WARN("A time window is not supported for JSON files. The whole file is loaded.");
+
+        // The records may be pretty-printed over several lines or wrapped
+        // into an array. Therefore the boundaries of the records are
+        // searched first and then all records are parsed in parallel.
+        TJsonReader reader(target);
+
+        if (!reader.split() || !reader.parse(TConfig::values(), TConfig::getDelimeter(), jsonRows))
+        {
+            QMessageBox::warning(this, APPNAME, tr("Error reading a logfile!"));
+            return false;
+        }
+
+        mIndex->setRecords(reader.records());                                           // Every record is one row
+    }
+    else if (mTimeWindow && !selectTimeWindow())                                        // Find the bytes of the time window
+    {
+        mIndex->close();
+        return false;
+    }
+    else if (!mIndex->scan(TConfig::getRecordStart()))                                  // Find all records. A record may consist of several lines.
+    {
+        QMessageBox::warning(this, APPNAME, tr("Error reading a logfile!<br>Please check the regular expression for the start of a record in the <i>settings</i>."));
+        return false;
     }
 
-    try
+    if (totalLines != mIndex->size())                                                   // Continuation lines or JSON records may change the number of rows
+    {
+        totalLines = mIndex->size();
+        ui->tableViewLog->setWordWrap(totalLines <= 50000);
+    }
+
+    bool multiLine = !json && !TConfig::getRecordStart().isEmpty();                     // TRUE = a record may contain continuation lines
+    bool builtIn = !json && (format == TConfig::FORMAT_LOGFMT || format == TConfig::FORMAT_SYSLOG);    // TRUE = a built-in parser finds the columns
+    bool parsed = builtIn || (!json && format == TConfig::FORMAT_REGEX);                // TRUE = the columns are found by TLineParser
+    vector<QStringList> parsedRows;                                                     // The columns of every record matching the format
+
+    if (parsed)
     {
-        inFile.open(target.toStdString());                                                  // Open file
+        TLineParser parser(mIndex, TConfig::getColumns());
+
+        if (builtIn)
+            parser.setFormat(format, TConfig::headers());
+        else if (!parser.setRegex(TConfig::getLineRegex(), TConfig::headers()))
+        {
+            QMessageBox::warning(this, APPNAME, tr("The line format is not a valid regular expression:<br>%1").arg(parser.errorString()));
+            return false;
+        }
+
+        parser.parse(parsedRows);                                                       // Parse all lines in parallel
+    }
+
+    int timeColumn = TConfig::getTimeColumn() - 1;                                      // The column containing the timestamp (-1 = none)
+    TTimeParser timeParser(TConfig::getTimeLayout());                                   // Converts the timestamps into microseconds
+    vector<qint64> times;                                                               // The timestamp of every record
+    vector<quint8> levels;                                                              // The level of every row (LEVEL_t)
+    levels.reserve(mIndex->size());
 
+    if (timeColumn >= 0 && !timeParser.isValid())                                       // The parser falls back to ISO 8601
+        QMessageBox::warning(this, APPNAME, tr("The timestamp layout is not valid:<br>%1<br>ISO 8601 timestamps are expected instead.").arg(timeParser.errorString()));
+
+    if (timeColumn >= 0)
+        times.assign(mIndex->size(), TTimeParser::INVALID);
+
+    try
+    {
         if (totalLines > 10000)                                                             // Do we have more then 10000 lines?
         {                                                                                   // Yes, then ...
             progress = new QProgressDialog(tr("Loading file ..."), tr("Cancel"), 0, totalLines, this);  // Allocate a progress bar
@@ -227,7 +464,7 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
             model->setRowCount(totalLines);                                                 // Set the total number of lines (progress bar will show percents)
         }
 
-        for (string line; getline(inFile, line);)                                           // Loop over all lines in file
+        for (qsizetype record = 0; record < mIndex->size(); ++record)                       // Loop over all records in file
         {
             if (progress)                                                                   // Do we have a progress bar?
             {                                                                               // Yes, the feed it ...
@@ -240,101 +477,39 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
                 }
             }
 
-            if (mLastFilterCheck && !thread_filter.isEmpty() && TConfig::getColumnThreadID() > 0)
-            {
-                if (line.find(thread_filter.toStdString()) == string::npos)
-                    continue;
-            }
-
             QStringList parts;                                                              // Holds the content of the columns
-            QString qLine = QString::fromStdString(line);                                   // Assign the line to a QString class
-            bool isJson = qLine.startsWith("{");                                            // If the line starts with a {, then it may be a JSON formatted line
-
-            if (!filter.isEmpty() &&                                                        // Is the log in JSON format?
-                filter.startsWith("JSon", Qt::CaseInsensitive) &&
-                isJson)
-            {                                                                               // Yes, then parse it first to a string
-#if QT_VERSION < QT_VERSION_CHECK(6, 8, 0)
-                QJsonDocument jdoc = QJsonDocument::fromJson(QByteArray(line.c_str()));             // Create JSON object out of string
-#else
-                QJsonDocument jdoc = QJsonDocument::fromJson(QByteArray(line));             // Create JSON object out of string
-#endif
-                QJsonObject jline = jdoc.object();                                          // Get out the base object
-                QList<VALUES_t> values = TConfig::values();                                 // Get the wanted value names and types from config
-                QList<VALUES_t>::iterator iter;                                             // Declare an iterator
-                qLine.clear();                                                              // Clear qLine
-                bool first = true;                                                          // This will be false after the first element was processed in the loop
-                QString sIndex;                                                             // The name of the value is used as an index
-                QJsonObject content;                                                        // Contains the object containing the wanted element
-
-                for (iter = values.begin(); iter != values.end(); ++iter)                   // Loop through all JSON values
-                {
-                    if (!first)                                                             // If it is not the first element ...
-                        qLine.append(TConfig::getDelimeter());                              // Append the delimiter
-
-                    if (iter->name == values.last().name)                                   // If it is the last entry in the list ...
-                        qLine.append(" ");                                                  // Append a blank to avoid cutting off first character
-
-                    if (iter->name.contains("."))                                           // If the JSON name contains a dot (.) ...
-                    {                                                                       // then we must split the name into parts because the first name is the object containing the wanted object.
-                        // TODO: Make deeper objects available by looping through all parts!
-                        //       This implies that arrays should also be possible
-                        QStringList pa = iter->name.split(".");                             // Split the name
-                        sIndex = pa[1];                                                     // Assign the value name as an index
-                        content = jline[pa[0]].toObject();                                  // Get the top object
-                    }
-                    else
-                    {
-                        sIndex = iter->name;                                                // Assign the value name as an index
-                        content = jline;                                                    // Assign the base object
-                    }
+            QString qLine;                                                                  // The line or the values of a record joined by the delimiter
+            bool isJson = false;                                                            // TRUE = qLine contains the values of a JSON record
+            qsizetype lineCount = 1;                                                        // The number of lines of the record
 
-                    switch(iter->type)                                                      // Switch through possible value types
-                    {
-                        case VALTYPES_t::VTYPE_STRING:
-                        {
-                            QString p = content[sIndex].toString(" ");                      // Get the string from the object
-                            p.replace(",", " ");                                            // Replace all commas into spaces
-                            qLine.append(p);                                                // Append it to the qLine
-                        }
-                        break;
-
-                        case VALTYPES_t::VTYPE_INT:
-                            qLine.append(QString("%1").arg(content[sIndex].toInt()));       // Append it to the qLine
-                        break;
-
-                        case VALTYPES_t::VTYPE_LONG:
-                            qLine.append(QString("%1").arg(content[sIndex].toInteger()));   // Append it to the qLine
-                        break;
-
-                        case VALTYPES_t::VTYPE_FLOAT:
-                        case VALTYPES_t::VTYPE_DOUBLE:
-                            qLine.append(QString("%1").arg(content[sIndex].toDouble()));    // Append it to the qLine
-                        break;
-
-                        case VALTYPES_t::VTYPE_BOOL:
-                            qLine.append(QString("%1").arg(content[sIndex].toBool()));      // Append it to the qLine
-                        break;
-                    }
+            if (json)
+            {
+                TJsonReader::ROW_t& row = jsonRows[record];
+                qLine = std::move(row.line);
+                isJson = row.json;
+            }
+            else
+            {
+                qLine = mIndex->firstLine(record);                                          // Only the first line of a record contains the columns
 
-                    first = false;                                                          // Mark first element as processed
-                }
+                if (multiLine)
+                    lineCount = mIndex->lineCount(record);
             }
 
-            if (!filter.isEmpty() &&                                                        // if JSON format but line is not ...
-                filter.startsWith("JSon", Qt::CaseInsensitive) &&
-                !isJson)
-            {
-                // Here we have a line which is not in JSON format although it should be.
-                // Therefore we'll put the whole line into the last column.
-                for (int i = 0; i < TConfig::getColumns(); ++i)                             // Create empty colums
-                    parts << QString();
+            if (mLastFilterCheck && !thread_filter.isEmpty() && TConfig::getColumnThreadID() > 0 && !qLine.contains(thread_filter))
+                continue;
 
-                parts[parts.size()-1] = qLine;                                              // Assign whole line to last column
+            if (parsed)                                                                     // Is the format defined by a regular expression or a built-in format?
+            {                                                                               // Yes, then take the columns. They are empty if the line doesn't match.
+                parts = std::move(parsedRows[record]);
+
+                if (builtIn && !parts.isEmpty())                                            // The level was replaced by the configured tag
+                    qLine = parts.join(' ');                                                // Classify the line by its columns
             }
-            else if (qLine.contains(TConfig::getDelimeter()))                               // Does the line contain at least 1 delimiter?
+            else if ((!json || isJson) && qLine.contains(TConfig::getDelimeter()))          // Does the line contain at least 1 delimiter?
                 parts = split(qLine, TConfig::getDelimeter(), TConfig::getColumns() - 1);   // Split the line into parts seperated by the defined delimeter
-            else                                                                            // No delimiters in line?
+
+            if (parts.isEmpty())                                                            // No columns found or not in JSON format although it should be?
             {                                                                               // Then add whole line to the last column ...
                 for (int i = 0; i < TConfig::getColumns(); ++i)                             // Create empty columns
                     parts << QString();
@@ -342,33 +517,43 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
                 parts[parts.size()-1] = qLine;                                              // Assign whole line to the last column
             }
 
+            if (timeColumn >= 0 && timeColumn < parts.size())                               // Is there a time column?
+                times[record] = timeParser.parse(parts[timeColumn]);                        // Yes, then keep the timestamp as number
+
             QStandardItem *item = nullptr;                                                  // Initialize the standard item used for the cells of the table
             QColor bgColor;                                                                 // The background color; Calculated for each row
             QColor bgThread(Qt::white);                                                     // The background color of the thread column, if there is any
 
+            LEVEL_t level = LEVEL_OTHER;                                                    // The level of the row, kept for the level filter
+
             if (qLine.contains(TConfig::getTagInfo()))                                      // Test for tag INF
             {
                 bgColor = TConfig::colorInfo();                                             // Set background color
+                level = LEVEL_INFO;                                                         // Remember the level
                 iInfo++;                                                                    // Increase counter
             }
             else if (qLine.contains(TConfig::getTagWarning()))                              // Test for tag WRN
             {
                 bgColor = TConfig::colorWarning();                                          // Set background color
+                level = LEVEL_WARNING;                                                      // Remember the level
                 iWarn++;                                                                    // Increase counter
             }
             else if (qLine.contains(TConfig::getTagError()))                                // Test for tag ERR
             {
                 bgColor = TConfig::colorError();                                            // Set background color
+                level = LEVEL_ERROR;                                                        // Remember the level
                 iError++;                                                                   // Increase counter
             }
             else if (qLine.contains(TConfig::getTagTrace()))                                // Test for tag TRC
             {
                 bgColor = TConfig::colorTrace();                                            // Set background color
+                level = LEVEL_TRACE;                                                        // Remember the level
                 iTrace++;                                                                   // Increase counter
             }
             else if (qLine.contains(TConfig::getTagDebug()))                                // Test for tag DBG
             {
                 bgColor = TConfig::colorDebug();                                            // Set background color
+                level = LEVEL_DEBUG;                                                        // Remember the level
                 iDebug++;                                                                   // Increase counter
             }
             else                                                                            // Else we have other type (FNE, ...)
@@ -377,10 +562,21 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
                 iOther++;                                                                   // Increase counter
             }
 
+            bool blockLine = true;                                                          // TRUE = the line opens or closes a block
+
             if (qLine.contains(TConfig::getBlockEntry()))                                   // Test for start of block
                 bopen++;                                                                    // Increase counter
             else if (qLine.contains(TConfig::getBlockExit()))                               // Test for end of block
                 bclose++;                                                                   // Increase counter
+            else
+                blockLine = false;
+
+            if (blockLine)                                                                  // Pair the blocks for folding and jumping to the partner
+            {
+                int colThread = TConfig::getColumnThreadID();
+                bool hasThread = colThread > 0 && colThread < TConfig::getColumns() && colThread <= parts.size();
+                mBlocks->addRow(lines, qLine, hasThread ? parts[colThread - 1].trimmed() : QString());
+            }
 
             for (int i = 0; i < TConfig::getColumns(); ++i)                                 // Loop for the defined number of columns
             {
@@ -470,18 +666,23 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
                 }
             }
 
+            model->item(lines, 0)->setData(static_cast<qlonglong>(record), ROLE_RECORD);     // Remember the record to find its content in the index
+
+            if (lineCount > 1)                                                              // Has the record continuation lines?
+            {                                                                               // Yes, then mark it as expandable
+                item = model->item(lines, TConfig::getColumns() - 1);
+                item->setData(lineCount, ROLE_LINES);
+                updateMarker(item);
+            }
+
+            levels.push_back(level);                                                        // One byte per row
             lines++;                                                                        // increase line counter
         }
-
-        inFile.close();                                                                     // Close file
     }
     catch (std::exception& e)                                                               // triggered if there was a read error
     {
         MSG_ERROR("Error reading file \"" << mFile.toStdString() << "\": " << e.what());
 
-        if (inFile.is_open())
-            inFile.close();
-
         QMessageBox::warning(this, APPNAME, tr("Error reading a logfile!"));
         return false;
     }
@@ -489,11 +690,22 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
     if (progress)                                                                       // Did we had a progress bar?
         delete progress;                                                                // Yes, then delete it. This makes the dialog disappear
 
+    if (timeColumn >= 0)
+    {
+        qsizetype invalid = std::count(times.begin(), times.end(), TTimeParser::INVALID);
+
+        if (invalid > 0)
+            MSG_WARN(invalid << " of " << times.size() << " records have no valid timestamp in column " << (timeColumn + 1));
+
+        mIndex->setTimes(std::move(times));                                             // Keep the timestamps for time based navigation
+    }
+
     if (canceled)                                                                       // Did the user hit the cancel button?
     {
         model->clear();                                                                 // Delete all cells from the model
+        mLevels.clear();                                                                // No rows, no levels
         mTotalLines = 0;                                                                // Reset the counted lines
-        ui->tableViewLog->setModel(model);                                              // Asign the model to the table (now the table will be empty)
+        setModel(model);                                                                // Asign the model to the table (now the table will be empty)
         clearStatusbar();                                                               // Clear the statusbar
         mLbFile = new QLabel;                                                           // Allocate a new QLabel
         mLbFile->setText("File loading was caneled");                                   // Set the text
@@ -502,7 +714,15 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
     }
 
     mTotalLines = lines;                                                                // Remember the number of total lines read
-    ui->tableViewLog->setModel(model);                                                  // Asign the model to the table
+    setModel(model);                                                                    // Asign the model to the table
+    mLevels = std::move(levels);                                                        // Keep the levels for the level filter
+    mLevels.resize(model->rowCount(), LEVEL_NONE);                                      // Rows reserved for the progress bar may stay empty
+    mBlocks->finish(model->rowCount());                                                 // The partner of every block line
+
+    updateMinimap();                                                                    // Mark the errors and warnings of the new rows
+
+    if (ui->actionTime_histogram->isChecked())                                          // Count the new rows if the histogram is shown
+        updateHistogram();
     // The following limit is necessary because it would take too long to
     // format the lines. During this is working the app appears stalled.
     if (lines <= 50000)                                                                 // Only if the lines less then 50000.
@@ -537,7 +757,15 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
     mLbFile = new QLabel;                                                               // Allocate a new QLabel
     QString _f = getFileName(mFile);                                                    // Strip path and get file name only
     mLbFile->setText(QString("File: %1").arg(_f));                                      // Write the file name into the status bar.
+
+    if (mTimeWindow && mIndex->isWindow())                                              // Was only a time window loaded?
+        mLbFile->setText(QString("File: %1 [%2 - %3]").arg(_f, TTimeParser::toString(mWindowStart), TTimeParser::toString(mWindowEnd)));
+
     mLbFile->setFrameStyle(QFrame::Panel | QFrame::Sunken);                             // Set a fancy frame style
+
+    if (!mFormatInfo.isEmpty())                                                         // Was the format detected?
+        mLbFile->setToolTip(tr("Detected format: %1").arg(mFormatInfo));                // Yes, then show it as tool tip
+
     ui->statusbar->addWidget(mLbFile);                                                  // Add the widget to the statusbar
 
     mLbLines = new QLabel;
@@ -548,26 +776,31 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
     mLbTraces = new QLabel;
     mLbTraces->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     mLbTraces->setText(QString("Traces: %1").arg(iTrace));
+    setupLevelLabel(mLbTraces, LEVEL_TRACE);
     ui->statusbar->addWidget(mLbTraces);
 
     mLbInfos = new QLabel;
     mLbInfos->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     mLbInfos->setText(QString("Infos: %1").arg(iInfo));
+    setupLevelLabel(mLbInfos, LEVEL_INFO);
     ui->statusbar->addWidget(mLbInfos);
 
     mLbWarnings = new QLabel;
     mLbWarnings->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     mLbWarnings->setText(QString("Warnings: %1").arg(iWarn));
+    setupLevelLabel(mLbWarnings, LEVEL_WARNING);
     ui->statusbar->addWidget(mLbWarnings);
 
     mLbErrors = new QLabel;
     mLbErrors->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     mLbErrors->setText(QString("Errors: %1").arg(iError));
+    setupLevelLabel(mLbErrors, LEVEL_ERROR);
     ui->statusbar->addWidget(mLbErrors);
 
     mLbDebugs = new QLabel;
     mLbDebugs->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     mLbDebugs->setText(QString("Debugs: %1").arg(iDebug));
+    setupLevelLabel(mLbDebugs, LEVEL_DEBUG);
     ui->statusbar->addWidget(mLbDebugs);
 
     if (iOther > 0)
@@ -575,9 +808,27 @@ bool MainWindow::parseFile(qsizetype totalLines, const QString& filter, const QS
         mLbOthers = new QLabel;
         mLbOthers->setFrameStyle(QFrame::Panel | QFrame::Sunken);
         mLbOthers->setText(QString("Others: %1").arg(iOther));
+        setupLevelLabel(mLbOthers, LEVEL_OTHER);
         ui->statusbar->addWidget(mLbOthers);
     }
 
+    if (TConfig::getSearchIndex())                                                      // Build the search index in the background
+    {
+        mTrigrams = new TTrigramIndex(mIndex);
+
+        mTrigrams->start([this]() {
+            // Called by the background thread
+            QMetaObject::invokeMethod(this, [this]() {
+                if (!mTrigrams || !mTrigrams->isReady())                                // Was the file closed in the meantime?
+                    return;
+
+                ui->statusbar->showMessage(tr("Search index ready: %1 MB for %2 blocks, built in %3 ms")
+                                           .arg(static_cast<double>(mTrigrams->memoryUsage()) / (1024.0 * 1024.0), 0, 'f', 1)
+                                           .arg(mTrigrams->blocks()).arg(mTrigrams->buildTime()), 10000);
+            }, Qt::QueuedConnection);
+        });
+    }
+
     return true;
 }
 
@@ -632,6 +883,12 @@ void MainWindow::clearStatusbar()
         ui->statusbar->removeWidget(mLbOthers);
         mLbOthers = nullptr;
     }
+
+    if (mLbFilter)
+    {
+        ui->statusbar->removeWidget(mLbFilter);
+        mLbFilter = nullptr;
+    }
 }
 
 qsizetype MainWindow::countLines(const QString& file)
@@ -674,6 +931,103 @@ qsizetype MainWindow::countLines(const QString& file)
     return lines;
 }
 
+/**
+ * @brief MainWindow::setModel
+ * Shows a new model in the table. The model replaces the last one, which
+ * is deleted.
+ *
+ * @param model The model holding the cells of the table.
+ */
+void MainWindow::setModel(QStandardItemModel *model)
+{
+    DECL_TRACER("MainWindow::setModel(QStandardItemModel *model)");
+
+    QStandardItemModel *old = mModel;
+    mModel = model;
+    mProxy->setSourceModel(model);
+
+    if (old && old != model)
+        delete old;
+}
+
+/**
+ * @brief MainWindow::selectSourceRow
+ * Selects a row of the model and scrolls it into the middle of the table.
+ * Nothing happens if the row is filtered out.
+ *
+ * @param row   The row of the model.
+ */
+void MainWindow::selectSourceRow(int row)
+{
+    if (!mModel || row < 0 || row >= mModel->rowCount())
+        return;
+
+    QModelIndex index = mProxy->mapFromSource(mModel->index(row, 0));
+
+    if (!index.isValid())
+        return;
+
+    ui->tableViewLog->selectRow(index.row());
+    ui->tableViewLog->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+/**
+ * @brief MainWindow::currentSourceRow
+ * @return The row of the model of the current cell or -1 if there is none.
+ */
+int MainWindow::currentSourceRow()
+{
+    QModelIndex index = ui->tableViewLog->currentIndex();
+    return index.isValid() ? mProxy->mapToSource(index).row() : -1;
+}
+
+/**
+ * @brief MainWindow::recordOfRow
+ * Returns the index of the record shown in a row of the table.
+ *
+ * @param row   The row of the table.
+ * @return The index of the record in the index or -1 if the row is empty.
+ */
+qsizetype MainWindow::recordOfRow(int row)
+{
+    if (!mModel || row < 0 || row >= mModel->rowCount())
+        return -1;
+
+    QStandardItem *item = mModel->item(row, 0);
+    return item ? item->data(ROLE_RECORD).toLongLong() : -1;
+}
+
+/**
+ * @brief MainWindow::rowOfRecord
+ * Finds the row showing a record. Because filtered records are skipped, the
+ * rows contain a growing subset of the records. Therefore a binary search
+ * returns the first row showing the record or a record after it.
+ *
+ * @param record    The index of the record.
+ * @param first     The first row to consider.
+ * @return The row or -1 if there is no row for the record.
+ */
+int MainWindow::rowOfRecord(qsizetype record, int first)
+{
+    if (!mModel)
+        return -1;
+
+    int low = std::max(0, first), high = mModel->rowCount();
+
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        qsizetype rec = recordOfRow(mid);
+
+        if (rec >= 0 && rec < record)                   // Empty rows are at the end
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return (low < mModel->rowCount() && recordOfRow(low) >= 0) ? low : -1;
+}
+
 // The menu
 
 /**
@@ -700,12 +1054,52 @@ void MainWindow::on_actionOpen_triggered()
     {
         // Count lines in file
         qsizetype lines = countLines(mFile);
+        mDetectFormat = true;
+        mTimeWindow = false;
         parseFile(lines, mLastFileFilter);
     }
     else
         QMessageBox::warning(this, APPNAME, tr("The logfile is not valid or not readable!"));
 }
 
+/**
+ * @brief MainWindow::on_actionOpen_time_window_triggered
+ * Opens a file like on_actionOpen_triggered() but loads only the records of
+ * a time range. The range is asked for after the file was mapped. The lines
+ * are not counted first because this would read the whole file.
+ */
+void MainWindow::on_actionOpen_time_window_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionOpen_time_window_triggered()");
+
+    if (TConfig::getTimeColumn() <= 0)
+    {
+        QMessageBox::information(this, APPNAME, tr("There is no time column!<br>Please set the column of the timestamp in the <i>settings</i> first."));
+        return;
+    }
+
+    if (!mTempFile.isEmpty())
+    {
+        if (fs::exists(mTempFile.toStdString()))
+            fs::remove(mTempFile.toStdString());
+
+        mTempFile.clear();
+    }
+
+    mFile = getLogFileName(&mLastFileFilter);
+    mLastSearchLine = 0;
+
+    if (!mFile.isEmpty() && fs::exists(mFile.toStdString()) && fs::is_regular_file(mFile.toStdString()))
+    {
+        mDetectFormat = true;
+        mTimeWindow = true;
+        mWindowStart = mWindowEnd = LLONG_MIN;                                          // Ask for the window
+        parseFile(0, mLastFileFilter);
+    }
+    else
+        QMessageBox::warning(this, APPNAME, tr("The logfile is not valid or not readable!"));
+}
+
 
 void MainWindow::on_actionSave_result_triggered()
 {
@@ -852,20 +1246,13 @@ void MainWindow::on_actionValidate_consistnace_triggered()
 {
     DECL_TRACER("MainWindow::on_actionValidate_consistnace_triggered()");
 
-    typedef struct CLASS_STACK_t
-    {
-        int line{0};            // The line number
-        QString threadId;       // If there is such a column, this contains the threadID
-        QString method;         // The name of the function / method (depends on language)
-    }CLASS_STACK_t;
-
     mSaveFile.clear();
     // Progress meter
     QProgressDialog progress(tr("Validating lines ..."), tr("Cancel"), 0, mTotalLines, this);
     progress.setWindowModality(Qt::WindowModal);
     bool canceled = false;
 
-    QStandardItemModel *model = static_cast<QStandardItemModel *>(ui->tableViewLog->model());
+    QStandardItemModel *model = mModel;
 
     if (!model)
     {
@@ -875,107 +1262,32 @@ void MainWindow::on_actionValidate_consistnace_triggered()
 
     qsizetype rows = model->rowCount();
     int column = TConfig::getColumns() - 1;
-    QList<QString> stack;
-    vector<CLASS_STACK_t> classStack;
-    QList<int> errorLines;
-    QString startBlock = TConfig::getBlockEntry();
-    QString endBlock = TConfig::getBlockExit();
     int colThread = TConfig::getColumnThreadID();
+    TValidator validator(TConfig::getBlockEntry(), TConfig::getBlockExit());
 
-    for (qsizetype line = 0; line < rows; ++line)
-    {
-        progress.setValue(line);
-
-        if (progress.wasCanceled())
-        {
-            canceled = true;
-            break;
-        }
-
-        QStandardItem *item = model->item(line, column);
-        QString qLine = item->text();
+    if (colThread <= 0 || colThread >= TConfig::getColumns())              // The thread must not be the last column
+        colThread = 0;
 
-        if (qLine.contains(startBlock))
+    for (qsizetype line = 0; line < rows; ++line)                           // Collect the block lines of every thread
+    {
+        if ((line & 0x3ff) == 0)
         {
-            qsizetype pos = qLine.indexOf(startBlock);
-            QString method = qLine.last(qLine.size() - pos - startBlock.length() - 1);
-
-            if (colThread <= 0)
-                stack.append(method);
+            progress.setValue(line);
 
-            if ((pos = method.indexOf("::")) != -1)
+            if (progress.wasCanceled())
             {
-                QString left = method.left(pos);
-                QString right = method.last(method.length() - pos - 2);
-
-                if (right.contains(left) && !right.startsWith("~"))
-                {
-                    CLASS_STACK_t cs;
-                    cs.line = line;
-                    cs.method = left;
-
-                    if (colThread > 0 && colThread < TConfig::getColumns())
-                    {
-                        QStandardItem *it = model->item(line, colThread - 1);
-                        cs.threadId = it->text();
-                    }
-
-                    classStack.push_back(cs);
-                }
+                canceled = true;
+                break;
             }
         }
-        else if (qLine.contains(endBlock))
-        {
-            if (colThread <= 0)
-            {
-                if (stack.size() > 0 && qLine.contains(stack.last()))
-                    stack.removeLast();
-                else
-                    errorLines.append(line);
-            }
-
-            if (!classStack.empty())
-            {
-                vector<CLASS_STACK_t>::reverse_iterator iter;
-                int l = 0;
-
-                for (iter = classStack.rbegin(); iter != classStack.rend(); ++iter)
-                {
-                    QString search = QString("::~%1").arg(iter->method);
 
-                    if (colThread <= 0)
-                    {
-                        if (qLine.contains(search))
-                        {
-                            l = iter->line;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        if (qLine.contains(iter->threadId) && qLine.contains(search))
-                        {
-                            l = iter->line;
-                            break;
-                        }
-                    }
-                }
+        QStandardItem *item = model->item(line, column);
 
-                if (l)
-                {
-                    vector<CLASS_STACK_t>::iterator iter;
+        if (!item)
+            continue;
 
-                    for (iter = classStack.begin(); iter != classStack.end(); ++iter)
-                    {
-                        if (iter->line == l)
-                        {
-                            classStack.erase(iter);
-                            break;
-                        }
-                    }
-                }
-            }
-        }
+        QStandardItem *thread = colThread > 0 ? model->item(line, colThread - 1) : nullptr;
+        validator.addRow(static_cast<int>(line), item->text(), thread ? thread->text().trimmed() : QString());
     }
 
     ui->textEditResult->clear();
@@ -983,33 +1295,32 @@ void MainWindow::on_actionValidate_consistnace_triggered()
     if (canceled)
         return;
 
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    validator.validate();                                                   // The threads are validated in parallel
+    QApplication::restoreOverrideCursor();
+    progress.setValue(mTotalLines);
+
     QString report;
+    const TRowBitmap& errorLines = validator.errorRows();
 
     if (errorLines.isEmpty())
         report.append("<h2>Result of block validation</h2><p>No errors found.</p>");
     else
     {
         report.append("<h2>Result of block validation</h2><p>");
-        QList<int>::iterator iter;
-
-        for (iter = errorLines.begin(); iter != errorLines.end(); ++iter)
-        {
-            report.append(QString("Error in line: %1<br>").arg(*iter+1));
-        }
+        errorLines.forEach([&report](quint32 line) {
+            report.append(QString("Error in line: %1<br>").arg(line+1));
+        });
 
         report.append("</p>");
     }
 
-    if (!classStack.empty())
+    if (!validator.mismatches().empty())
     {
         report.append("<h2>Result of method match</h2><p>");
 
-        vector<CLASS_STACK_t>::iterator iter;
-
-        for (iter = classStack.begin(); iter != classStack.end(); ++iter)
-        {
-            report.append(QString("Method mismatch in line: %1, %2<br>").arg(iter->line+1).arg(iter->method));
-        }
+        for (const TValidator::MISMATCH_t& mismatch : validator.mismatches())
+            report.append(QString("Method mismatch in line: %1, %2<br>").arg(mismatch.row+1).arg(mismatch.className));
 
         report.append("</p>");
     }
@@ -1017,84 +1328,1457 @@ void MainWindow::on_actionValidate_consistnace_triggered()
     ui->textEditResult->setText(report);
 }
 
+/**
+ * @brief MainWindow::on_actionFind_exceptions_triggered
+ * Searches the messages for exceptions and groups them by their fingerprint
+ * (see TExceptionGroups). The report lists the groups with their counts and
+ * timelines. The dialog lists every exception and shows the lines around
+ * the selected one.
+ */
 void MainWindow::on_actionFind_exceptions_triggered()
 {
     DECL_TRACER("MainWindow::on_actionFind_exceptions_triggered()");
 
     mSaveFile.clear();
+    QStandardItemModel *model = mModel;
+
+    if (!model)
+    {
+        MSG_ERROR("No model found!");
+        return;
+    }
+
+    TExceptionGroups groups(TConfig::getExceptionPattern(), TConfig::getStackPattern());
+
+    if (!groups.isValid())
+    {
+        MSG_ERROR(groups.errorString().toStdString());
+        QMessageBox::warning(this, APPNAME, groups.errorString());
+        return;
+    }
+
     // Progress meter
     QProgressDialog progress(tr("Searching for exceptions ..."), tr("Cancel"), 0, mTotalLines, this);
     progress.setWindowModality(Qt::WindowModal);
     bool canceled = false;
 
-    QStandardItemModel *model = static_cast<QStandardItemModel *>(ui->tableViewLog->model());
+    qsizetype rows = model->rowCount();
+    int column = TConfig::getColumns() - 1;
+    bool times = mIndex && mIndex->hasTimes();
+    qint64 lastTime = 0;
+
+    for (qsizetype line = 0; line < rows; ++line)
+    {
+        if ((line & 0x3ff) == 0)
+        {
+            progress.setValue(line);
+
+            if (progress.wasCanceled())
+            {
+                canceled = true;
+                break;
+            }
+        }
+
+        QStandardItem *item = model->item(line, column);
+
+        if (!item)
+            continue;
+
+        QVariant collapsed = item->data(ROLE_COLLAPSED);                    // An expanded cell is tested by its first line
+        QString message = collapsed.isValid() ? collapsed.toString() : item->text();
+        QString type = groups.match(message);
+
+        if (type.isEmpty())
+            continue;
+
+        int row = static_cast<int>(line);
+        qint64 position = line;                                             // Without times the timeline is spread over the rows
+
+        if (times)
+        {
+            qsizetype record = recordOfRow(row);
+            qint64 usec = (record >= 0) ? mIndex->time(record) : TTimeParser::INVALID;
+
+            if (usec != TTimeParser::INVALID)
+                lastTime = usec;
+
+            position = lastTime;
+        }
+
+        groups.addException(row, type, message, stackTrace(groups, row), position);
+    }
+
+    // Report the result
+    ui->textEditResult->clear();
+
+    if (canceled)
+        return;
+
+    progress.setValue(mTotalLines);
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    groups.group();
+    QApplication::restoreOverrideCursor();
+
+    QString report;
+    report.append("<h2>Exceptions found</h2>");
+
+    if (groups.groups().empty())
+        report.append("<p>No exceptions found!</p>");
+    else
+    {
+        report.append(QString("<p>%1 exceptions in %2 groups</p>").arg(groups.exceptions()).arg(groups.groups().size()));
+
+        for (const TExceptionGroups::GROUP_t& group : groups.groups())
+        {
+            report.append(QString("<p><b>%1 &times; %2</b>: %3<br>").arg(group.rows.size()).arg(group.type.toHtmlEscaped(), group.message.toHtmlEscaped()));
+
+            for (const QString& frame : group.frames)
+                report.append(QString("&nbsp;&nbsp;&nbsp;&nbsp;at %1<br>").arg(frame.toHtmlEscaped()));
+
+            report.append(QString("<tt>|%1|</tt><br><b>Lines</b>: ").arg(TExceptionGroups::sparkline(group.timeline)));
+
+            for (size_t i = 0; i < group.rows.size() && i < 10; ++i)              // The first lines only; the dialog lists all
+                report.append(QString(i ? ", %1" : "%1").arg(group.rows[i] + 1));
+
+            report.append(group.rows.size() > 10 ? ", ...</p>" : "</p>");
+        }
+    }
+
+    ui->textEditResult->setText(report);
+
+    if (groups.groups().empty())
+        return;
+
+    if (mExceptionList)
+        mExceptionList->close();
+
+    TExceptionList *dialog = new TExceptionList(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setGroups(groups, [this](int row) { return rowTime(row); }, [this](int row) { return contextOf(row); });
+    connect(dialog, &TExceptionList::rowSelected, this, &MainWindow::selectSourceRow);
+    mExceptionList = dialog;
+    dialog->show();
+}
+
+/**
+ * @brief MainWindow::stackTrace
+ * Collects the first lines of the stack trace of an exception. These are
+ * the continuation lines of its record or, if the record has none, the
+ * records following it, as long as they look like a stack trace.
+ *
+ * @param groups    Knows the pattern of the lines of a stack trace.
+ * @param row       The row of the exception.
+ * @return The lines of the stack trace; at most groups.frames() lines.
+ */
+QStringList MainWindow::stackTrace(const TExceptionGroups& groups, int row)
+{
+    QStringList frames;
+    qsizetype record = recordOfRow(row);
+
+    if (!mIndex || record < 0)
+        return frames;
+
+    if (mIndex->lineCount(record) > 1)
+    {
+        const QStringList lines = mIndex->text(record).split('\n');
+
+        for (qsizetype i = 1; i < lines.size() && frames.size() < groups.frames(); ++i)
+        {
+            if (groups.isFrame(lines[i]))
+                frames.append(lines[i]);
+        }
+
+        return frames;
+    }
+
+    for (qsizetype next = record + 1; next < mIndex->size() && frames.size() < groups.frames(); ++next)
+    {
+        QString line = mIndex->firstLine(next);
+
+        if (!groups.isFrame(line))
+            break;
+
+        frames.append(line);
+    }
+
+    return frames;
+}
+
+/**
+ * @brief MainWindow::contextOf
+ * Reads the records around a row from the index. The number of records
+ * before and after it is set in the settings. The record of the row is
+ * marked with ">".
+ *
+ * @param row   The row in the middle.
+ * @return The records, one per line; continuation lines are indented.
+ */
+QString MainWindow::contextOf(int row)
+{
+    DECL_TRACER("MainWindow::contextOf(int row)");
+
+    qsizetype record = recordOfRow(row);
+
+    if (!mIndex || record < 0)
+        return QString();
+
+    qsizetype lines = TConfig::getContextLines();
+    qsizetype from = std::max<qsizetype>(0, record - lines);
+    qsizetype to = std::min(mIndex->size() - 1, record + lines);
+    QString context;
+
+    for (qsizetype r = from; r <= to; ++r)
+    {
+        context.append(r == record ? "> " : "  ");
+        context.append(mIndex->text(r).replace('\n', "\n  "));
+        context.append('\n');
+    }
+
+    return context;
+}
+
+/**
+ * @brief MainWindow::rowTime
+ * Returns the time of a row as text or, if the file has no times, its line
+ * number.
+ *
+ * @param row   The row of the model.
+ * @return The value shown for the row in a list.
+ */
+QVariant MainWindow::rowTime(int row)
+{
+    qsizetype record = recordOfRow(row);
+    qint64 usec = (record >= 0 && mIndex && mIndex->hasTimes()) ? mIndex->time(record) : TTimeParser::INVALID;
+
+    if (usec != TTimeParser::INVALID)
+        return TTimeParser::toString(usec);
+
+    return row + 1;
+}
+
+/**
+ * @brief MainWindow::on_actionMessage_patterns_triggered
+ * Clusters the messages of the last column into patterns and lists them
+ * with their counts. A double click on a pattern shows only its rows.
+ */
+void MainWindow::on_actionMessage_patterns_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionMessage_patterns_triggered()");
+
+    if (!mModel)
+    {
+        MSG_ERROR("No model found!");
+        return;
+    }
+
+    QProgressDialog progress(tr("Collecting messages ..."), tr("Cancel"), 0, mTotalLines, this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    qsizetype rows = mModel->rowCount();
+    int column = TConfig::getColumns() - 1;
+    TTemplateMiner *miner = new TTemplateMiner;
+
+    for (qsizetype line = 0; line < rows; ++line)
+    {
+        if ((line & 0x3ff) == 0)
+        {
+            progress.setValue(line);
+
+            if (progress.wasCanceled())
+            {
+                delete miner;
+                return;
+            }
+        }
+
+        QStandardItem *item = mModel->item(line, column);
+
+        if (!item)
+            continue;
+
+        QVariant collapsed = item->data(ROLE_COLLAPSED);                    // An expanded cell is mined as its first line
+        miner->addRow(static_cast<int>(line), collapsed.isValid() ? collapsed.toString() : item->text());
+    }
+
+    progress.setValue(mTotalLines);
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer timer;
+    timer.start();
+    miner->mine();                                                          // The message lengths are mined in parallel
+    MSG_DEBUG("Found " << miner->templates().size() << " patterns in " << timer.elapsed() << " ms");
+    QApplication::restoreOverrideCursor();
+
+    if (miner->templates().empty())
+    {
+        delete miner;
+        QMessageBox::information(this, APPNAME, tr("No messages found!"));
+        return;
+    }
+
+    if (mTemplateList)
+        mTemplateList->close();
+
+    if (mTemplateActive)                                                    // The filter refers to the old patterns
+    {
+        mTemplateRows.clear();
+        mTemplateActive = false;
+        applyRowFilter();
+    }
+
+    if (mMiner)
+        delete mMiner;
+
+    mMiner = miner;
+
+    TTemplateList *dialog = new TTemplateList(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setTemplates(*mMiner, [this](int row) { return rowTime(row); });
+    connect(dialog, &TTemplateList::templateSelected, this, &MainWindow::filterTemplate);
+    connect(dialog, &TTemplateList::filterCleared, this, [this]() {
+        mTemplateRows.clear();
+        mTemplateActive = false;
+        applyRowFilter();
+    });
+    mTemplateList = dialog;
+    dialog->show();
+}
+
+/**
+ * @brief MainWindow::filterTemplate
+ * Shows only the rows of a message pattern.
+ *
+ * @param id    The number of the pattern.
+ */
+void MainWindow::filterTemplate(int id)
+{
+    DECL_TRACER("MainWindow::filterTemplate(int id)");
+
+    if (!mMiner || id < 0 || id >= static_cast<int>(mMiner->templates().size()))
+        return;
+
+    mTemplateRows = mMiner->rows(id);
+    mTemplateActive = true;
+    mTemplateText = mMiner->templates()[static_cast<size_t>(id)].text;
+    applyRowFilter();
+
+    if (currentSourceRow() < 0 || !mTemplateRows.contains(static_cast<quint32>(currentSourceRow())))
+        selectSourceRow(mMiner->templates()[static_cast<size_t>(id)].firstRow);
+}
+
+/**
+ * @brief MainWindow::on_actionHot_methods_triggered
+ * Reconstructs the calls of every thread out of the block entry and exit
+ * lines and shows the time spent in each method. The lines are passed in
+ * order to TCallTree, which pairs them in a single pass.
+ */
+void MainWindow::on_actionHot_methods_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionHot_methods_triggered()");
+
+    if (!hasCallTimes())
+        return;
+
+    TCallTree tree(TConfig::getBlockEntry(), TConfig::getBlockExit());
+
+    if (!buildCallTree(tree, tr("Measuring methods ...")))
+        return;
+
+    if (tree.methods().empty())
+    {
+        QMessageBox::information(this, APPNAME, tr("No complete method calls found!<br>Check the block entry and exit in the <i>settings</i>."));
+        return;
+    }
+
+    THotMethods *dialog = new THotMethods(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setCallTree(tree);
+    connect(dialog, &THotMethods::rowSelected, this, &MainWindow::selectSourceRow);
+    dialog->show();
+}
+
+/**
+ * @brief MainWindow::on_actionExport_trace_triggered
+ * Exports the calls reconstructed from the block entry and exit lines as a
+ * trace for Perfetto or chrome://tracing. The calls are written while the
+ * rows are read, so no call is kept in memory after its exit.
+ */
+void MainWindow::on_actionExport_trace_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionExport_trace_triggered()");
+
+    if (!hasCallTimes())
+        return;
+
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Export trace"), TConfig::lastSavePath(), tr("Chrome trace (*.json);;All (*)"));
+
+    if (fileName.isEmpty())
+        return;
+
+    if (!fileName.contains('.'))
+        fileName.append(".json");
+
+    TTraceExport exporter(fileName);
+
+    if (!exporter.open(QFileInfo(mFile).fileName()))
+    {
+        QMessageBox::critical(this, APPNAME, exporter.errorString());
+        return;
+    }
+
+    TCallTree tree(TConfig::getBlockEntry(), TConfig::getBlockExit());
+    tree.setCallHandler([&exporter](const QString& method, const QString& thread, int row, qint64 start, qint64 duration) {
+        exporter.addCall(method, thread, row, start, duration);
+    }, false);
+
+    if (!buildCallTree(tree, tr("Exporting trace ...")))
+        return;
+
+    if (!exporter.close())
+    {
+        QMessageBox::critical(this, APPNAME, exporter.errorString());
+        return;
+    }
+
+    QMessageBox::information(this, APPNAME, tr("%1 calls of %2 threads were exported to %3.").arg(exporter.events()).arg(tree.threads()).arg(fileName));
+}
+
+/**
+ * @brief MainWindow::on_actionThread_timeline_triggered
+ * Shows the activity of every thread over time in a TTimeline window. The
+ * rows are counted per thread by the dictionary codes of the thread column
+ * and the time of their record in one pass.
+ */
+void MainWindow::on_actionThread_timeline_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionThread_timeline_triggered()");
+
+    if (!hasCallTimes())
+        return;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    if (!mColumnStore)
+        mColumnStore = new TColumnStore(mModel, ROLE_RECORD, ROLE_COLLAPSED);
+
+    const std::vector<qsizetype>& records = mColumnStore->records();
+    const std::vector<quint32> *threads = nullptr;
+    int colThread = TConfig::getColumnThreadID();
+    QStringList lanes;
+
+    if (colThread > 0 && colThread < TConfig::getColumns())
+    {
+        threads = &mColumnStore->ids(colThread - 1);
+        lanes = mColumnStore->dictionary(colThread - 1).mid(1);            // The first value is the empty one
+    }
+    else
+        lanes.append(tr("All rows"));
+
+    qint64 first = LLONG_MAX, last = LLONG_MIN;
+
+    for (qsizetype record : records)
+    {
+        qint64 usec = record >= 0 ? mIndex->time(record) : TTimeParser::INVALID;
+
+        if (usec != TTimeParser::INVALID)
+        {
+            first = std::min(first, usec);
+            last = std::max(last, usec);
+        }
+    }
+
+    if (first > last || lanes.isEmpty())
+    {
+        QApplication::restoreOverrideCursor();
+        QMessageBox::information(this, APPNAME, tr("There are no rows with a valid timestamp!"));
+        return;
+    }
+
+    TTimelineData *data = new TTimelineData(lanes, first, last);
+
+    for (size_t row = 0; row < records.size(); ++row)
+    {
+        if (records[row] < 0)
+            continue;
+
+        qint64 usec = mIndex->time(records[row]);
+        int lane = threads ? static_cast<int>((*threads)[row]) - 1 : 0;
+
+        if (usec != TTimeParser::INVALID && lane >= 0)
+            data->add(lane, usec, row < mLevels.size() && mLevels[row] == LEVEL_ERROR);
+    }
+
+    data->finish();
+
+    QList<QColor> colors;                                                   // The lanes get the colors of the thread column
+
+    for (int lane = 0; lane < data->lanes(); ++lane)
+    {
+        QColor color(Qt::darkBlue);
+
+        for (const TThreadSelect::THREAD_LIST_t& thread : mThreads)
+        {
+            if (thread.threadID == data->laneName(lane))
+            {
+                color = thread.threadColor;
+                break;
+            }
+        }
+
+        colors.append(color);
+    }
+
+    TTimeline *timeline = new TTimeline(this);
+    timeline->setWindowFlag(Qt::Window);
+    timeline->setAttribute(Qt::WA_DeleteOnClose);
+    timeline->setWindowTitle(tr("Thread timeline"));
+    timeline->setData(data, colors);
+    timeline->resize(1000, std::min(800, 60 + 24 * data->lanes()));
+    connect(timeline, &TTimeline::timeSelected, this, &MainWindow::selectTime);
+    QApplication::restoreOverrideCursor();
+    timeline->show();
+}
+
+/**
+ * @brief MainWindow::hasCallTimes
+ * Tests whether calls can be timed. Shows a message if not.
+ *
+ * @return TRUE if a file is loaded and it has a time column.
+ */
+bool MainWindow::hasCallTimes()
+{
+    DECL_TRACER("MainWindow::hasCallTimes()");
+
+    if (!mModel)
+    {
+        MSG_ERROR("No model found!");
+        return false;
+    }
+
+    if (!mIndex || !mIndex->hasTimes())
+    {
+        QMessageBox::information(this, APPNAME, tr("There is no time column!<br>Please set the column of the timestamp in the <i>settings</i> and reload the file."));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief MainWindow::buildCallTree
+ * Passes all rows with a time in order to a call tree and finishes it.
+ *
+ * @param tree      The call tree.
+ * @param title     The text of the progress dialog.
+ * @return FALSE if the user canceled.
+ */
+bool MainWindow::buildCallTree(TCallTree& tree, const QString& title)
+{
+    DECL_TRACER("MainWindow::buildCallTree(TCallTree& tree, const QString& title)");
+
+    QProgressDialog progress(title, tr("Cancel"), 0, mTotalLines, this);
+    progress.setWindowModality(Qt::WindowModal);
+
+    qsizetype rows = mModel->rowCount();
+    int column = TConfig::getColumns() - 1;
+    int colThread = TConfig::getColumnThreadID();
+
+    if (colThread <= 0 || colThread >= TConfig::getColumns())              // The thread must not be the last column
+        colThread = 0;
+
+    for (qsizetype line = 0; line < rows; ++line)
+    {
+        if ((line & 0x3ff) == 0)
+        {
+            progress.setValue(line);
+
+            if (progress.wasCanceled())
+                return false;
+        }
+
+        QStandardItem *item = mModel->item(line, column);
+        qsizetype record = recordOfRow(static_cast<int>(line));
+
+        if (!item || record < 0 || record >= mIndex->size())
+            continue;
+
+        qint64 usec = mIndex->time(record);
+
+        if (usec == TTimeParser::INVALID)                                   // A line without time can't be measured
+            continue;
+
+        QStandardItem *thread = colThread > 0 ? mModel->item(line, colThread - 1) : nullptr;
+        tree.addRow(static_cast<int>(line), item->text(), thread ? thread->text().trimmed() : QString(), usec);
+    }
+
+    tree.finish();
+    progress.setValue(mTotalLines);
+    return true;
+}
+
+void MainWindow::on_actionSearch_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionSearch_triggered()");
+
+    bool ok;
+
+    mMenuColumn = -1;
+    mLastSearchLine = 0;
+
+    QString text = QInputDialog::getText(this, tr("Search"), tr("Enter string to search for or /expression/ for a regular expression"), QLineEdit::Normal, mLastSearchText, &ok);
+
+    if (!ok || text.isEmpty())
+        return;
+
+    mLastSearchText = text;
+    mLastSearchLine = search(text);
+}
+
+/**
+ * @brief MainWindow::on_actionSearch_bar_triggered
+ * Shows the search bar. The file is searched while typing.
+ */
+void MainWindow::on_actionSearch_bar_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionSearch_bar_triggered()");
+
+    ui->widgetSearchBar->show();
+    ui->lineEditSearch->setFocus();
+    ui->lineEditSearch->selectAll();
+}
+
+/**
+ * @brief MainWindow::on_actionFilter_query_triggered
+ * Asks for a filter query and shows only the rows matching it. An empty
+ * query shows all rows again. The columns are encoded the first time they
+ * are filtered and kept until the file is loaded again.
+ */
+void MainWindow::on_actionFilter_query_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionFilter_query_triggered()");
+
+    if (!mModel)
+        return;
+
+    bool ok;
+    QString query = QInputDialog::getText(this, tr("Filter by query"),
+                                          tr("Enter a query like: level in (ERR,WRN) and thread = 7f3a and msg ~ 'timeout' and time > 14:00<br>An empty query shows all rows."),
+                                          QLineEdit::Normal, mFilterQuery, &ok).trimmed();
+
+    if (!ok)
+        return;
+
+    mFilterQuery = query;
+
+    if (query.isEmpty())
+    {
+        mQueryRows.clear();
+        mQueryActive = false;
+        applyRowFilter();
+        return;
+    }
+
+    if (!mColumnStore)
+        mColumnStore = new TColumnStore(mModel, ROLE_RECORD, ROLE_COLLAPSED);
+
+    TFilterQuery filter(mColumnStore, mIndex);
+
+    if (!filter.parse(query))
+    {
+        QMessageBox::warning(this, APPNAME, tr("The filter query is not valid:<br>%1").arg(filter.errorString().toHtmlEscaped()));
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer timer;
+    timer.start();
+    filter.evaluate(mQueryRows);
+    mQueryActive = true;
+    MSG_DEBUG("Filter \"" << query.toStdString() << "\" matches " << mQueryRows.cardinality() << " rows in " << timer.elapsed() << " ms");
+    applyRowFilter();
+    QApplication::restoreOverrideCursor();
+}
+
+/**
+ * @brief MainWindow::on_actionJump_to_partner_triggered
+ * Selects the exit of the block entry in the current row or the entry of
+ * the block exit. The partner is looked up in the block index.
+ */
+void MainWindow::on_actionJump_to_partner_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionJump_to_partner_triggered()");
+
+    int row = currentSourceRow();
+    int partner = mBlocks ? mBlocks->partner(row) : -1;
+
+    if (partner < 0)
+    {
+        ui->statusbar->showMessage(tr("The current row is no block entry or exit with a partner"), 5000);
+        return;
+    }
+
+    if (mFoldedBlocks.contains(static_cast<quint32>(row)))             // The exit of a folded block is hidden
+        toggleFold(row);
+
+    if (mProxy->isFiltered() && !mProxy->acceptsRow(partner))
+    {
+        ui->statusbar->showMessage(tr("The partner in line %1 is hidden by the filter").arg(partner + 1), 5000);
+        return;
+    }
+
+    selectSourceRow(partner);
+}
+
+/**
+ * @brief MainWindow::on_actionFold_block_triggered
+ * Folds or unfolds the block of the current row. The row may be the entry
+ * or the exit of the block.
+ */
+void MainWindow::on_actionFold_block_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionFold_block_triggered()");
+
+    int row = currentSourceRow();
+    int partner = mBlocks ? mBlocks->partner(row) : -1;
+
+    if (partner < 0)
+    {
+        ui->statusbar->showMessage(tr("The current row is no block entry or exit with a partner"), 5000);
+        return;
+    }
+
+    toggleFold(std::min(row, partner));
+}
+
+void MainWindow::on_actionUnfold_all_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionUnfold_all_triggered()");
+
+    if (mFoldedBlocks.isEmpty())
+        return;
+
+    mFoldedBlocks.forEach([this](quint32 entry) {
+        QStandardItem *item = mModel ? mModel->item(static_cast<int>(entry), 0) : nullptr;
+
+        if (item)
+        {
+            item->setData(QVariant(), ROLE_FOLDED);
+            updateMarker(item);                                         // Shows the marker of a multi-line record again
+        }
+    });
+
+    mFoldedBlocks.clear();
+    mFoldedRows.clear();
+    applyRowFilter();
+}
+
+/**
+ * @brief MainWindow::toggleFold
+ * Folds a block by hiding the rows from the row after its entry to its
+ * exit, or unfolds it. If there is a thread column, only the rows of the
+ * thread of the block are hidden.
+ *
+ * @param entry The row of the block entry.
+ */
+void MainWindow::toggleFold(int entry)
+{
+    DECL_TRACER("MainWindow::toggleFold(int entry)");
+
+    QStandardItem *item = mModel ? mModel->item(entry, 0) : nullptr;
+
+    if (!item || !mBlocks->isEntry(entry))
+        return;
+
+    if (mFoldedBlocks.contains(static_cast<quint32>(entry)))
+    {
+        mFoldedBlocks.andNot(TRowBitmap::range(static_cast<quint32>(entry), static_cast<quint32>(entry) + 1));
+        item->setData(QVariant(), ROLE_FOLDED);
+    }
+    else
+    {
+        mFoldedBlocks.add(static_cast<quint32>(entry));
+        item->setData(true, ROLE_FOLDED);
+    }
+
+    updateMarker(item);
+
+    mFoldedRows = foldedRows();
+    applyRowFilter();
+    selectSourceRow(entry);
+}
+
+/**
+ * @brief MainWindow::updateMarker
+ * Sets the icon and the tooltip of a cell from its state. The entry of a
+ * folded block is marked in the first column and a record with
+ * continuation lines in the last one. If both are the same cell, the fold
+ * is shown.
+ *
+ * @param item  The cell.
+ */
+void MainWindow::updateMarker(QStandardItem *item)
+{
+    int lines = item->data(ROLE_LINES).toInt();
+
+    if (item->data(ROLE_FOLDED).toBool())
+    {
+        item->setData(mIconFolded, Qt::DecorationRole);
+        item->setToolTip(tr("Folded block up to line %1; Ctrl+B or double click unfolds it").arg(mBlocks ? mBlocks->partner(item->row()) + 1 : 0));
+    }
+    else if (lines > 1 && item->data(ROLE_COLLAPSED).isNull())
+    {
+        item->setData(mIconCollapsed, Qt::DecorationRole);
+        item->setToolTip(tr("%1 lines; double click to expand").arg(lines));
+    }
+    else if (lines > 1)
+    {
+        item->setData(mIconExpanded, Qt::DecorationRole);
+        item->setToolTip(tr("%1 lines; double click to collapse").arg(lines));
+    }
+    else
+    {
+        item->setData(QVariant(), Qt::DecorationRole);
+        item->setToolTip(QString());
+    }
+}
+
+/**
+ * @brief MainWindow::foldedRows
+ * Collects the rows hidden by the folded blocks. Nested folds are merged.
+ *
+ * @return The hidden rows.
+ */
+TRowBitmap MainWindow::foldedRows()
+{
+    DECL_TRACER("MainWindow::foldedRows()");
+
+    if (mFoldedBlocks.isEmpty())
+        return TRowBitmap();
+
+    const std::vector<quint32> *threads = nullptr;
+    int colThread = TConfig::getColumnThreadID();
+
+    if (colThread > 0 && colThread < TConfig::getColumns())                // Hide only the rows of the thread of a block
+    {
+        if (!mColumnStore)
+            mColumnStore = new TColumnStore(mModel, ROLE_RECORD, ROLE_COLLAPSED);
+
+        threads = &mColumnStore->ids(colThread - 1);
+    }
+
+    std::vector<quint64> words;
+
+    mFoldedBlocks.forEach([this, threads, &words](quint32 entry) {
+        int exit = mBlocks->partner(static_cast<int>(entry));
+
+        if (exit <= static_cast<int>(entry))
+            return;
+
+        if (words.size() <= static_cast<size_t>(exit >> 6))
+            words.resize(static_cast<size_t>(exit >> 6) + 1, 0);
+
+        for (int row = static_cast<int>(entry) + 1; row <= exit; ++row)
+        {
+            if (!threads || (*threads)[row] == (*threads)[entry])
+                words[row >> 6] |= static_cast<quint64>(1) << (row & 63);
+        }
+    });
+
+    return TRowBitmap::fromWords(words);
+}
+
+/**
+ * @brief MainWindow::on_actionTime_histogram_toggled
+ * Shows or hides the histogram above the table. The rows are counted the
+ * first time it is shown after loading a file. Hiding it removes the time
+ * filter.
+ *
+ * @param checked   TRUE = show the histogram.
+ */
+void MainWindow::on_actionTime_histogram_toggled(bool checked)
+{
+    DECL_TRACER("MainWindow::on_actionTime_histogram_toggled(bool checked)");
+
+    if (!checked)
+    {
+        mHistogram->hide();
+
+        if (mTimeActive)
+        {
+            mTimeRows.clear();
+            mTimeActive = false;
+            mHistogram->clearSelection();
+            applyRowFilter();
+        }
+
+        return;
+    }
+
+    if (!mHistogram->hasData())
+        updateHistogram();
+
+    mHistogram->show();
+}
+
+/**
+ * @brief MainWindow::updateHistogram
+ * Counts the rows per time bucket and level for the histogram. The rows
+ * are counted in parallel over the time index and the level of every row.
+ * The errors are stacked at the bottom, so spikes of errors stand out.
+ */
+void MainWindow::updateHistogram()
+{
+    DECL_TRACER("MainWindow::updateHistogram()");
+
+    if (!mModel || !mIndex || !mIndex->hasTimes() || mModel->rowCount() == 0)
+    {
+        mHistogram->setData(nullptr, QStringList(), QList<QColor>());
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    if (!mColumnStore)
+        mColumnStore = new TColumnStore(mModel, ROLE_RECORD, ROLE_COLLAPSED);
+
+    qint64 first = LLONG_MAX, last = LLONG_MIN;
+
+    for (qsizetype record = 0; record < mIndex->size(); ++record)
+    {
+        qint64 usec = mIndex->time(record);
+
+        if (usec != TTimeParser::INVALID)
+        {
+            first = std::min(first, usec);
+            last = std::max(last, usec);
+        }
+    }
+
+    if (first > last)
+    {
+        mHistogram->setData(nullptr, QStringList(), QList<QColor>());
+        QApplication::restoreOverrideCursor();
+        return;
+    }
+
+    // The series from the bottom to the top of a bar
+    const LEVEL_t order[] = { LEVEL_ERROR, LEVEL_WARNING, LEVEL_INFO, LEVEL_DEBUG, LEVEL_TRACE, LEVEL_OTHER };
+    const QStringList names = { tr("Errors"), tr("Warnings"), tr("Infos"), tr("Debugs"), tr("Traces"), tr("Others") };
+    const QList<QColor> colors = { TConfig::colorError().darker(130), TConfig::colorWarning().darker(130), TConfig::colorInfo().darker(130),
+                                   TConfig::colorDebug().darker(130), TConfig::colorTrace().darker(130), QColor(Qt::lightGray) };
+    vector<quint8> series(LEVEL_NONE + 1, 0xff);                            // The series of every level
+
+    for (size_t s = 0; s < sizeof(order) / sizeof(order[0]); ++s)
+        series[order[s]] = static_cast<quint8>(s);
+
+    QElapsedTimer timer;
+    timer.start();
+    THistogramData *data = new THistogramData(static_cast<int>(names.size()), first, last);
+    data->build(mColumnStore->records(), mLevels, series, mIndex);
+    mHistogram->setData(data, names, colors);
+    MSG_DEBUG("Histogram built in " << timer.elapsed() << " ms");
+    QApplication::restoreOverrideCursor();
+}
+
+/**
+ * @brief MainWindow::filterTime
+ * Shows only the rows with a time in a range. Rows without a valid time
+ * are hidden as well.
+ *
+ * @param from  The start of the range.
+ * @param to    The end of the range.
+ */
+void MainWindow::filterTime(qint64 from, qint64 to)
+{
+    DECL_TRACER("MainWindow::filterTime(qint64 from, qint64 to)");
+
+    if (!mModel || !mColumnStore)
+        return;
+
+    const vector<qsizetype>& records = mColumnStore->records();
+    size_t rows = records.size();
+    vector<quint64> words((rows + 63) / 64, 0);
+
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+        size_t first = w * 64;
+        size_t count = std::min(static_cast<size_t>(64), rows - first);
+        quint64 bits = 0;
+
+        for (size_t b = 0; b < count; ++b)
+        {
+            qsizetype record = records[first + b];
+            qint64 usec = record >= 0 ? mIndex->time(record) : TTimeParser::INVALID;
+
+            if (usec != TTimeParser::INVALID && usec >= from && usec <= to)
+                bits |= static_cast<quint64>(1) << b;
+        }
+
+        words[w] = bits;
+    }
+
+    mTimeRows = TRowBitmap::fromWords(words);
+    mTimeActive = true;
+    mTimeFrom = from;
+    mTimeTo = to;
+    applyRowFilter();
+}
+
+void MainWindow::on_actionMinimap_toggled(bool checked)
+{
+    DECL_TRACER("MainWindow::on_actionMinimap_toggled(bool checked)");
+
+    mMinimap->setVisible(checked);
+}
+
+/**
+ * @brief MainWindow::updateMinimap
+ * Marks the errors, warnings and search hits of the rows shown by the
+ * table in the minimap. If the rows are filtered, the shown rows are
+ * numbered in the order of the filter.
+ */
+void MainWindow::updateMinimap()
+{
+    DECL_TRACER("MainWindow::updateMinimap()");
+
+    if (!mModel)
+    {
+        mMinimap->reset(0);
+        mMinimap->refresh();
+        return;
+    }
+
+    auto markLevel = [this](int viewRow, size_t row) {
+        if (row >= mLevels.size())
+            return;
+
+        if (mLevels[row] == LEVEL_ERROR)
+            mMinimap->add(viewRow, TMinimap::MARK_ERROR);
+        else if (mLevels[row] == LEVEL_WARNING)
+            mMinimap->add(viewRow, TMinimap::MARK_WARNING);
+    };
+
+    if (mProxy->isFiltered())
+    {
+        const TRowBitmap& rows = mProxy->rows();
+        int viewRow = 0;
+        mMinimap->reset(static_cast<int>(rows.cardinality()));
+        rows.forEach([&viewRow, &markLevel](quint32 row) { markLevel(viewRow++, row); });
+    }
+    else
+    {
+        mMinimap->reset(mModel->rowCount());
+
+        for (size_t row = 0; row < mLevels.size(); ++row)
+            markLevel(static_cast<int>(row), row);
+    }
+
+    mSearchHits.forEach([this](quint32 row) { markHit(static_cast<int>(row)); });
+    mMinimap->refresh();
+}
+
+/**
+ * @brief MainWindow::markHit
+ * Marks a search hit in the minimap.
+ *
+ * @param row   The row of the model.
+ */
+void MainWindow::markHit(int row)
+{
+    if (!mProxy->isFiltered())
+        mMinimap->add(row, TMinimap::MARK_HIT);
+    else if (mProxy->acceptsRow(row))
+        mMinimap->add(static_cast<int>(mProxy->rows().rank(static_cast<quint32>(row))), TMinimap::MARK_HIT);
+}
+
+/**
+ * @brief MainWindow::applyRowFilter
+ * Shows the rows matching the filter query and the levels not hidden. If
+ * nothing is filtered, all rows are shown.
+ */
+void MainWindow::applyRowFilter()
+{
+    DECL_TRACER("MainWindow::applyRowFilter()");
+
+    if (!mModel)
+        return;
+
+    int current = currentSourceRow();
+    bool byLevel = (mLevelMask & LEVEL_ALL) != LEVEL_ALL;
+    bool byFold = !mFoldedRows.isEmpty();
+
+    if (!mQueryActive && !byLevel && !byFold && !mTimeActive && !mTemplateActive)
+    {
+        mProxy->clearRows();
+
+        if (mLbFilter)
+        {
+            ui->statusbar->removeWidget(mLbFilter);
+            mLbFilter = nullptr;
+        }
+    }
+    else
+    {
+        TRowBitmap rows = mQueryActive ? mQueryRows : TRowBitmap::range(0, static_cast<quint32>(mModel->rowCount()));
+
+        if (byLevel)
+            rows &= levelRows();
+
+        if (mTimeActive)
+            rows &= mTimeRows;
+
+        if (mTemplateActive)
+            rows &= mTemplateRows;
+
+        if (byFold)
+            rows.andNot(mFoldedRows);
+
+        qint64 count = rows.cardinality();
+        mProxy->setRows(std::move(rows));
+
+        if (!mLbFilter)
+        {
+            mLbFilter = new QLabel;
+            mLbFilter->setFrameStyle(QFrame::Panel | QFrame::Sunken);
+            ui->statusbar->addWidget(mLbFilter);
+        }
+
+        mLbFilter->setText(tr("Filter: %1 of %2 rows").arg(count).arg(mTotalLines));
+
+        if (mQueryActive)
+            mLbFilter->setToolTip(mFilterQuery);
+        else if (mTemplateActive)
+            mLbFilter->setToolTip(tr("Pattern: %1").arg(mTemplateText.toHtmlEscaped()));
+        else if (byLevel)
+            mLbFilter->setToolTip(tr("Some levels are hidden"));
+        else if (mTimeActive)
+            mLbFilter->setToolTip(tr("Time from %1 to %2").arg(TTimeParser::toString(mTimeFrom)).arg(TTimeParser::toString(mTimeTo)));
+        else
+            mLbFilter->setToolTip(tr("Some blocks are folded"));
+    }
+
+    updateMinimap();                                                        // The rows of the table changed
+
+    if (current >= 0)
+        selectSourceRow(current);
+}
+
+/**
+ * @brief MainWindow::levelRows
+ * Collects the rows of the levels not hidden. Only the level byte of
+ * every row is tested, 64 rows at a time.
+ *
+ * @return The rows to show.
+ */
+TRowBitmap MainWindow::levelRows()
+{
+    DECL_TRACER("MainWindow::levelRows()");
+
+    size_t rows = mLevels.size();
+    vector<quint64> words((rows + 63) / 64, 0);
+    const quint8 *level = mLevels.data();
+
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+        size_t first = w * 64;
+        size_t count = std::min(static_cast<size_t>(64), rows - first);
+        quint64 bits = 0;
+
+        for (size_t b = 0; b < count; ++b)
+            bits |= static_cast<quint64>((mLevelMask >> level[first + b]) & 1) << b;
+
+        words[w] = bits;
+    }
+
+    return TRowBitmap::fromWords(words);
+}
+
+/**
+ * @brief MainWindow::setupLevelLabel
+ * Makes a label of the statusbar showing the count of a level clickable.
+ * A click hides or shows the rows of the level.
+ *
+ * @param label The label.
+ * @param level The level counted by the label.
+ */
+void MainWindow::setupLevelLabel(QLabel *label, LEVEL_t level)
+{
+    DECL_TRACER("MainWindow::setupLevelLabel(QLabel *label, LEVEL_t level)");
+
+    label->setProperty("level", static_cast<int>(level));
+    label->setCursor(Qt::PointingHandCursor);
+    label->setToolTip(tr("Click to hide or show these rows; Ctrl+click to show only these rows"));
+    label->installEventFilter(this);
+}
+
+/**
+ * @brief MainWindow::toggleLevel
+ * Hides or shows the rows of a level. The labels of the hidden levels are
+ * crossed out.
+ *
+ * @param level The level.
+ * @param only  TRUE = show only the rows of \p level or all rows, if only
+ * this level is already shown.
+ */
+void MainWindow::toggleLevel(LEVEL_t level, bool only)
+{
+    DECL_TRACER("MainWindow::toggleLevel(LEVEL_t level, bool only)");
+
+    quint8 bit = static_cast<quint8>(1 << level);
+
+    if (only)
+        mLevelMask = (mLevelMask == bit) ? LEVEL_ALL : bit;
+    else
+        mLevelMask ^= bit;
+
+    QLabel *labels[] = { mLbOthers, mLbTraces, mLbInfos, mLbWarnings, mLbErrors, mLbDebugs };   // In the order of LEVEL_t
+
+    for (int lvl = LEVEL_OTHER; lvl <= LEVEL_DEBUG; ++lvl)
+    {
+        if (!labels[lvl])
+            continue;
+
+        QFont font = labels[lvl]->font();
+        font.setStrikeOut(!(mLevelMask & (1 << lvl)));
+        labels[lvl]->setFont(font);
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    applyRowFilter();
+    QApplication::restoreOverrideCursor();
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::MouseButtonRelease)
+    {
+        QVariant level = watched->property("level");
+        QMouseEvent *mouse = static_cast<QMouseEvent *>(event);
+
+        if (level.isValid() && mouse->button() == Qt::LeftButton)
+        {
+            toggleLevel(static_cast<LEVEL_t>(level.toInt()), mouse->modifiers() & Qt::ControlModifier);
+            return true;
+        }
+    }
+
+    return QMainWindow::eventFilter(watched, event);
+}
+
+/**
+ * @brief MainWindow::on_actionGo_to_time_triggered
+ * Asks for a timestamp and selects the first row at or after it. The
+ * record is found by a binary search on the time index. A time without a
+ * date refers to the day of the selected row.
+ */
+void MainWindow::on_actionGo_to_time_triggered()
+{
+    DECL_TRACER("MainWindow::on_actionGo_to_time_triggered()");
+
+    if (!mIndex || !mIndex->hasTimes())
+    {
+        QMessageBox::information(this, APPNAME, tr("There is no time column!<br>Please set the column of the timestamp in the <i>settings</i> and reload the file."));
+        return;
+    }
+
+    // The time of the selected row is the reference for a time without date
+    qint64 reference = TTimeParser::INVALID;
+    qsizetype current = recordOfRow(std::max(0, currentSourceRow()));
+
+    for (qsizetype rec = std::max(static_cast<qsizetype>(0), current); rec < mIndex->size() && reference == TTimeParser::INVALID; ++rec)
+        reference = mIndex->time(rec);
+
+    bool ok;
+    QString text = QInputDialog::getText(this, tr("Go to time"), tr("Enter a timestamp or a time of the day (hh:mm:ss)"),
+                                         QLineEdit::Normal, TTimeParser::toString(reference), &ok).trimmed();
+
+    if (!ok || text.isEmpty())
+        return;
+
+    qint64 usec = parseTime(text, reference);
+
+    if (usec == TTimeParser::INVALID)
+    {
+        QMessageBox::warning(this, APPNAME, tr("<i>%1</i> is not a valid timestamp!").arg(text));
+        return;
+    }
+
+    selectTime(usec);
+}
+
+/**
+ * @brief MainWindow::selectTime
+ * Selects the first row at or after a point in time.
+ *
+ * @param usec  The time in microseconds.
+ */
+void MainWindow::selectTime(qint64 usec)
+{
+    DECL_TRACER("MainWindow::selectTime(qint64 usec)");
+
+    qsizetype record = mIndex->findTime(usec);
+
+    if (record < 0)
+    {
+        QMessageBox::information(this, APPNAME, tr("There is no record at or after %1!").arg(TTimeParser::toString(usec)));
+        return;
+    }
+
+    int row = rowOfRecord(record);
+
+    if (row < 0)
+        return;
+
+    selectSourceRow(row);
+}
+
+/**
+ * @brief MainWindow::parseTime
+ * Converts a timestamp entered by the user. The configured layout, ISO 8601
+ * and epoch values are accepted. A time without a date refers to the day
+ * of \p reference.
+ *
+ * @param text      The entered timestamp.
+ * @param reference A timestamp defining the day of a time without date.
+ * @return The time in microseconds or TTimeParser::INVALID.
+ */
+qint64 MainWindow::parseTime(const QString& text, qint64 reference)
+{
+    DECL_TRACER("MainWindow::parseTime(const QString& text, qint64 reference)");
+
+    qint64 usec = TTimeParser::INVALID;
+    // The configured layout, ISO 8601 and at last only a time of the day
+    const QString layouts[] = { TConfig::getTimeLayout(), QString(), "%H:%M:%S.%f", "%H:%M:%S", "%H:%M" };
+    const int timeOnly = 2;
+    int layout = 0;
+
+    for (; layout < 5 && usec == TTimeParser::INVALID; ++layout)
+    {
+        if (layout == 0 && layouts[0].isEmpty())
+            continue;
+
+        TTimeParser parser(layouts[layout]);
+        usec = parser.parse(text.trimmed());
+    }
+
+    const qint64 day = 86400LL * 1000000LL;
+
+    if (usec != TTimeParser::INVALID && layout - 1 >= timeOnly && reference != TTimeParser::INVALID)   // Only a time of the day?
+    {
+        qint64 midnight = reference - (((reference % day) + day) % day);
+        usec += midnight;
+    }
+
+    return usec;
+}
 
-    if (!model)
+/**
+ * @brief MainWindow::selectTimeWindow
+ * Asks for the time window to load, unless it is already known (reload),
+ * and limits the index to the lines of the window. The lines are located
+ * by a binary search on the mapped file, so only the pages around the
+ * probed offsets and the window itself are read.
+ *
+ * @return If the user canceled or the window is empty, FALSE is returned.
+ */
+bool MainWindow::selectTimeWindow()
+{
+    DECL_TRACER("MainWindow::selectTimeWindow()");
+
+    int columns = TConfig::getColumns();
+    int timeColumn = TConfig::getTimeColumn() - 1;
+
+    if (timeColumn < 0)
     {
-        MSG_ERROR("No model found!");
-        return;
+        QMessageBox::information(this, APPNAME, tr("There is no time column!<br>Please set the column of the timestamp in the <i>settings</i> first."));
+        return false;
     }
 
-    qsizetype rows = model->rowCount();
-    int column = TConfig::getColumns() - 1;
-    QList<int> exceptions;
+    TConfig::FORMAT_t format = TConfig::getFormat();
+    QString delimiter = TConfig::getDelimeter();
+    TLineParser parser(mIndex, columns);
+    TTimeParser timeParser(TConfig::getTimeLayout());
+    bool parsed = true;
 
-    for (qsizetype line = 0; line < rows; ++line)
+    if (format == TConfig::FORMAT_LOGFMT || format == TConfig::FORMAT_SYSLOG)
+        parser.setFormat(format, TConfig::headers());
+    else if (format == TConfig::FORMAT_REGEX)
+        parsed = parser.setRegex(TConfig::getLineRegex(), TConfig::headers());
+    else
+        parsed = false;
+
+    // Finds the timestamp of a line the same way the lines are parsed later
+    TLogIndex::TIMEOF_t timeOf = [&](const char *line, qint64 len) -> qint64
     {
-        progress.setValue(line);
+        QStringList parts;
 
-        if (progress.wasCanceled())
+        if (parsed)
+            parts = parser.parseLine(line, len);
+        else
         {
-            canceled = true;
-            break;
+            QString qLine = QString::fromUtf8(line, len);
+
+            if (qLine.contains(delimiter))
+                parts = split(qLine, delimiter, columns - 1);
         }
 
-        QStandardItem *item = model->item(line, column);
+        return timeColumn < parts.size() ? timeParser.parse(parts[timeColumn]) : TTimeParser::INVALID;
+    };
 
-        if (item && item->text().contains("exception", Qt::CaseInsensitive))
-            exceptions.append(line+1);
-    }
+    if (mWindowStart == LLONG_MIN)                                                      // Not known yet?
+    {
+        qint64 first = mIndex->firstTime(timeOf);
+        qint64 last = mIndex->lastTime(timeOf);
 
-    // Report the result
-    ui->textEditResult->clear();
+        if (first == TTimeParser::INVALID || last == TTimeParser::INVALID)
+        {
+            QMessageBox::warning(this, APPNAME, tr("No timestamps were found in column %1!<br>Please check the time column and the timestamp layout in the <i>settings</i>.").arg(timeColumn + 1));
+            return false;
+        }
 
-    if (canceled)
-        return;
+        bool ok;
+        QString text = QInputDialog::getText(this, tr("Open time window"), tr("The file covers %1 to %2.<br>Start of the window:").arg(TTimeParser::toString(first), TTimeParser::toString(last)),
+                                             QLineEdit::Normal, TTimeParser::toString(first), &ok);
 
-    QString report;
-    report.append("<h2>Exceptions found</h2><p>");
+        if (!ok)
+            return false;
 
-    if (exceptions.isEmpty())
-        report.append("No exceptions found!</p>");
-    else
-    {
-        QList<int>::iterator iter;
+        qint64 start = parseTime(text, first);
 
-        for (iter = exceptions.begin(); iter != exceptions.end(); ++iter)
-            report.append(QString("<b>Exception on line</b>: %1<br>").arg(*iter));
+        if (start == TTimeParser::INVALID)
+        {
+            QMessageBox::warning(this, APPNAME, tr("<i>%1</i> is not a valid timestamp!").arg(text));
+            return false;
+        }
 
-        report.append("</p>");
-    }
+        text = QInputDialog::getText(this, tr("Open time window"), tr("End of the window:"), QLineEdit::Normal, TTimeParser::toString(last), &ok);
 
-    ui->textEditResult->setText(report);
-}
+        if (!ok)
+            return false;
 
-void MainWindow::on_actionSearch_triggered()
-{
-    DECL_TRACER("MainWindow::on_actionSearch_triggered()");
+        qint64 end = parseTime(text, start);
 
-    bool ok;
+        if (end == TTimeParser::INVALID || end < start)
+        {
+            QMessageBox::warning(this, APPNAME, tr("<i>%1</i> is not a valid end of the window!").arg(text));
+            return false;
+        }
 
-    mMenuColumn = -1;
-    mLastSearchLine = 0;
+        mWindowStart = start;
+        mWindowEnd = end;
+    }
 
-    QString text = QInputDialog::getText(this, tr("Search"), tr("Enter string to search for"), QLineEdit::Normal, mLastSearchText, &ok);
+    qint64 from = mIndex->findOffset(mWindowStart, timeOf);
+    qint64 to = mIndex->findOffset(mWindowEnd + 1, timeOf);                             // The first line after the window
 
-    if (!ok || text.isEmpty())
-        return;
+    if (!mIndex->setWindow(from, to))
+    {
+        QMessageBox::information(this, APPNAME, tr("There are no records between %1 and %2!").arg(TTimeParser::toString(mWindowStart), TTimeParser::toString(mWindowEnd)));
+        return false;
+    }
 
-    mLastSearchText = text;
-    mLastSearchLine = search(text);
+    MSG_INFO("Loading " << (to - from) << " of " << mIndex->fileSize() << " bytes for the time window.");
+    return true;
 }
 
 void MainWindow::on_actionFilter_thread_triggered(bool checked)
@@ -1145,7 +2829,7 @@ void MainWindow::on_actionReload_triggered()
 
     if (!mFile.isEmpty())
     {
-        qsizetype lines = countLines(mTempFile.isEmpty() ? mFile : mTempFile);
+        qsizetype lines = mTimeWindow ? 0 : countLines(mTempFile.isEmpty() ? mFile : mTempFile);
         parseFile(lines);
     }
 }
@@ -1213,6 +2897,59 @@ void MainWindow::pressed(const QModelIndex &index)
     mPopupMenu->popup(pt);
 }
 
+/**
+ * @brief MainWindow::doubleClicked
+ * Expands or collapses a record with continuation lines. The continuation
+ * lines are not part of the model. They are read from the index when the
+ * record is expanded. A double click on the entry of a folded block
+ * unfolds it.
+ *
+ * @param index The index of the cell double clicked.
+ */
+void MainWindow::doubleClicked(const QModelIndex &index)
+{
+    DECL_TRACER("MainWindow::doubleClicked(const QModelIndex &index)");
+
+    if (!mModel || !index.isValid())
+        return;
+
+    int row = mProxy->mapToSource(index).row();                         // The row of the model
+    QStandardItem *first = mModel->item(row, 0);
+    QStandardItem *item = mModel->item(row, TConfig::getColumns() - 1);
+
+    if (first && first->data(ROLE_FOLDED).toBool())
+    {
+        toggleFold(row);
+        return;
+    }
+
+    if (!first || !item || item->data(ROLE_LINES).toInt() <= 1)         // Only records with continuation lines can be expanded
+        return;
+
+    QVariant collapsed = item->data(ROLE_COLLAPSED);
+
+    if (collapsed.isNull())                                             // Is the record collapsed?
+    {                                                                   // Yes, then append the continuation lines
+        QString txt = mIndex->text(first->data(ROLE_RECORD).toLongLong());
+        qsizetype pos = txt.indexOf('\n');
+
+        if (pos < 0)
+            return;
+
+        item->setData(item->text(), ROLE_COLLAPSED);
+        item->setText(item->text() + txt.mid(pos));
+    }
+    else
+    {
+        item->setText(collapsed.toString());
+        item->setData(QVariant(), ROLE_COLLAPSED);
+    }
+
+    updateMarker(item);
+
+    ui->tableViewLog->resizeRowToContents(index.row());
+}
+
 void MainWindow::onPopupMenuCopyTriggered(bool checked)
 {
     DECL_TRACER("MainWindow::onPopupMenuCopyTriggered(bool checked)");
@@ -1254,11 +2991,11 @@ void MainWindow::onPopupMenuSearchTriggered(bool checked)
         return;
 
     mMenuColumn = mModelIndex.column();
-    mLastSearchLine = mModelIndex.row() + 1;
+    mLastSearchLine = mProxy->mapToSource(mModelIndex).row() + 1;
     mLastSearchText = mModelMenu->data(mModelIndex).toString();
     bool ok;
 
-    QString text = QInputDialog::getText(this, tr("Search"), tr("Enter string to search for"), QLineEdit::Normal, mLastSearchText, &ok);
+    QString text = QInputDialog::getText(this, tr("Search"), tr("Enter string to search for or /expression/ for a regular expression"), QLineEdit::Normal, mLastSearchText, &ok);
 
     if (!ok || text.isEmpty())
         return;
@@ -1283,24 +3020,39 @@ void MainWindow::on_textEditResult_selectionChanged()
         int line = text.toInt();
 
         if (line > 0)
-            ui->tableViewLog->selectRow(line-1);
+            selectSourceRow(line-1);
     }
 }
 
 void MainWindow::keyPressEvent(QKeyEvent *event)
 {
+    if (event->key() == Qt::Key_Escape && ui->widgetSearchBar->isVisible())
+    {
+        ui->widgetSearchBar->hide();
+        ui->tableViewLog->setFocus();
+        return;
+    }
+
     if (event->key() == Qt::Key_F3)
     {
         if (mLastSearchLine > 0)
         {
-            mLastSearchLine = search(mLastSearchText, mLastSearchLine, mMenuColumn);
+            bool forward = !(event->modifiers() & Qt::ShiftModifier);                  // Shift+F3 goes backwards
+            int current = currentSourceRow();
+            qsizetype row = (current >= 0) ? current : mLastSearchLine - 1;
+
+            if (mSearchHits.isEmpty())                                                  // The file was reloaded
+                mLastSearchLine = search(mLastSearchText, row, mMenuColumn);
+            else
+                mLastSearchLine = showHit(forward ? row + 1 : row, forward);
+
             return;
         }
         else
         {
             bool ok;
 
-            QString text = QInputDialog::getText(this, tr("Search"), tr("Enter string to search for"), QLineEdit::Normal, mLastSearchText, &ok);
+            QString text = QInputDialog::getText(this, tr("Search"), tr("Enter string to search for or /expression/ for a regular expression"), QLineEdit::Normal, mLastSearchText, &ok);
 
             if (!ok || text.isEmpty())
                 return;
@@ -1336,48 +3088,443 @@ void MainWindow::closeEvent(QCloseEvent *event)
     }
 }
 
+/**
+ * @brief MainWindow::search
+ * Finds all rows containing \p text and selects the first one at or after
+ * the row \p offset. The raw records are searched by TSearch. If the search
+ * is limited to a column or the cells are extracted from JSON records, the
+ * text of a cell differs from the raw bytes. Then the raw search only finds
+ * the candidates and the text of the cells of every candidate is tested.
+ * All hits are kept, so F3 and Shift+F3 just move to the next or previous
+ * hit without searching again. The search runs in the background while a
+ * progress dialog offers to cancel it.
+ *
+ * A text enclosed in slashes (/pattern/ or /pattern/i to ignore the case)
+ * is a regular expression.
+ *
+ * @param text      The text to search for.
+ * @param offset    The row to start with.
+ * @param col       The column to search in or -1 for the whole record.
+ * @return The number of the selected row + 1 or -1 if nothing was found.
+ */
 qsizetype MainWindow::search(const QString& text, qsizetype offset, int col)
 {
     DECL_TRACER("MainWindow::search(const QString& text, qsizetype offset, int col)");
 
     MSG_DEBUG("Searching for \"" << text.toStdString() << "\" from offset " << offset << " ...");
+    QStandardItemModel *model = mModel;
+
+    if (!model || !mIndex)
+    {
+        MSG_ERROR("No model found!");
+        return -1;
+    }
+
+    TSearch *engine = new TSearch(mIndex);
+    QRegularExpression regex;                                                           // Valid if a regular expression is searched
+    bool byColumn = col >= 0 && col < TConfig::getColumns();
+    bool confirm = byColumn || mJsonRecords;                                            // Must the cells be tested?
+
+    if (!setupSearch(*engine, text, &regex, confirm))
+    {
+        QMessageBox::warning(this, APPNAME, tr("The search expression is not valid:<br>%1").arg(engine->errorString()));
+        delete engine;
+        return -1;
+    }
+
     // Progress meter
-    QProgressDialog progress(tr("Searching for a string ..."), tr("Cancel"), 0, mTotalLines, this);
+    QProgressDialog progress(tr("Searching for a string ..."), tr("Cancel"), 0, 0, this);
     progress.setWindowModality(Qt::WindowModal);
+    QEventLoop loop;
+    QTimer poll;                                                                        // Looks whether the search is finished
 
-    QStandardItemModel *model = static_cast<QStandardItemModel *>(ui->tableViewLog->model());
+    connect(&poll, &QTimer::timeout, &loop, [engine, &loop]() {
+        if (!engine->isRunning())
+            loop.quit();
+    });
 
-    if (!model)
+    connect(&progress, &QProgressDialog::canceled, &loop, &QEventLoop::quit);
+    engine->start(nullptr, nullptr);
+    poll.start(20);
+    loop.exec();
+    poll.stop();
+
+    if (engine->isRunning())                                                            // Canceled?
     {
-        MSG_ERROR("No model found!");
+        dropSearch(engine);
         return -1;
     }
 
-    qsizetype rows = model->rowCount();
-    int column = 0;
+    bool aborted = engine->aborted();
+    vector<int> rows;
+    rowsOfRecords(engine->records(), rows);                                             // Map the records to the rows showing them
+    delete engine;
+    mSearchHits.clear();
+    mMinimap->clear(TMinimap::MARK_HIT);
+
+    for (int row : rows)
+    {
+        if (confirm && !rowMatches(row, byColumn ? col : -1, text, regex))              // Only a candidate?
+            continue;
+
+        mSearchHits.add(static_cast<quint32>(row));
+        markHit(row);
+    }
+
+    mMinimap->refresh();
+    progress.reset();
+
+    if (aborted)
+        QMessageBox::warning(this, APPNAME, tr("The search expression is too slow and the search was stopped!<br>Only %1 rows were found so far.").arg(mSearchHits.cardinality()));
+
+    return showHit(offset, true);
+}
+
+/**
+ * @brief MainWindow::setupSearch
+ * Sets the text or the regular expression (/expression/ or /expression/i)
+ * to search for. If the search index is ready, the search is limited to
+ * the candidates of the index.
+ *
+ * @param engine    The search.
+ * @param text      The text entered by the user.
+ * @param regex     Receives the expression, if the text is one.
+ * @param prefilter TRUE = the engine only finds the candidates whose cells
+ * must be tested by rowMatches(). It searches for a part of the text which
+ * can't differ between the raw record and the cells.
+ * @return If the expression is not valid, FALSE is returned.
+ */
+bool MainWindow::setupSearch(TSearch& engine, const QString& text, QRegularExpression *regex, bool prefilter)
+{
+    DECL_TRACER("MainWindow::setupSearch(TSearch& engine, const QString& text, QRegularExpression *regex, bool prefilter)");
+
+    static const QRegularExpression slashes("\\A/(.+)/(i?)\\z");
+    QRegularExpressionMatch isRegex = slashes.match(text);
+
+    if (regex)
+        *regex = QRegularExpression();
 
-    if (col >= 0 && col < TConfig::getColumns())
-        column = col;
+    if (isRegex.hasMatch())
+    {
+        bool caseInsensitive = !isRegex.captured(2).isEmpty();
+
+        if (!engine.setRegex(isRegex.captured(1), caseInsensitive))
+            return false;
+
+        if (prefilter)                                                                  // The literal must be in the raw record
+            engine.setText(caseInsensitive ? QString() : rawLiteral(TLineParser::requiredLiteral(isRegex.captured(1))));
+
+        if (regex)                                                                      // Must match a cell like the engine matches a record
+        {
+            regex->setPattern(isRegex.captured(1));
+            regex->setPatternOptions(caseInsensitive ? QRegularExpression::MultilineOption | QRegularExpression::CaseInsensitiveOption
+                                                     : QRegularExpression::MultilineOption);
+        }
+    }
     else
-        column = TConfig::getColumns() - 1;
+        engine.setText(prefilter ? rawLiteral(text) : text);
 
-    for (qsizetype line = offset; line < rows; ++line)
+    if (mTrigrams && mTrigrams->isReady())                                              // Narrow the search by the index
     {
-        progress.setValue(line);
+        vector<quint32> blocks;
 
-        if (progress.wasCanceled())
-            break;
+        if (mTrigrams->candidates(engine.literal(), blocks))
+            engine.setCandidates(blocks, TTrigramIndex::BLOCK_RECORDS);
+    }
 
-        QStandardItem *item = model->item(line, column);
+    return true;
+}
+
+/**
+ * @brief MainWindow::rawLiteral
+ * Finds the longest part of a literal which is in the raw record whenever
+ * the literal is in a cell. Quotes, backslashes, blanks and non-ASCII
+ * characters may be escaped or unquoted in the raw record. In JSON records
+ * a comma becomes a blank, a slash may be escaped and numbers and booleans
+ * are formatted anew.
+ *
+ * @param literal   The literal every matching cell contains.
+ * @return The part or an empty string if every record is a candidate.
+ */
+QString MainWindow::rawLiteral(const QString& literal)
+{
+    bool digits = true;                                                                 // TRUE = digits are copied unchanged
+
+    if (mJsonRecords)
+    {
+        for (const TValueSelect::VALUES_t& value : TConfig::values())
+        {
+            if (value.type != TValueSelect::VTYPE_STRING)
+                digits = false;
+        }
+    }
+
+    qsizetype best = 0, bestLength = 0, start = 0;
 
-        if (item && item->text().contains(text))
+    for (qsizetype i = 0; i <= literal.size(); ++i)
+    {
+        bool safe = false;
+
+        if (i < literal.size())
+        {
+            char16_t c = literal[i].unicode();
+            safe = c > ' ' && c < 0x7f && c != '"' && c != '\\' && (!mJsonRecords || (c != ',' && c != '/')) && (digits || c < '0' || c > '9');
+        }
+
+        if (safe)
+            continue;
+
+        if (i - start > bestLength)
         {
-            ui->tableViewLog->selectRow(line);
-            return line + 1;
+            best = start;
+            bestLength = i - start;
         }
+
+        start = i + 1;
+    }
+
+    return literal.mid(best, bestLength);
+}
+
+/**
+ * @brief MainWindow::rowMatches
+ * Tests the text of the cells of a row found by a prefilter search.
+ *
+ * @param row   The row.
+ * @param col   The column to test or -1 for all columns.
+ * @param text  The text to search for.
+ * @param regex The expression to search for; if its pattern is empty, the
+ * text is searched.
+ * @return If a cell contains the text, TRUE is returned.
+ */
+bool MainWindow::rowMatches(int row, int col, const QString& text, const QRegularExpression& regex)
+{
+    int from = col >= 0 ? col : 0;
+    int to = col >= 0 ? col + 1 : mModel->columnCount();
+
+    for (int c = from; c < to; ++c)
+    {
+        QStandardItem *item = mModel->item(row, c);
+
+        if (item && (regex.pattern().isEmpty() ? item->text().contains(text) : item->text().contains(regex)))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief MainWindow::rowsOfRecords
+ * Finds the rows showing some records. Records filtered out by the thread
+ * filter are skipped.
+ *
+ * @param records   The sorted indexes of the records.
+ * @param rows      Receives the rows.
+ */
+void MainWindow::rowsOfRecords(const vector<qsizetype>& records, vector<int>& rows)
+{
+    int row = 0;
+
+    for (qsizetype record : records)
+    {
+        row = rowOfRecord(record, row);
+
+        if (row < 0)
+            break;
+
+        if (recordOfRow(row) == record)                                                 // Not filtered out by the thread filter?
+            rows.push_back(row);
+    }
+}
+
+/**
+ * @brief MainWindow::startSearch
+ * Searches the text of the search bar in the background. A running search
+ * is canceled first. If the text only got longer, just the records found by
+ * the last search are searched again. The hits are added to the result as
+ * soon as a part of the file is searched.
+ *
+ * @param text  The text of the search bar.
+ */
+void MainWindow::startSearch(const QString& text)
+{
+    DECL_TRACER("MainWindow::startSearch(const QString& text)");
+
+    if (mSearchJob)                                                                     // Cancel the running search
+    {
+        dropSearch(mSearchJob);
+        mSearchJob = nullptr;
     }
 
-    return -1;
+    mSearchSerial++;
+    mSearchHits.clear();
+    mMinimap->clear(TMinimap::MARK_HIT);
+    mLastSearchLine = 0;
+    mMenuColumn = -1;
+    ui->labelSearchHits->clear();
+    bool isPlain = !text.startsWith('/') && !mBarText.startsWith('/');
+    bool refine = mBarDone && isPlain && !mBarText.isEmpty() && text.contains(mBarText);   // Can only find a subset of the last hits?
+
+    if (text.isEmpty() || !mIndex)
+    {
+        mBarText.clear();
+        mBarRecords.clear();
+        mBarDone = false;
+        return;
+    }
+
+    mLastSearchText = text;
+    mSearchJob = new TSearch(mIndex);
+
+    if (!setupSearch(*mSearchJob, text, &mBarRegex, mJsonRecords))
+    {
+        ui->labelSearchHits->setText(tr("Invalid expression"));
+        ui->labelSearchHits->setToolTip(mSearchJob->errorString());
+        delete mSearchJob;
+        mSearchJob = nullptr;
+        return;
+    }
+
+    if (refine)
+        mSearchJob->setRecords(mBarRecords);
+
+    MSG_DEBUG("Searching for \"" << text.toStdString() << "\"" << (refine ? " in the last hits" : "") << " ...");
+    mBarText = text;
+    mBarRecords.clear();
+    mBarDone = false;
+    ui->labelSearchHits->setText(tr("Searching ..."));
+    quint64 serial = mSearchSerial;
+
+    // The callbacks are called by the threads of the search. The hits are
+    // passed to the GUI thread, which ignores them if a newer search was
+    // started in the meantime.
+    mSearchJob->start([this, serial](vector<qsizetype>&& records) {
+        QMetaObject::invokeMethod(this, [this, serial, records = std::move(records)]() {
+            if (serial == mSearchSerial)
+                addSearchHits(records);
+        }, Qt::QueuedConnection);
+    },
+    [this, serial](bool aborted) {
+        QMetaObject::invokeMethod(this, [this, serial, aborted]() {
+            if (serial != mSearchSerial)
+                return;
+
+            std::sort(mBarRecords.begin(), mBarRecords.end());
+            mBarDone = !aborted;                                                        // Only a complete result can be refined
+            ui->labelSearchHits->setText(aborted ? tr("%1 hits (expression too slow)").arg(mSearchHits.cardinality()) : tr("%1 hits").arg(mSearchHits.cardinality()));
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief MainWindow::addSearchHits
+ * Adds the hits of a part of the file to the result of the search bar. The
+ * first hit arriving is selected.
+ *
+ * @param records   The sorted records found in a part.
+ */
+void MainWindow::addSearchHits(const vector<qsizetype>& records)
+{
+    mBarRecords.insert(mBarRecords.end(), records.begin(), records.end());
+    vector<int> rows;
+    rowsOfRecords(records, rows);
+
+    if (rows.empty())
+        return;
+
+    for (int row : rows)
+    {
+        if (mJsonRecords && !rowMatches(row, -1, mBarText, mBarRegex))                 // The raw bytes contain key names and escapes
+            continue;
+
+        mSearchHits.add(static_cast<quint32>(row));
+        markHit(row);
+    }
+
+    mMinimap->refresh();
+    ui->labelSearchHits->setText(tr("%1 hits ...").arg(mSearchHits.cardinality()));
+
+    if (mLastSearchLine <= 0)                                                           // Nothing selected yet?
+    {
+        int current = std::max(0, currentSourceRow());
+        mLastSearchLine = showHit(current, true);
+    }
+}
+
+/**
+ * @brief MainWindow::dropSearch
+ * Cancels a search without waiting for its thread. The search is deleted
+ * by reapSearches() as soon as the thread has finished.
+ *
+ * @param job   The search. It must not be used afterwards.
+ */
+void MainWindow::dropSearch(TSearch *job)
+{
+    DECL_TRACER("MainWindow::dropSearch(TSearch *job)");
+
+    job->cancel();
+    mOldSearches.push_back(job);
+    QTimer::singleShot(50, this, [this]() { reapSearches(false); });
+}
+
+/**
+ * @brief MainWindow::reapSearches
+ * Deletes the canceled searches whose threads have finished.
+ *
+ * @param wait  TRUE = wait for all threads, e.g. before the index is
+ * deleted.
+ */
+void MainWindow::reapSearches(bool wait)
+{
+    auto finished = std::partition(mOldSearches.begin(), mOldSearches.end(), [wait](TSearch *job) { return !wait && job->isRunning(); });
+
+    for (auto iter = finished; iter != mOldSearches.end(); ++iter)
+        delete *iter;
+
+    mOldSearches.erase(finished, mOldSearches.end());
+
+    if (!mOldSearches.empty())
+        QTimer::singleShot(50, this, [this]() { reapSearches(false); });
+}
+
+/**
+ * @brief MainWindow::showHit
+ * Selects the next or previous row of the last search result.
+ *
+ * @param row       The row to start with.
+ * @param forward   TRUE = the first hit at or after \p row, FALSE = the
+ * last hit before \p row.
+ * @return The number of the selected row + 1 or -1 if there is no hit.
+ */
+qsizetype MainWindow::showHit(qsizetype row, bool forward)
+{
+    DECL_TRACER("MainWindow::showHit(qsizetype row, bool forward)");
+
+    const TRowBitmap *hits = &mSearchHits;
+    TRowBitmap visible;
+
+    if (mProxy->isFiltered())                                                           // Skip the hits filtered out
+    {
+        visible = mSearchHits;
+        visible &= mProxy->rows();
+        hits = &visible;
+    }
+
+    if (hits->isEmpty())
+    {
+        ui->statusbar->showMessage(tr("\"%1\" was not found").arg(mLastSearchText), 5000);
+        return -1;
+    }
+
+    quint32 start = static_cast<quint32>(std::max(static_cast<qsizetype>(0), row));
+    qint64 hit = forward ? hits->next(start) : hits->previous(start);
+
+    if (hit < 0)                                                                        // Wrap around
+        hit = hits->select(forward ? 0 : hits->cardinality() - 1);
+
+    selectSourceRow(static_cast<int>(hit));
+    ui->statusbar->showMessage(tr("Hit %1 of %2").arg(hits->rank(static_cast<quint32>(hit)) + 1).arg(hits->cardinality()), 5000);
+    return hit + 1;
 }
 
 bool MainWindow::writeFile(const QString& file)
@@ -20,8 +20,15 @@
 
 #include <QMainWindow>
 #include <QModelIndex>
+#include <QIcon>
+#include <QPointer>
+#include <QDialog>
+
+#include <climits>
+#include <vector>
 
 #include "tthreadselect.h"
+#include "trowbitmap.h"
 
 #define V_MAJOR     1
 #define V_MINOR     1
@@ -45,7 +52,20 @@ QT_END_NAMESPACE
 
 class QLabel;
 class TWait;
+class TLogIndex;
+class TTrigramIndex;
+class TSearch;
+class QRegularExpression;
 class QAbstractItemModel;
+class QStandardItemModel;
+class TFilterProxy;
+class TColumnStore;
+class TCallTree;
+class TBlockIndex;
+class THistogram;
+class TMinimap;
+class TTemplateMiner;
+class TExceptionGroups;
 
 class MainWindow : public QMainWindow
 {
@@ -61,13 +81,16 @@ class MainWindow : public QMainWindow
         QString getLogFileName(QString *filter=nullptr);
         bool parseFile(qsizetype totalLines=0, const QString& filter="", const QString& thread_ilter="");
         void pressed(const QModelIndex &index);
+        void doubleClicked(const QModelIndex &index);
 
         void keyPressEvent(QKeyEvent *event) override;
+        bool eventFilter(QObject *watched, QEvent *event) override;
         void resizeEvent(QResizeEvent *event) override;
         void closeEvent(QCloseEvent *event) override;
 
     private slots:
         void on_actionOpen_triggered();
+        void on_actionOpen_time_window_triggered();
         void on_actionSave_result_triggered();
         void on_actionSave_result_as_triggered();
         void on_actionLoad_profile_triggered();
@@ -76,7 +99,19 @@ class MainWindow : public QMainWindow
         void on_actionExit_triggered();
         void on_actionValidate_consistnace_triggered();
         void on_actionFind_exceptions_triggered();
+        void on_actionMessage_patterns_triggered();
+        void on_actionHot_methods_triggered();
+        void on_actionExport_trace_triggered();
+        void on_actionThread_timeline_triggered();
         void on_actionSearch_triggered();
+        void on_actionSearch_bar_triggered();
+        void on_actionGo_to_time_triggered();
+        void on_actionJump_to_partner_triggered();
+        void on_actionFold_block_triggered();
+        void on_actionUnfold_all_triggered();
+        void on_actionTime_histogram_toggled(bool checked);
+        void on_actionMinimap_toggled(bool checked);
+        void on_actionFilter_query_triggered();
         void on_actionFilter_thread_triggered(bool checked);
         void on_actionReload_triggered();
         void on_actionSettings_triggered();
@@ -86,8 +121,22 @@ class MainWindow : public QMainWindow
 
         void onPopupMenuCopyTriggered(bool checked=false);
         void onPopupMenuSearchTriggered(bool checked=false);
+        void startSearch(const QString& text);
 
     private:
+        typedef enum LEVEL_t
+        {
+            LEVEL_OTHER,
+            LEVEL_TRACE,
+            LEVEL_INFO,
+            LEVEL_WARNING,
+            LEVEL_ERROR,
+            LEVEL_DEBUG,
+            LEVEL_NONE                                  // An empty row
+        }LEVEL_t;
+
+        static constexpr quint8 LEVEL_ALL = 0x3f;       // The bits of all levels from LEVEL_OTHER to LEVEL_DEBUG
+
         QList<QString> split(const QString& str, const QString& deli, int cols=-1);
         qsizetype search(const QString& text, qsizetype offset=0, int col=-1);
         bool writeFile(const QString& file);
@@ -95,6 +144,39 @@ class MainWindow : public QMainWindow
         void clearStatusbar();
         void filterThread(const QString& threadID);
         qsizetype countLines(const QString& file);
+        void setModel(QStandardItemModel *model);
+        void selectSourceRow(int row);
+        int currentSourceRow();
+        void applyRowFilter();
+        TRowBitmap levelRows();
+        void setupLevelLabel(QLabel *label, LEVEL_t level);
+        void toggleLevel(LEVEL_t level, bool only);
+        void toggleFold(int entry);
+        void updateMarker(QStandardItem *item);
+        TRowBitmap foldedRows();
+        void updateHistogram();
+        void filterTime(qint64 from, qint64 to);
+        void updateMinimap();
+        void markHit(int row);
+        void filterTemplate(int id);
+        QVariant rowTime(int row);
+        QStringList stackTrace(const TExceptionGroups& groups, int row);
+        QString contextOf(int row);
+        qsizetype recordOfRow(int row);
+        int rowOfRecord(qsizetype record, int first=0);
+        qsizetype showHit(qsizetype row, bool forward);
+        bool setupSearch(TSearch& engine, const QString& text, QRegularExpression *regex=nullptr, bool prefilter=false);
+        QString rawLiteral(const QString& literal);
+        bool rowMatches(int row, int col, const QString& text, const QRegularExpression& regex);
+        void rowsOfRecords(const std::vector<qsizetype>& records, std::vector<int>& rows);
+        void addSearchHits(const std::vector<qsizetype>& records);
+        void dropSearch(TSearch *job);
+        void reapSearches(bool wait);
+        qint64 parseTime(const QString& text, qint64 reference);
+        void selectTime(qint64 usec);
+        bool hasCallTimes();
+        bool buildCallTree(TCallTree& tree, const QString& title);
+        bool selectTimeWindow();
 
         Ui::MainWindow *ui;
         qsizetype mTotalLines{0};
@@ -107,9 +189,11 @@ class MainWindow : public QMainWindow
         QLabel *mLbErrors{nullptr};
         QLabel *mLbDebugs{nullptr};
         QLabel *mLbOthers{nullptr};
+        QLabel *mLbFilter{nullptr};
         TWait *mWait{nullptr};
         qsizetype mLastSearchLine{0};
         QString mLastSearchText;
+        TRowBitmap mSearchHits;                         // The rows found by the last search
         QString mSaveFile;
         QString mTempFile;
         QString mProfile;
@@ -120,5 +204,46 @@ class MainWindow : public QMainWindow
         const QAbstractItemModel *mModelMenu{nullptr};
         QModelIndex mModelIndex;
         int mMenuColumn{-1};
+        QStandardItemModel *mModel{nullptr};            // The cells of the table
+        QIcon mIconCollapsed;                           // Marks a record whose continuation lines are hidden
+        QIcon mIconExpanded;                            // Marks an expanded record
+        QIcon mIconFolded;                              // Marks the entry of a folded block
+        TFilterProxy *mProxy{nullptr};                  // Shows the rows of mModel matching the filter query
+        TColumnStore *mColumnStore{nullptr};            // The dictionary encoded columns of mModel, built by the first filter query
+        QString mFilterQuery;                           // The last filter query
+        TRowBitmap mQueryRows;                          // The rows matching the filter query
+        bool mQueryActive{false};                       // TRUE = the rows are filtered by the filter query
+        std::vector<quint8> mLevels;                    // The level (LEVEL_t) of every row, recorded while loading
+        quint8 mLevelMask{LEVEL_ALL};                   // One bit for every level shown
+        TBlockIndex *mBlocks{nullptr};                  // The partner of every block entry and exit, built while loading
+        TRowBitmap mFoldedBlocks;                       // The entries of the folded blocks
+        TRowBitmap mFoldedRows;                         // The rows hidden by the folded blocks
+        THistogram *mHistogram{nullptr};                // The rows per time bucket above the table
+        TMinimap *mMinimap{nullptr};                    // The overview ruler beside the table
+        TTemplateMiner *mMiner{nullptr};                // The message patterns, mined on demand
+        QPointer<QDialog> mTemplateList;                // The dialog listing the message patterns
+        QPointer<QDialog> mExceptionList;               // The dialog listing the groups of exceptions
+        TRowBitmap mTemplateRows;                       // The rows matching the selected message pattern
+        bool mTemplateActive{false};                    // TRUE = the rows are filtered by a message pattern
+        QString mTemplateText;                          // The selected message pattern
+        TRowBitmap mTimeRows;                           // The rows in the time range selected in the histogram
+        bool mTimeActive{false};                        // TRUE = the rows are filtered by a time range
+        qint64 mTimeFrom{0};                            // The start of the selected time range
+        qint64 mTimeTo{0};                              // The end of the selected time range
+        TLogIndex *mIndex{nullptr};                     // The position of every record in the mapped file
+        TTrigramIndex *mTrigrams{nullptr};              // The search index, built in the background
+        TSearch *mSearchJob{nullptr};                   // The running search of the search bar
+        std::vector<TSearch *> mOldSearches;            // Canceled searches whose threads are still finishing
+        quint64 mSearchSerial{0};                       // Incremented for every search of the search bar
+        QString mBarText;                               // The text of the last search of the search bar
+        std::vector<qsizetype> mBarRecords;             // The records found by the last search of the search bar
+        bool mBarDone{false};                           // TRUE = mBarRecords is complete
+        QRegularExpression mBarRegex;                   // The expression of the search bar, if the text is one
+        bool mJsonRecords{false};                       // TRUE = the cells are extracted from JSON records
+        bool mDetectFormat{false};                      // TRUE = detect the format of the next parsed file
+        QString mFormatInfo;                            // Description of the detected format, if it was applied
+        bool mTimeWindow{false};                        // TRUE = only a time window of the file is loaded
+        qint64 mWindowStart{LLONG_MIN};                 // The start of the time window in microseconds (LLONG_MIN = ask for it)
+        qint64 mWindowEnd{LLONG_MIN};                   // The end of the time window in microseconds
 };
 #endif // MAINWINDOW_H
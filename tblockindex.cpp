@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+
+#include "tblockindex.h"
+#include "tlogger.h"
+
+TBlockIndex::TBlockIndex(const QString& blockEntry, const QString& blockExit)
+    : mMatcher(blockEntry, blockExit)
+{
+    DECL_TRACER("TBlockIndex::TBlockIndex(const QString& blockEntry, const QString& blockExit)");
+}
+
+/**
+ * @brief TBlockIndex::addRow
+ * Adds the next block line. Lines without a block entry or exit are
+ * ignored, so the loader may pass only the lines it found a marker in.
+ *
+ * @param row       The row of the table.
+ * @param text      The text of the line.
+ * @param thread    The thread ID of the line or an empty string, if there
+ * is no thread column.
+ */
+void TBlockIndex::addRow(int row, const QString& text, const QString& thread)
+{
+    int method;
+    TBlockMatcher::KIND_t kind = mMatcher.parse(text, &method);
+
+    if (kind == TBlockMatcher::KIND_NONE)
+        return;
+
+    if (static_cast<int>(mPartner.size()) <= row)
+    {
+        mPartner.resize(static_cast<size_t>(row) + 1, -1);
+        mDepth.resize(static_cast<size_t>(row) + 1, 0);
+    }
+
+    std::vector<FRAME_t>& stack = mStacks[thread];
+
+    if (kind == TBlockMatcher::KIND_ENTRY)
+    {
+        mDepth[row] = static_cast<quint16>(std::min(stack.size(), static_cast<size_t>(0xffff)));
+        stack.push_back({ method, row });
+        return;
+    }
+
+    FRAME_t frame;
+    int start = TBlockMatcher::close(stack, method, &frame).entry;
+
+    if (start < 0)
+        return;
+
+    mPartner[start] = row;
+    mPartner[row] = start;
+    mDepth[row] = mDepth[start];
+    mBlocks++;
+}
+
+/**
+ * @brief TBlockIndex::finish
+ * Sizes the arrays to the number of rows and frees what is needed only
+ * while loading.
+ *
+ * @param rows  The number of rows of the table.
+ */
+void TBlockIndex::finish(int rows)
+{
+    DECL_TRACER("TBlockIndex::finish(int rows)");
+
+    if (!mPartner.empty())
+    {
+        mPartner.resize(static_cast<size_t>(rows), -1);
+        mDepth.resize(static_cast<size_t>(rows), 0);
+        mPartner.shrink_to_fit();
+        mDepth.shrink_to_fit();
+    }
+
+    MSG_DEBUG("Block index: " << mBlocks << " matched blocks in " << mStacks.size() << " threads");
+    mStacks.clear();
+    mMatcher.clear();
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TBLOCKINDEX_H
+#define TBLOCKINDEX_H
+
+#include <QString>
+#include <QHash>
+
+#include <vector>
+
+#include "tblockmatcher.h"
+
+/**
+ * @brief The TBlockIndex class
+ * Pairs the block entry and exit lines (see TConfig::getBlockEntry()) while
+ * a file is loaded. For every row it keeps the row of its partner and the
+ * nesting depth of the block, so the partner of a row is found in constant
+ * time.
+ *
+ * The rows are added in order and paired by a TBlockMatcher; blocks
+ * closed without an exit stay without a partner. The arrays are
+ * allocated with the first block line, so files without blocks need no
+ * memory.
+ */
+class TBlockIndex
+{
+    public:
+        TBlockIndex(const QString& blockEntry, const QString& blockExit);
+
+        void addRow(int row, const QString& text, const QString& thread);
+        void finish(int rows);
+        int partner(int row) const { return (row >= 0 && row < static_cast<int>(mPartner.size())) ? mPartner[row] : -1; }
+        int depth(int row) const { return (row >= 0 && row < static_cast<int>(mDepth.size())) ? mDepth[row] : 0; }
+        bool isEntry(int row) const { return partner(row) > row; }
+        qint64 blocks() const { return mBlocks; }
+
+    private:
+        typedef struct FRAME_t
+        {
+            int method{0};                      // The number of the method
+            int row{0};                         // The row of the entry
+        }FRAME_t;
+
+        TBlockMatcher mMatcher;
+        QHash<QString, std::vector<FRAME_t>> mStacks;   // The open blocks of every thread
+        std::vector<qint32> mPartner;           // The partner of every row (-1 = none)
+        std::vector<quint16> mDepth;            // The nesting depth of every block line
+        qint64 mBlocks{0};                      // The number of matched blocks
+};
+
+#endif // TBLOCKINDEX_H
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include "tblockmatcher.h"
+#include "tlogger.h"
+
+TBlockMatcher::TBlockMatcher(const QString& blockEntry, const QString& blockExit)
+    : mBlockEntry(blockEntry),
+      mBlockExit(blockExit)
+{
+    DECL_TRACER("TBlockMatcher::TBlockMatcher(const QString& blockEntry, const QString& blockExit)");
+}
+
+/**
+ * @brief TBlockMatcher::parse
+ * Tests whether a line is a block entry or exit and finds its method.
+ *
+ * @param text      The text of the line.
+ * @param method    Receives the number of the method.
+ * @return The kind of the line. A marker without a method name is no
+ * block line.
+ */
+TBlockMatcher::KIND_t TBlockMatcher::parse(const QString& text, int *method)
+{
+    qsizetype pos;
+    KIND_t kind;
+
+    if (!mBlockEntry.isEmpty() && (pos = text.indexOf(mBlockEntry)) >= 0)
+    {
+        kind = KIND_ENTRY;
+        pos += mBlockEntry.length();
+    }
+    else if (!mBlockExit.isEmpty() && (pos = text.indexOf(mBlockExit)) >= 0)
+    {
+        kind = KIND_EXIT;
+        pos += mBlockExit.length();
+    }
+    else
+        return KIND_NONE;
+
+    QString name = methodName(QStringView(text).mid(pos));
+
+    if (name.isEmpty())
+        return KIND_NONE;
+
+    auto iter = mMethods.constFind(name);
+
+    if (iter != mMethods.constEnd())
+        *method = iter.value();
+    else
+    {
+        *method = static_cast<int>(mNames.size());
+        mMethods.insert(name, *method);
+        mNames.push_back(name);
+    }
+
+    return kind;
+}
+
+/**
+ * @brief TBlockMatcher::clear
+ * Forgets the numbers of the methods.
+ */
+void TBlockMatcher::clear()
+{
+    DECL_TRACER("TBlockMatcher::clear()");
+
+    mMethods.clear();
+    mNames.clear();
+}
+
+/**
+ * @brief TBlockMatcher::methodName
+ * Takes the name of a method from the text following a block marker. The
+ * parameters and a return type are removed, so an entry with parameters
+ * matches an exit without.
+ *
+ * @param text  The text after the marker.
+ * @return The name of the method.
+ */
+QString TBlockMatcher::methodName(QStringView text)
+{
+    text = text.trimmed();
+    qsizetype end = text.indexOf(u'(');
+
+    if (end >= 0)
+        text = text.left(end).trimmed();
+
+    qsizetype start = text.lastIndexOf(u' ');
+
+    if (start >= 0)
+        text = text.mid(start + 1);
+
+    return text.toString();
+}
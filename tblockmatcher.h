@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TBLOCKMATCHER_H
+#define TBLOCKMATCHER_H
+
+#include <QString>
+#include <QHash>
+
+#include <vector>
+
+/**
+ * @brief The TBlockMatcher class
+ * Recognizes the block entry and exit lines (see TConfig::getBlockEntry())
+ * and pairs them. It is shared by TBlockIndex, TCallTree and TValidator, so
+ * all of them pair the same lines.
+ *
+ * A line is a block line if it contains the entry or the exit marker
+ * followed by the name of a method. The methods are numbered in the order
+ * they are found. Every thread has its own stack of open blocks. An exit
+ * closes the last open block of the same method; the blocks above it never
+ * got an exit and are closed without a partner.
+ */
+class TBlockMatcher
+{
+    public:
+        typedef enum KIND_t
+        {
+            KIND_NONE,
+            KIND_ENTRY,
+            KIND_EXIT
+        }KIND_t;
+
+        typedef struct CLOSE_t
+        {
+            int entry{-1};                      // The row of the entry closed by an exit (-1 = no open block of the method)
+            int depth{0};                       // The number of blocks still open below the closed one
+            int dropped{0};                     // The number of open blocks above it closed without an exit
+        }CLOSE_t;
+
+        TBlockMatcher(const QString& blockEntry, const QString& blockExit);
+
+        KIND_t parse(const QString& text, int *method);
+        const QString& name(int method) const { return mNames[static_cast<size_t>(method)]; }
+        int methods() const { return static_cast<int>(mNames.size()); }
+        void clear();
+        static QString methodName(QStringView text);
+
+        /**
+         * @brief close
+         * Closes the last open block of a method. The frames must have the
+         * members method and row.
+         *
+         * @param stack     The open blocks of a thread.
+         * @param method    The number of the method of the exit.
+         * @param closed    Receives the frame of the closed block.
+         * @return The row of the entry and the depth of the block.
+         */
+        template<typename FRAME>
+        static CLOSE_t close(std::vector<FRAME>& stack, int method, FRAME *closed)
+        {
+            CLOSE_t result;
+            size_t depth = stack.size();
+
+            while (depth > 0 && stack[depth - 1].method != method)
+                depth--;
+
+            if (depth == 0)
+                return result;
+
+            result.dropped = static_cast<int>(stack.size() - depth);
+            stack.resize(depth);
+            *closed = stack.back();
+            stack.pop_back();
+            result.entry = closed->row;
+            result.depth = static_cast<int>(stack.size());
+            return result;
+        }
+
+    private:
+        QString mBlockEntry;
+        QString mBlockExit;
+        QHash<QString, int> mMethods;           // The number of every method name
+        std::vector<QString> mNames;            // The name of every method
+};
+
+#endif // TBLOCKMATCHER_H
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "tcalltree.h"
+#include "tlogger.h"
+
+using std::vector;
+
+TCallTree::TCallTree(const QString& blockEntry, const QString& blockExit)
+    : mMatcher(blockEntry, blockExit)
+{
+    DECL_TRACER("TCallTree::TCallTree(const QString& blockEntry, const QString& blockExit)");
+}
+
+/**
+ * @brief TCallTree::setCallHandler
+ * Sets a function called for every complete call.
+ *
+ * @param handler       The function to call. It gets the name of the
+ * method, the thread, the row of the entry, the time of the entry and the
+ * duration of the call in microseconds.
+ * @param statistics    FALSE = the durations are not collected. The
+ * number of calls and the total times are still counted, but the
+ * percentiles are not computed.
+ */
+void TCallTree::setCallHandler(CALL_HANDLER handler, bool statistics)
+{
+    DECL_TRACER("TCallTree::setCallHandler(CALL_HANDLER handler, bool statistics)");
+
+    mCallHandler = handler;
+    mStatistics = statistics;
+}
+
+/**
+ * @brief TCallTree::addRow
+ * Adds the next row. Lines without a block entry or exit are ignored.
+ *
+ * @param row       The row of the table.
+ * @param text      The text of the line.
+ * @param thread    The thread ID of the line or an empty string, if there
+ * is no thread column.
+ * @param usec      The timestamp of the line in microseconds.
+ */
+void TCallTree::addRow(int row, const QString& text, const QString& thread, qint64 usec)
+{
+    int method;
+    TBlockMatcher::KIND_t kind = mMatcher.parse(text, &method);
+
+    if (kind == TBlockMatcher::KIND_NONE)
+        return;
+
+    vector<FRAME_t>& stack = mStacks[thread];
+    addMethod(method);
+
+    if (kind == TBlockMatcher::KIND_ENTRY)
+    {
+        stack.push_back({ method, row, usec, 0 });
+        return;
+    }
+
+    FRAME_t frame;
+    TBlockMatcher::CLOSE_t closed = TBlockMatcher::close(stack, method, &frame);
+
+    if (closed.entry < 0)
+    {
+        mUnmatched++;
+        return;
+    }
+
+    mUnmatched += closed.dropped;                       // Calls without an exit
+    qint64 inclusive = std::max(static_cast<qint64>(0), usec - frame.start);
+
+    if (!stack.empty())
+        stack.back().callees += inclusive;
+
+    METHOD_t& m = mMethods[method];
+    m.calls++;
+    m.inclusive += inclusive;
+    m.exclusive += std::max(static_cast<qint64>(0), inclusive - frame.callees);
+
+    if (mStatistics)
+        mDurations[method].push_back(inclusive);
+
+    if (inclusive > m.maximum || m.slowestRow < 0)
+    {
+        m.maximum = inclusive;
+        m.slowestRow = frame.row;
+    }
+
+    if (mCallHandler)
+        mCallHandler(m.name, thread, frame.row, frame.start, inclusive);
+}
+
+/**
+ * @brief TCallTree::finish
+ * Computes the percentiles after the last row. Calls still open are
+ * counted as unmatched. Methods without a complete call are removed.
+ */
+void TCallTree::finish()
+{
+    DECL_TRACER("TCallTree::finish()");
+
+    for (auto iter = mStacks.cbegin(); iter != mStacks.cend(); ++iter)
+        mUnmatched += static_cast<qint64>(iter.value().size());
+
+    for (size_t i = 0; i < mMethods.size(); ++i)
+    {
+        vector<qint64>& durations = mDurations[i];
+
+        if (durations.empty())
+            continue;
+
+        size_t idx = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(durations.size()))) - 1;
+        std::nth_element(durations.begin(), durations.begin() + idx, durations.end());
+        mMethods[i].p99 = durations[idx];
+    }
+
+    mMethods.erase(std::remove_if(mMethods.begin(), mMethods.end(), [](const METHOD_t& m) { return m.calls == 0; }), mMethods.end());
+    mDurations.clear();
+    mMatcher.clear();
+    MSG_DEBUG("Call tree: " << mMethods.size() << " methods in " << mStacks.size() << " threads, " << mUnmatched << " unmatched lines");
+}
+
+/**
+ * @brief TCallTree::addMethod
+ * Adds the statistics of a method the first time it is found. The methods
+ * are numbered by the matcher in the order they are found.
+ *
+ * @param method    The number of the method.
+ */
+void TCallTree::addMethod(int method)
+{
+    while (static_cast<int>(mMethods.size()) <= method)
+    {
+        METHOD_t m;
+        m.name = mMatcher.name(static_cast<int>(mMethods.size()));
+        mMethods.push_back(m);
+        mDurations.emplace_back();
+    }
+}
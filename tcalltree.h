@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TCALLTREE_H
+#define TCALLTREE_H
+
+#include <QString>
+#include <QHash>
+
+#include <vector>
+#include <functional>
+
+#include "tblockmatcher.h"
+
+/**
+ * @brief The TCallTree class
+ * Builds the call tree of every thread out of the block entry and exit
+ * lines of a trace log (see TConfig::getBlockEntry()) and measures the time
+ * spent in every method by the timestamps of the lines.
+ *
+ * The rows are added in order in one pass and paired by a TBlockMatcher;
+ * calls closed without an exit are dropped. The inclusive
+ * time of a call is the time between entry and exit, the exclusive time
+ * is the inclusive time without the inclusive time of its callees.
+ *
+ * The calls are aggregated by method name: number of calls, total
+ * inclusive and exclusive time, the 99th percentile and the longest call.
+ * The time of a recursive call is counted at every level.
+ *
+ * A handler set by setCallHandler() is called for every complete call the
+ * moment its exit is read. Without statistics only the open calls are
+ * kept, so a call tree of any size can be streamed (see TTraceExport).
+ */
+class TCallTree
+{
+    public:
+        typedef struct METHOD_t
+        {
+            QString name;                       // The name of the method
+            qint64 calls{0};                    // The number of complete calls
+            qint64 inclusive{0};                // The total inclusive time in microseconds
+            qint64 exclusive{0};                // The total exclusive time in microseconds
+            qint64 p99{0};                      // The 99th percentile of the inclusive time
+            qint64 maximum{0};                  // The longest inclusive time
+            int slowestRow{-1};                 // The row of the entry of the longest call
+        }METHOD_t;
+
+        typedef std::function<void(const QString& method, const QString& thread, int row, qint64 start, qint64 duration)> CALL_HANDLER;
+
+        TCallTree(const QString& blockEntry, const QString& blockExit);
+
+        void setCallHandler(CALL_HANDLER handler, bool statistics=true);
+        void addRow(int row, const QString& text, const QString& thread, qint64 usec);
+        void finish();
+        const std::vector<METHOD_t>& methods() const { return mMethods; }
+        qint64 unmatched() const { return mUnmatched; }
+        int threads() const { return static_cast<int>(mStacks.size()); }
+
+    private:
+        typedef struct FRAME_t
+        {
+            int method{0};                      // The index of the method in mMethods
+            int row{0};                         // The row of the entry
+            qint64 start{0};                    // The time of the entry
+            qint64 callees{0};                  // The inclusive time of the finished callees
+        }FRAME_t;
+
+        void addMethod(int method);
+
+        TBlockMatcher mMatcher;
+        QHash<QString, std::vector<FRAME_t>> mStacks;   // The open calls of every thread
+        std::vector<METHOD_t> mMethods;
+        std::vector<std::vector<qint64>> mDurations;    // The inclusive time of every call of every method
+        qint64 mUnmatched{0};                   // Entries and exits without a partner
+        CALL_HANDLER mCallHandler{nullptr};     // Called for every complete call
+        bool mStatistics{true};                 // FALSE = the times of the calls are not collected
+};
+
+#endif // TCALLTREE_H
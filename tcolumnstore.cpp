@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QStandardItemModel>
+#include <QHash>
+
+#include "tcolumnstore.h"
+#include "tconfig.h"
+#include "tlogger.h"
+
+using std::vector;
+
+/**
+ * @brief TColumnStore::TColumnStore
+ * Collects the records of the rows. The columns are encoded later, when
+ * they are used by a filter.
+ *
+ * @param model         The model of the table.
+ * @param recordRole    The role of the first cell of a row holding the
+ * index of the record.
+ * @param collapsedRole The role of a cell holding the text of an expanded
+ * cell before it was expanded.
+ */
+TColumnStore::TColumnStore(const QStandardItemModel *model, int recordRole, int collapsedRole)
+    : mModel(model),
+      mCollapsedRole(collapsedRole)
+{
+    DECL_TRACER("TColumnStore::TColumnStore(const QStandardItemModel *model, int recordRole, int collapsedRole)");
+
+    if (!mModel)
+        return;
+
+    mRows = mModel->rowCount();
+    mColumnCount = mModel->columnCount();
+    mColumns.resize(mColumnCount + 1);
+    mRecords.assign(mRows, -1);
+
+    for (int row = 0; row < mRows; ++row)
+    {
+        QStandardItem *item = mModel->item(row, 0);
+
+        if (!item)                                  // Rows reserved for the progress bar may stay empty
+            continue;
+
+        mRecords[row] = item->data(recordRole).toLongLong();
+        mFilled.add(static_cast<quint32>(row));
+    }
+}
+
+const vector<quint32>& TColumnStore::ids(int column)
+{
+    if (!mColumns[column].built)
+        build(column);
+
+    return mColumns[column].ids;
+}
+
+const QStringList& TColumnStore::dictionary(int column)
+{
+    if (!mColumns[column].built)
+        build(column);
+
+    return mColumns[column].dictionary;
+}
+
+/**
+ * @brief TColumnStore::build
+ * Encodes a column. The value of the level column is the first configured
+ * tag contained in the row, tested in the same order the rows are colored.
+ *
+ * @param column    The column or levelColumn().
+ */
+void TColumnStore::build(int column)
+{
+    DECL_TRACER("TColumnStore::build(int column)");
+
+    COLUMN_t& col = mColumns[column];
+    QHash<QString, quint32> numbers;
+    col.ids.assign(mRows, 0);
+    col.dictionary.clear();
+    col.dictionary.append(QString());
+    numbers.insert(QString(), 0);
+    const QString tags[] = { TConfig::getTagInfo(), TConfig::getTagWarning(), TConfig::getTagError(), TConfig::getTagTrace(), TConfig::getTagDebug() };
+
+    for (int row = 0; row < mRows; ++row)
+    {
+        QString value;
+
+        if (column < mColumnCount)
+        {
+            QStandardItem *item = mModel->item(row, column);
+
+            if (!item)
+                continue;
+
+            QVariant collapsed = item->data(mCollapsedRole);    // An expanded cell is encoded like a collapsed one
+            value = collapsed.isNull() ? item->text() : collapsed.toString();
+        }
+        else
+        {
+            if (mRecords[row] < 0)
+                continue;
+
+            QStringList cells;
+
+            for (int c = 0; c < mColumnCount; ++c)
+            {
+                QStandardItem *item = mModel->item(row, c);
+
+                if (item)
+                    cells.append(item->text());
+            }
+
+            QString line = cells.join(' ');
+
+            for (const QString& tag : tags)
+            {
+                if (!tag.isEmpty() && line.contains(tag))
+                {
+                    value = tag;
+                    break;
+                }
+            }
+        }
+
+        auto iter = numbers.constFind(value);
+
+        if (iter == numbers.constEnd())
+        {
+            iter = numbers.insert(value, static_cast<quint32>(col.dictionary.size()));
+            col.dictionary.append(value);
+        }
+
+        col.ids[row] = iter.value();
+    }
+
+    col.built = true;
+    MSG_DEBUG("Column " << (column + 1) << " encoded with " << col.dictionary.size() << " distinct values");
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TCOLUMNSTORE_H
+#define TCOLUMNSTORE_H
+
+#include <QStringList>
+
+#include <vector>
+
+#include "trowbitmap.h"
+
+class QStandardItemModel;
+
+/**
+ * @brief The TColumnStore class
+ * Keeps the columns of the table dictionary encoded: every distinct value
+ * of a column is stored once in a dictionary and every row holds only the
+ * number of its value. A predicate is therefore evaluated once for every
+ * distinct value and the rows are tested by a lookup of their value number.
+ *
+ * The columns are encoded the first time they are used. Besides the
+ * columns of the model there is a pseudo column holding the level tag
+ * (see TConfig::getTagInfo() ...) found in a row.
+ */
+class TColumnStore
+{
+    public:
+        TColumnStore(const QStandardItemModel *model, int recordRole, int collapsedRole);
+
+        int rows() const { return mRows; }
+        int columns() const { return mColumnCount; }
+        int levelColumn() const { return mColumnCount; }
+        const std::vector<quint32>& ids(int column);
+        const QStringList& dictionary(int column);
+        const std::vector<qsizetype>& records() const { return mRecords; }
+        const TRowBitmap& filled() const { return mFilled; }
+
+    private:
+        typedef struct COLUMN_t
+        {
+            bool built{false};
+            std::vector<quint32> ids;           // The number of the value of every row
+            QStringList dictionary;             // The distinct values; the first is always empty
+        }COLUMN_t;
+
+        void build(int column);
+
+        const QStandardItemModel *mModel{nullptr};
+        int mCollapsedRole{0};                  // The role holding the text of an expanded cell before it was expanded
+        int mRows{0};
+        int mColumnCount{0};
+        std::vector<COLUMN_t> mColumns;         // The columns of the model and the level column
+        std::vector<qsizetype> mRecords;        // The record of every row (-1 = empty row)
+        TRowBitmap mFilled;                     // The rows which are not empty
+};
+
+#endif // TCOLUMNSTORE_H
@@ -51,11 +51,24 @@ int TConfig::mColumns{0};
 QStringList TConfig::mHeaders;
 QString TConfig::mColAligns;
 int TConfig::mColumnThreadID{0};
+QString TConfig::mRecordStart;
+QString TConfig::mLineRegex;
+TConfig::FORMAT_t TConfig::mFormat{TConfig::FORMAT_DELIMITED};
+int TConfig::mTimeColumn{0};
+QString TConfig::mTimeLayout;
 QList<TValueSelect::VALUES_t> TConfig::mValues;
+TConfig::FORMAT_BACKUP_t TConfig::mBackup;
+bool TConfig::mHaveBackup{false};
 
 QString TConfig::mLogfile;
 QString TConfig::mSourcePath;
 QString TConfig::mResultPath;
+int TConfig::mJsonSamples{1000};
+bool TConfig::mAutoDetect{true};
+bool TConfig::mSearchIndex{false};
+QString TConfig::mExceptionPattern;
+QString TConfig::mStackPattern;
+int TConfig::mContextLines{3};
 
 QString TConfig::mConfigFile;
 int TConfig::mLogLevel{0};
@@ -77,6 +90,7 @@ void TConfig::readConfig()
     try
     {
         char line[1024];
+        bool haveFormat = false;
 
         in.open(mConfigFile.toStdString());
 
@@ -202,6 +216,19 @@ void TConfig::readConfig()
                 mColumns = atoi(right.c_str());
             else if (caseCompare(left, "ColumnThreadID") == 0)
                 mColumnThreadID = atoi(right.c_str());
+            else if (caseCompare(left, "RecordStart") == 0)
+                mRecordStart = QString::fromStdString(right);
+            else if (caseCompare(left, "LineRegex") == 0)
+                mLineRegex = QString::fromStdString(right);
+            else if (caseCompare(left, "TimeColumn") == 0)
+                mTimeColumn = std::max(0, atoi(right.c_str()));
+            else if (caseCompare(left, "TimeLayout") == 0)
+                mTimeLayout = QString::fromStdString(right);
+            else if (caseCompare(left, "Format") == 0)
+            {
+                mFormat = stringToFormat(QString::fromStdString(right));
+                haveFormat = true;
+            }
             else if (caseCompare(left, "Headers") == 0)
             {
                 QString heads = QString::fromStdString(right);
@@ -264,6 +291,23 @@ void TConfig::readConfig()
                 else if (mLogLevel > 6)
                     mLogLevel = 6;
             }
+            else if (caseCompare(left, "JsonSamples") == 0)
+            {
+                mJsonSamples = atoi(right.c_str());
+
+                if (mJsonSamples < 1)
+                    mJsonSamples = 1000;
+            }
+            else if (caseCompare(left, "AutoDetect") == 0)
+                mAutoDetect = (caseCompare(right, "true") == 0 || atoi(right.c_str()) != 0);
+            else if (caseCompare(left, "SearchIndex") == 0)
+                mSearchIndex = (caseCompare(right, "true") == 0 || atoi(right.c_str()) != 0);
+            else if (caseCompare(left, "ExceptionPattern") == 0)
+                mExceptionPattern = QString::fromStdString(right);
+            else if (caseCompare(left, "StackPattern") == 0)
+                mStackPattern = QString::fromStdString(right);
+            else if (caseCompare(left, "ContextLines") == 0)
+                mContextLines = std::clamp(atoi(right.c_str()), 0, 100);
             else if (caseCompare(left, "Geometry") == 0)
             {
                 QString r = QString::fromStdString(right);
@@ -284,6 +328,9 @@ void TConfig::readConfig()
                 mLastSavePath = QString::fromStdString(right);
         }
 
+        if (!haveFormat && !mLineRegex.isEmpty())      // Written before the format was selectable
+            mFormat = FORMAT_REGEX;
+
         in.close();
 
         MSG_DEBUG("Block start:    " << mBlockEntry.toStdString());
@@ -301,6 +348,11 @@ void TConfig::readConfig()
         MSG_DEBUG("Delimeter:      " << mDelimenter.toStdString());
         MSG_DEBUG("Number columns: " << mColumns);
         MSG_DEBUG("Column threadID:" << mColumnThreadID);
+        MSG_DEBUG("Record start:   " << mRecordStart.toStdString());
+        MSG_DEBUG("Line regex:     " << mLineRegex.toStdString());
+        MSG_DEBUG("Format:         " << formatToString(mFormat).toStdString());
+        MSG_DEBUG("Time column:    " << mTimeColumn);
+        MSG_DEBUG("Time layout:    " << mTimeLayout.toStdString());
         QStringList::iterator iter;
         QString heads;
         bool first = true;
@@ -334,6 +386,12 @@ void TConfig::readConfig()
         MSG_DEBUG("Column aligns:  " << mColAligns.toStdString());
         MSG_DEBUG("Log file:       " << mLogfile.toStdString());
         MSG_DEBUG("Log level:      " << mLogLevel);
+        MSG_DEBUG("JSON samples:   " << mJsonSamples);
+        MSG_DEBUG("Auto detect:    " << (mAutoDetect ? "true" : "false"));
+        MSG_DEBUG("Search index:   " << (mSearchIndex ? "true" : "false"));
+        MSG_DEBUG("Exceptions:     " << mExceptionPattern.toStdString());
+        MSG_DEBUG("Stack pattern:  " << mStackPattern.toStdString());
+        MSG_DEBUG("Context lines:  " << mContextLines);
         MSG_DEBUG("Source path:    " << mSourcePath.toStdString());
         MSG_DEBUG("Result path:    " << mResultPath.toStdString());
         MSG_DEBUG("Last geometry:  " << mLastGeometry.x() << ", " << mLastGeometry.y() << ", " << mLastGeometry.width() << ", " << mLastGeometry.height());
@@ -381,10 +439,21 @@ void TConfig::saveConfig()
            << "Columns=" << mColumns << endl
            << "ColAligns=" << mColAligns.toStdString() << endl
            << "ColumnThreadID=" << mColumnThreadID << endl
+           << "RecordStart=" << mRecordStart.toStdString() << endl
+           << "LineRegex=" << mLineRegex.toStdString() << endl
+           << "Format=" << formatToString(mFormat).toStdString() << endl
+           << "TimeColumn=" << mTimeColumn << endl
+           << "TimeLayout=" << mTimeLayout.toStdString() << endl
            << "LogFile=" << mLogfile.toStdString() << endl
            << "SourcePath=" << mSourcePath.toStdString() << endl
            << "ResultPath=" << mResultPath.toStdString() << endl
            << "LogLevel=" << mLogLevel << endl
+           << "JsonSamples=" << mJsonSamples << endl
+           << "AutoDetect=" << (mAutoDetect ? "true" : "false") << endl
+           << "SearchIndex=" << (mSearchIndex ? "true" : "false") << endl
+           << "ExceptionPattern=" << mExceptionPattern.toStdString() << endl
+           << "StackPattern=" << mStackPattern.toStdString() << endl
+           << "ContextLines=" << mContextLines << endl
            << "Geometry=" << mLastGeometry.x() << "," << mLastGeometry.y() << "," << mLastGeometry.width() << "," << mLastGeometry.height() << endl
            << "LastOpenPath=" << mLastOpenPath.toStdString() << endl
            << "LastSavePath=" << mLastSavePath.toStdString() << endl;
@@ -523,6 +592,11 @@ void TConfig::initialize()
 
     mDelimenter = ",";
     mColumnThreadID = 8;
+    mRecordStart.clear();
+    mLineRegex.clear();
+    mFormat = FORMAT_DELIMITED;
+    mTimeColumn = 0;
+    mTimeLayout.clear();
     mLogLevel = 1;
 }
 
@@ -531,12 +605,14 @@ void TConfig::readProfile(const QString& pf)
     DECL_TRACER("TConfig::readProfile(const QString& pf)");
 
     ifstream in;
+    discardFormat();                                // The profile replaces a detected format
     initialize();
     getConfigFile();
 
     try
     {
         char line[1024];
+        bool haveFormat = false;
 
         in.open(pf.toStdString());
 
@@ -662,6 +738,19 @@ void TConfig::readProfile(const QString& pf)
                 mColumns = atoi(right.c_str());
             else if (caseCompare(left, "ColumnThreadID") == 0)
                 mColumnThreadID = atoi(right.c_str());
+            else if (caseCompare(left, "RecordStart") == 0)
+                mRecordStart = QString::fromStdString(right);
+            else if (caseCompare(left, "LineRegex") == 0)
+                mLineRegex = QString::fromStdString(right);
+            else if (caseCompare(left, "TimeColumn") == 0)
+                mTimeColumn = std::max(0, atoi(right.c_str()));
+            else if (caseCompare(left, "TimeLayout") == 0)
+                mTimeLayout = QString::fromStdString(right);
+            else if (caseCompare(left, "Format") == 0)
+            {
+                mFormat = stringToFormat(QString::fromStdString(right));
+                haveFormat = true;
+            }
             else if (caseCompare(left, "Headers") == 0)
             {
                 QString heads = QString::fromStdString(right);
@@ -714,6 +803,9 @@ void TConfig::readProfile(const QString& pf)
                 mColAligns = QString::fromStdString(right);
         }
 
+        if (!haveFormat && !mLineRegex.isEmpty())      // Written before the format was selectable
+            mFormat = FORMAT_REGEX;
+
         in.close();
     }
     catch (std::exception& e)
@@ -756,7 +848,12 @@ void TConfig::saveProfile(const QString& pf)
            << "Delimeter=" << mDelimenter.toStdString() << endl
            << "Columns=" << mColumns << endl
            << "ColAligns=" << mColAligns.toStdString() << endl
-           << "ColumnThreadID=" << mColumnThreadID << endl;
+           << "ColumnThreadID=" << mColumnThreadID << endl
+           << "RecordStart=" << mRecordStart.toStdString() << endl
+           << "LineRegex=" << mLineRegex.toStdString() << endl
+           << "Format=" << formatToString(mFormat).toStdString() << endl
+           << "TimeColumn=" << mTimeColumn << endl
+           << "TimeLayout=" << mTimeLayout.toStdString() << endl;
 
         of << "Headers=";
         QStringList::iterator iter;
@@ -799,6 +896,89 @@ void TConfig::saveProfile(const QString& pf)
     }
 }
 
+/**
+ * @brief TConfig::backupFormat
+ * Keeps the settings describing the format of a logfile. A format detected
+ * for one file replaces them only until restoreFormat() is called, so the
+ * configured format is what saveConfig() writes. If a backup exists
+ * already, it is kept.
+ */
+void TConfig::backupFormat()
+{
+    DECL_TRACER("TConfig::backupFormat()");
+
+    if (mHaveBackup)
+        return;
+
+    mBackup.format = mFormat;
+    mBackup.delimiter = mDelimenter;
+    mBackup.columns = mColumns;
+    mBackup.headers = mHeaders;
+    mBackup.colAligns = mColAligns;
+    mBackup.columnThreadID = mColumnThreadID;
+    mBackup.recordStart = mRecordStart;
+    mBackup.lineRegex = mLineRegex;
+    mBackup.timeColumn = mTimeColumn;
+    mBackup.timeLayout = mTimeLayout;
+    mBackup.values = mValues;
+    mHaveBackup = true;
+}
+
+/**
+ * @brief TConfig::restoreFormat
+ * Restores the settings kept by backupFormat(), if any.
+ */
+void TConfig::restoreFormat()
+{
+    DECL_TRACER("TConfig::restoreFormat()");
+
+    if (!mHaveBackup)
+        return;
+
+    mFormat = mBackup.format;
+    mDelimenter = mBackup.delimiter;
+    mColumns = mBackup.columns;
+    mHeaders = mBackup.headers;
+    mColAligns = mBackup.colAligns;
+    mColumnThreadID = mBackup.columnThreadID;
+    mRecordStart = mBackup.recordStart;
+    mLineRegex = mBackup.lineRegex;
+    mTimeColumn = mBackup.timeColumn;
+    mTimeLayout = mBackup.timeLayout;
+    mValues = mBackup.values;
+    mHaveBackup = false;
+}
+
+QString TConfig::formatToString(FORMAT_t format)
+{
+    switch(format)
+    {
+        case FORMAT_DELIMITED:  return "Delimited";
+        case FORMAT_REGEX:      return "Regex";
+        case FORMAT_LOGFMT:     return "Logfmt";
+        case FORMAT_SYSLOG:     return "Syslog";
+        case FORMAT_JSON:       return "JSON";
+    }
+
+    return "Delimited";
+}
+
+TConfig::FORMAT_t TConfig::stringToFormat(const QString& str)
+{
+    QString fmt = str.trimmed();
+
+    if (fmt.compare("Regex", Qt::CaseInsensitive) == 0)
+        return FORMAT_REGEX;
+    else if (fmt.compare("Logfmt", Qt::CaseInsensitive) == 0)
+        return FORMAT_LOGFMT;
+    else if (fmt.compare("Syslog", Qt::CaseInsensitive) == 0)
+        return FORMAT_SYSLOG;
+    else if (fmt.compare("JSON", Qt::CaseInsensitive) == 0)
+        return FORMAT_JSON;
+
+    return FORMAT_DELIMITED;
+}
+
 bool TConfig::isRemark(const string& line)
 {
     string::const_iterator iter;
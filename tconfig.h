@@ -28,10 +28,22 @@ class QColor;
 class TConfig
 {
     public:
+        typedef enum FORMAT_t
+        {
+            FORMAT_DELIMITED,                   // Columns separated by a delimiter
+            FORMAT_REGEX,                       // Columns defined by a regular expression
+            FORMAT_LOGFMT,                      // key=value pairs
+            FORMAT_SYSLOG,                      // RFC 5424 or RFC 3164
+            FORMAT_JSON                         // JSON records
+        }FORMAT_t;
+
         static void readConfig();
         static void saveConfig();
         static void readProfile(const QString& pf);
         static void saveProfile(const QString& pf);
+        static void backupFormat();
+        static void restoreFormat();
+        static void discardFormat() { mHaveBackup = false; }
 
         static QString& getBlockEntry() { return mBlockEntry; }
         static void setBlockEntry(const QString& str) { mBlockEntry = str; }
@@ -63,6 +75,30 @@ class TConfig
         static void setColAligns(const QString& str) { mColAligns = str; }
         static int getColumnThreadID() { return mColumnThreadID; }
         static void setColumnThreadID(int col) { mColumnThreadID = col; }
+        static QString& getRecordStart() { return mRecordStart; }
+        static void setRecordStart(const QString& str) { mRecordStart = str; }
+        static QString& getLineRegex() { return mLineRegex; }
+        static void setLineRegex(const QString& str) { mLineRegex = str; }
+        static int getTimeColumn() { return mTimeColumn; }
+        static void setTimeColumn(int col) { mTimeColumn = col; }
+        static QString& getTimeLayout() { return mTimeLayout; }
+        static void setTimeLayout(const QString& str) { mTimeLayout = str; }
+        static FORMAT_t getFormat() { return mFormat; }
+        static void setFormat(FORMAT_t format) { mFormat = format; }
+        static QString formatToString(FORMAT_t format);
+        static FORMAT_t stringToFormat(const QString& str);
+        static int getJsonSamples() { return mJsonSamples; }
+        static void setJsonSamples(int samples) { mJsonSamples = samples; }
+        static bool getAutoDetect() { return mAutoDetect; }
+        static void setAutoDetect(bool detect) { mAutoDetect = detect; }
+        static bool getSearchIndex() { return mSearchIndex; }
+        static void setSearchIndex(bool index) { mSearchIndex = index; }
+        static QString& getExceptionPattern() { return mExceptionPattern; }
+        static void setExceptionPattern(const QString& str) { mExceptionPattern = str; }
+        static QString& getStackPattern() { return mStackPattern; }
+        static void setStackPattern(const QString& str) { mStackPattern = str; }
+        static int getContextLines() { return mContextLines; }
+        static void setContextLines(int lines) { mContextLines = lines; }
 
         static QRect lastGeometry();
         static void setLastGeometry(const QRect &newLastGeometry);
@@ -104,6 +140,21 @@ class TConfig
         static std::string& trim(std::string &s);
 
     private:
+        typedef struct FORMAT_BACKUP_t
+        {
+            FORMAT_t format{FORMAT_DELIMITED};
+            QString delimiter;
+            int columns{0};
+            QStringList headers;
+            QString colAligns;
+            int columnThreadID{0};
+            QString recordStart;
+            QString lineRegex;
+            int timeColumn{0};
+            QString timeLayout;
+            QList<TValueSelect::VALUES_t> values;
+        }FORMAT_BACKUP_t;
+
         TConfig() {};
         static void initialize();
 
@@ -124,12 +175,25 @@ class TConfig
         static QStringList mHeaders;
         static QString mColAligns;
         static int mColumnThreadID;
+        static QString mRecordStart;
+        static QString mLineRegex;
+        static FORMAT_t mFormat;
+        static int mTimeColumn;
+        static QString mTimeLayout;
         static QList<TValueSelect::VALUES_t> mValues;
+        static FORMAT_BACKUP_t mBackup;         // The configured format while a detected one is used
+        static bool mHaveBackup;
 
         static QString mLogfile;
         static int mLogLevel;
         static QString mSourcePath;
         static QString mResultPath;
+        static int mJsonSamples;
+        static bool mAutoDetect;
+        static bool mSearchIndex;
+        static QString mExceptionPattern;
+        static QString mStackPattern;
+        static int mContextLines;
 
         static QString mConfigFile;
 
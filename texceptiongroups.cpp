@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QHash>
+
+#include <algorithm>
+
+#include "texceptiongroups.h"
+#include "tlogger.h"
+
+using std::vector;
+
+/**
+ * @brief TExceptionGroups::TExceptionGroups
+ * @param pattern       The regular expression finding an exception. The
+ * case is ignored. Empty = defaultPattern().
+ * @param stackPattern  The regular expression finding a line of a stack
+ * trace. Empty = defaultStackPattern().
+ * @param frames        The number of frames part of the fingerprint.
+ */
+TExceptionGroups::TExceptionGroups(const QString& pattern, const QString& stackPattern, int frames)
+    : mFrames(std::max(0, frames))
+{
+    DECL_TRACER("TExceptionGroups::TExceptionGroups(const QString& pattern, const QString& stackPattern, int frames)");
+
+    mPattern.setPattern(pattern.isEmpty() ? defaultPattern() : pattern);
+    mPattern.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    mStack.setPattern(stackPattern.isEmpty() ? defaultStackPattern() : stackPattern);
+
+    if (!mPattern.isValid())
+        mError = QString("Invalid exception pattern: %1").arg(mPattern.errorString());
+    else if (!mStack.isValid())
+        mError = QString("Invalid stack trace pattern: %1").arg(mStack.errorString());
+
+    mPattern.optimize();
+    mStack.optimize();
+}
+
+/**
+ * @brief TExceptionGroups::match
+ * Tests whether a message reports an exception.
+ *
+ * @param text  The message.
+ * @return The text matching the exception pattern or an empty string.
+ */
+QString TExceptionGroups::match(const QString& text) const
+{
+    if (!mError.isEmpty())
+        return QString();
+
+    QRegularExpressionMatch m = mPattern.match(text);
+    return m.hasMatch() ? m.captured(0) : QString();
+}
+
+bool TExceptionGroups::isFrame(QStringView line) const
+{
+    return mError.isEmpty() && mStack.match(line.toString()).hasMatch();
+}
+
+/**
+ * @brief TExceptionGroups::addException
+ * Adds the next exception. The exceptions must be added in order.
+ *
+ * @param row       The row of the exception.
+ * @param type      The text matching the exception pattern.
+ * @param message   The message of the exception.
+ * @param stack     The lines of the stack trace; only the first frames()
+ * lines are used.
+ * @param position  The time of the exception or, if the file has no
+ * times, its position (e.g. the row).
+ */
+void TExceptionGroups::addException(int row, const QString& type, const QString& message, const QStringList& stack, qint64 position)
+{
+    HIT_t hit;
+    hit.row = row;
+    hit.type = type;
+    hit.position = position;
+
+    for (qsizetype i = 0; i < stack.size() && i < mFrames; ++i)
+        hit.frames.append(normalizeFrame(stack[i]));
+
+    mMiner.addRow(row, message);
+    mHits.push_back(std::move(hit));
+}
+
+/**
+ * @brief TExceptionGroups::group
+ * Mines the templates of the messages and groups the exceptions by their
+ * fingerprint. The groups are sorted by their number of exceptions.
+ *
+ * @param bins  The number of time slots of the timeline of a group.
+ */
+void TExceptionGroups::group(int bins)
+{
+    DECL_TRACER("TExceptionGroups::group(int bins)");
+
+    mGroups.clear();
+
+    if (mHits.empty())
+        return;
+
+    mMiner.mine();
+    bins = std::max(1, bins);
+    qint64 first = mHits.front().position;
+    qint64 last = first;
+
+    for (const HIT_t& hit : mHits)
+    {
+        first = std::min(first, hit.position);
+        last = std::max(last, hit.position);
+    }
+
+    double scale = static_cast<double>(bins) / static_cast<double>(last - first + 1);
+    const vector<TTemplateMiner::TEMPLATE_t>& templates = mMiner.templates();
+    QHash<QString, size_t> groupOf;
+
+    for (const HIT_t& hit : mHits)
+    {
+        int id = mMiner.templateOf(hit.row);
+        QString message = (id >= 0) ? templates[static_cast<size_t>(id)].text : QString();
+        QString key = hit.type.toLower() + QChar('\n') + message + QChar('\n') + hit.frames.join(QChar('\n'));
+        auto iter = groupOf.constFind(key);
+        size_t idx = mGroups.size();
+
+        if (iter == groupOf.constEnd())
+        {
+            groupOf.insert(key, idx);
+            GROUP_t group;
+            group.type = hit.type;
+            group.message = message;
+            group.frames = hit.frames;
+            group.timeline.assign(static_cast<size_t>(bins), 0);
+            mGroups.push_back(std::move(group));
+        }
+        else
+            idx = iter.value();
+
+        GROUP_t& group = mGroups[idx];
+        size_t slot = static_cast<size_t>(static_cast<double>(hit.position - first) * scale);
+        group.rows.push_back(hit.row);
+        group.timeline[std::min(slot, group.timeline.size() - 1)]++;
+    }
+
+    std::stable_sort(mGroups.begin(), mGroups.end(), [](const GROUP_t& a, const GROUP_t& b) {
+        return a.rows.size() > b.rows.size();
+    });
+
+    MSG_DEBUG("Grouped " << mHits.size() << " exceptions into " << mGroups.size() << " groups");
+}
+
+/**
+ * @brief TExceptionGroups::normalizeFrame
+ * Removes the parts of a stack frame which differ between builds or runs:
+ * a leading "at", addresses and numbers (e.g. line numbers) are replaced
+ * by the wildcard of TTemplateMiner.
+ *
+ * @param line  A line of a stack trace.
+ * @return The normalized frame.
+ */
+QString TExceptionGroups::normalizeFrame(QStringView line)
+{
+    line = line.trimmed();
+
+    if (line.startsWith(QStringLiteral("at ")))
+        line = line.mid(3).trimmed();
+
+    const QString wild = TTemplateMiner::wildcard();
+    QString frame;
+    frame.reserve(line.size());
+    qsizetype pos = 0;
+
+    while (pos < line.size())
+    {
+        QChar ch = line[pos];
+
+        if (ch.unicode() < '0' || ch.unicode() > '9')
+        {
+            frame.append(ch);
+            pos++;
+            continue;
+        }
+
+        bool hex = (ch == '0' && pos + 1 < line.size() && (line[pos + 1] == 'x' || line[pos + 1] == 'X'));
+
+        if (hex)
+            pos += 2;
+
+        while (pos < line.size())
+        {
+            ushort c = line[pos].unicode();
+            ushort lower = c | 0x20;                                    // Lower case for the letters
+
+            if (!(c >= '0' && c <= '9') && !(hex && lower >= 'a' && lower <= 'f'))
+                break;
+
+            pos++;
+        }
+
+        frame.append(wild);
+    }
+
+    return frame;
+}
+
+/**
+ * @brief TExceptionGroups::sparkline
+ * Draws a timeline with block characters of growing height.
+ *
+ * @param timeline  The number of exceptions in every time slot.
+ * @return The timeline; a slot without exceptions is a space.
+ */
+QString TExceptionGroups::sparkline(const vector<quint32>& timeline)
+{
+    static const QChar bars[] = { QChar(0x2581), QChar(0x2582), QChar(0x2583), QChar(0x2584),
+                                  QChar(0x2585), QChar(0x2586), QChar(0x2587), QChar(0x2588) };
+
+    quint32 most = timeline.empty() ? 0 : *std::max_element(timeline.begin(), timeline.end());
+    QString line;
+    line.reserve(static_cast<qsizetype>(timeline.size()));
+
+    for (quint32 count : timeline)
+    {
+        if (count == 0)
+            line.append(QChar(' '));
+        else
+            line.append(bars[std::min<size_t>(7, (static_cast<size_t>(count) * 8 - 1) / most)]);
+    }
+
+    return line;
+}
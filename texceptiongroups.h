@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TEXCEPTIONGROUPS_H
+#define TEXCEPTIONGROUPS_H
+
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+
+#include <vector>
+
+#include "ttemplateminer.h"
+
+/**
+ * @brief The TExceptionGroups class
+ * Groups the exceptions of a logfile by a fingerprint. The fingerprint is
+ * made of the text matching the exception pattern (e.g. the class of the
+ * exception), the template of the message (see TTemplateMiner) and the
+ * first frames of the stack trace following the message. Numbers and
+ * addresses of the frames are masked, so the same exception thrown at the
+ * same place falls into one group, even if the line numbers of a frame or
+ * the values in the message differ.
+ *
+ * For every group the number of exceptions per time slot is counted, so a
+ * burst of exceptions can be seen at a glance.
+ */
+class TExceptionGroups
+{
+    public:
+        typedef struct GROUP_t
+        {
+            QString type;                       // The text matching the exception pattern
+            QString message;                    // The template of the message
+            QStringList frames;                 // The first frames of the stack trace, numbers masked
+            std::vector<int> rows;              // The rows of the exceptions in order
+            std::vector<quint32> timeline;      // The number of exceptions in every time slot
+        }GROUP_t;
+
+        explicit TExceptionGroups(const QString& pattern=QString(), const QString& stackPattern=QString(), int frames=3);
+
+        bool isValid() const { return mError.isEmpty(); }
+        const QString& errorString() const { return mError; }
+        QString match(const QString& text) const;
+        bool isFrame(QStringView line) const;
+        int frames() const { return mFrames; }
+
+        void addException(int row, const QString& type, const QString& message, const QStringList& stack, qint64 position);
+        void group(int bins=40);
+        const std::vector<GROUP_t>& groups() const { return mGroups; }
+        qint64 exceptions() const { return static_cast<qint64>(mHits.size()); }
+
+        static QString defaultPattern() { return QStringLiteral("[\\w.$]*exception[\\w.$]*"); }
+        static QString defaultStackPattern() { return QStringLiteral("^\\s*(at\\s|#\\d+\\s|File \")"); }
+        static QString normalizeFrame(QStringView line);
+        static QString sparkline(const std::vector<quint32>& timeline);
+
+    private:
+        typedef struct HIT_t
+        {
+            int row{0};                         // The row of the exception
+            QString type;                       // The text matching the exception pattern
+            QStringList frames;                 // The first frames of the stack trace
+            qint64 position{0};                 // The time or the position of the exception
+        }HIT_t;
+
+        QRegularExpression mPattern;            // Finds the exceptions
+        QRegularExpression mStack;              // Finds the lines of a stack trace
+        int mFrames{3};                         // The number of frames part of the fingerprint
+        QString mError;                         // The error of an invalid pattern
+        TTemplateMiner mMiner;                  // Finds the templates of the messages
+        std::vector<HIT_t> mHits;               // The exceptions found in order
+        std::vector<GROUP_t> mGroups;           // The groups, the largest first
+};
+
+#endif // TEXCEPTIONGROUPS_H
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QTreeWidgetItem>
+#include <QHeaderView>
+#include <QFontDatabase>
+
+#include "texceptionlist.h"
+#include "ui_texceptionlist.h"
+#include "tlogger.h"
+
+#define ROLE_GROUP      (Qt::UserRole + 1)      // The number of the group of an item
+#define ROLE_ROW        (Qt::UserRole + 2)      // The row of an exception (-1 = group)
+#define MAX_CHILDREN    10000                   // The most exceptions listed for a group
+
+TExceptionList::TExceptionList(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::TExceptionList)
+{
+    DECL_TRACER("TExceptionList::TExceptionList(QWidget *parent)");
+
+    ui->setupUi(this);
+    ui->plainTextEditContext->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    ui->treeWidgetGroups->header()->setSectionResizeMode(2, QHeaderView::Stretch);
+}
+
+TExceptionList::~TExceptionList()
+{
+    DECL_TRACER("TExceptionList::~TExceptionList()");
+
+    delete ui;
+}
+
+/**
+ * @brief TExceptionList::setGroups
+ * Fills the tree with the groups. Every group gets a placeholder child, so
+ * it can be expanded; the exceptions are added on expansion.
+ *
+ * @param groups    The groups after grouping.
+ * @param rowValue  Returns the value shown for a row of the log, e.g. its
+ * time or its line number.
+ * @param context   Returns the lines around a row of the log.
+ */
+void TExceptionList::setGroups(const TExceptionGroups& groups, std::function<QVariant(int row)> rowValue, std::function<QString(int row)> context)
+{
+    DECL_TRACER("TExceptionList::setGroups(const TExceptionGroups& groups, std::function<QVariant(int row)> rowValue, std::function<QString(int row)> context)");
+
+    QTreeWidget *tree = ui->treeWidgetGroups;
+    QFont fixed = ui->plainTextEditContext->font();                     // The timelines need a fixed font
+    mRowValue = rowValue;
+    mContext = context;
+    mGroups = groups.groups();
+    tree->clear();
+
+    for (size_t idx = 0; idx < mGroups.size(); ++idx)
+    {
+        const TExceptionGroups::GROUP_t& group = mGroups[idx];
+        QTreeWidgetItem *item = new QTreeWidgetItem(tree);
+        item->setData(0, Qt::DisplayRole, static_cast<qlonglong>(group.rows.size()));
+        item->setData(0, ROLE_GROUP, static_cast<int>(idx));
+        item->setData(0, ROLE_ROW, -1);
+        item->setTextAlignment(0, Qt::AlignRight | Qt::AlignVCenter);
+        item->setText(1, TExceptionGroups::sparkline(group.timeline));
+        item->setFont(1, fixed);
+        item->setText(2, group.type + ": " + group.message);
+        item->setToolTip(2, group.frames.join("\n"));
+        item->setData(3, Qt::DisplayRole, rowValue(group.rows.front()));
+        item->setData(4, Qt::DisplayRole, rowValue(group.rows.back()));
+        new QTreeWidgetItem(item);                                      // Placeholder until the group is expanded
+    }
+
+    tree->resizeColumnToContents(1);
+    ui->labelSummary->setText(tr("%1 exceptions in %2 groups.").arg(groups.exceptions()).arg(groups.groups().size()));
+}
+
+void TExceptionList::on_treeWidgetGroups_itemExpanded(QTreeWidgetItem *item)
+{
+    DECL_TRACER("TExceptionList::on_treeWidgetGroups_itemExpanded(QTreeWidgetItem *item)");
+
+    if (!item || item->parent() || item->childCount() != 1 || !item->child(0)->data(0, ROLE_ROW).isNull())
+        return;                                                         // Not a group or already filled
+
+    size_t group = static_cast<size_t>(item->data(0, ROLE_GROUP).toInt());
+
+    if (group >= mGroups.size())
+        return;
+
+    delete item->takeChild(0);
+    const std::vector<int>& rows = mGroups[group].rows;
+    size_t count = std::min<size_t>(rows.size(), MAX_CHILDREN);
+    QList<QTreeWidgetItem *> children;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        QTreeWidgetItem *child = new QTreeWidgetItem;
+        child->setData(0, Qt::DisplayRole, rows[i] + 1);
+        child->setData(0, ROLE_ROW, rows[i]);
+        child->setTextAlignment(0, Qt::AlignRight | Qt::AlignVCenter);
+        child->setData(3, Qt::DisplayRole, mRowValue(rows[i]));
+        children.append(child);
+    }
+
+    if (rows.size() > count)
+    {
+        QTreeWidgetItem *more = new QTreeWidgetItem;
+        more->setText(2, tr("... %1 more").arg(rows.size() - count));
+        more->setData(0, ROLE_ROW, -1);
+        children.append(more);
+    }
+
+    item->addChildren(children);
+}
+
+void TExceptionList::on_treeWidgetGroups_currentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *)
+{
+    DECL_TRACER("TExceptionList::on_treeWidgetGroups_currentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *)");
+
+    if (!current)
+        return;
+
+    QVariant row = current->data(0, ROLE_ROW);
+
+    if (!current->parent())                                             // A group shows its fingerprint
+    {
+        size_t group = static_cast<size_t>(current->data(0, ROLE_GROUP).toInt());
+
+        if (group >= mGroups.size())
+            return;
+
+        const TExceptionGroups::GROUP_t& g = mGroups[group];
+        QString text = g.type + ": " + g.message;
+
+        if (g.frames.isEmpty())
+            text.append("\n" + tr("(no stack trace)"));
+        else
+            text.append("\n    " + g.frames.join("\n    "));
+
+        ui->plainTextEditContext->setPlainText(text);
+        return;
+    }
+
+    if (row.isNull() || row.toInt() < 0)
+        return;
+
+    ui->plainTextEditContext->setPlainText(mContext ? mContext(row.toInt()) : QString());
+    emit rowSelected(row.toInt());
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TEXCEPTIONLIST_H
+#define TEXCEPTIONLIST_H
+
+#include <QDialog>
+
+#include <vector>
+#include <functional>
+
+#include "texceptiongroups.h"
+
+namespace Ui {
+    class TExceptionList;
+}
+
+class QTreeWidgetItem;
+
+/**
+ * @brief The TExceptionList class
+ * Shows the groups of exceptions found by TExceptionGroups with their counts
+ * and timelines. The exceptions of a group are added when the group is
+ * expanded. Selecting an exception emits rowSelected() and shows the lines
+ * around it. The lines are fetched only when an exception is selected.
+ */
+class TExceptionList : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        explicit TExceptionList(QWidget *parent = nullptr);
+        ~TExceptionList();
+
+        void setGroups(const TExceptionGroups& groups, std::function<QVariant(int row)> rowValue, std::function<QString(int row)> context);
+
+    signals:
+        void rowSelected(int row);
+
+    private slots:
+        void on_treeWidgetGroups_itemExpanded(QTreeWidgetItem *item);
+        void on_treeWidgetGroups_currentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous);
+
+    private:
+        Ui::TExceptionList *ui;
+        std::vector<TExceptionGroups::GROUP_t> mGroups; // The groups shown
+        std::function<QVariant(int row)> mRowValue;     // Returns the time or line number of a row
+        std::function<QString(int row)> mContext;       // Returns the lines around a row
+};
+
+#endif // TEXCEPTIONLIST_H
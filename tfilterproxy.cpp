@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include "tfilterproxy.h"
+#include "tlogger.h"
+
+TFilterProxy::TFilterProxy(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    DECL_TRACER("TFilterProxy::TFilterProxy(QObject *parent)");
+}
+
+/**
+ * @brief TFilterProxy::setRows
+ * Sets the rows to show.
+ *
+ * @param rows  The rows of the source model.
+ */
+void TFilterProxy::setRows(TRowBitmap&& rows)
+{
+    DECL_TRACER("TFilterProxy::setRows(TRowBitmap&& rows)");
+
+    mRows = std::move(rows);
+    mFiltered = true;
+    invalidateFilter();
+}
+
+void TFilterProxy::clearRows()
+{
+    DECL_TRACER("TFilterProxy::clearRows()");
+
+    if (!mFiltered)
+        return;
+
+    mRows.clear();
+    mFiltered = false;
+    invalidateFilter();
+}
+
+bool TFilterProxy::acceptsRow(int row) const
+{
+    if (!mFiltered)
+        return true;
+
+    return row >= 0 && mRows.contains(static_cast<quint32>(row));
+}
+
+bool TFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    return acceptsRow(sourceRow);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TFILTERPROXY_H
+#define TFILTERPROXY_H
+
+#include <QSortFilterProxyModel>
+
+#include "trowbitmap.h"
+
+/**
+ * @brief The TFilterProxy class
+ * Shows only the rows of the source model contained in a row set. The set
+ * is the result of a filter query (see TFilterQuery). Without a set all
+ * rows are shown.
+ */
+class TFilterProxy : public QSortFilterProxyModel
+{
+        Q_OBJECT
+
+    public:
+        explicit TFilterProxy(QObject *parent = nullptr);
+
+        void setRows(TRowBitmap&& rows);
+        void clearRows();
+        bool isFiltered() const { return mFiltered; }
+        bool acceptsRow(int row) const;
+        const TRowBitmap& rows() const { return mRows; }
+
+    protected:
+        bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+    private:
+        TRowBitmap mRows;                       // The rows of the source model to show
+        bool mFiltered{false};
+};
+
+#endif // TFILTERPROXY_H
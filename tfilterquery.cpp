@@ -0,0 +1,689 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include "tfilterquery.h"
+#include "tcolumnstore.h"
+#include "tlogindex.h"
+#include "ttimeparser.h"
+#include "tconfig.h"
+#include "tlogger.h"
+
+using std::vector;
+
+namespace
+{
+    // The names of the columns known without a title. They are the same as
+    // the field names of the built-in formats (see TLineParser).
+    const vector<QStringList> columnSynonyms = {
+        { "time", "timestamp", "ts", "date", "datetime", "@timestamp" },
+        { "level", "lvl", "severity", "loglevel", "priority" },
+        { "msg", "message", "content", "text" },
+        { "thread", "tid", "threadid", "thread_id" }
+    };
+
+    enum { SYN_TIME, SYN_LEVEL, SYN_MESSAGE, SYN_THREAD };
+
+    const qint64 usecDay = 86400LL * 1000000LL;
+
+    QString normalized(const QString& name)
+    {
+        QString key = name.toLower();
+        key.remove(' ');
+        return key;
+    }
+}
+
+TFilterQuery::TFilterQuery(TColumnStore *store, const TLogIndex *index)
+    : mStore(store),
+      mIndex(index)
+{
+    DECL_TRACER("TFilterQuery::TFilterQuery(TColumnStore *store, const TLogIndex *index)");
+}
+
+/**
+ * @brief TFilterQuery::parse
+ * Compiles a query.
+ *
+ * @param query The query.
+ * @return If the query is not valid, FALSE is returned and errorString()
+ * describes the error.
+ */
+bool TFilterQuery::parse(const QString& query)
+{
+    DECL_TRACER("TFilterQuery::parse(const QString& query)");
+
+    mError.clear();
+    mNodes.clear();
+    mToken = 0;
+    mRoot = -1;
+
+    if (!mStore)
+    {
+        mError = "No table loaded";
+        return false;
+    }
+
+    if (!tokenize(query))
+        return false;
+
+    mRoot = parseOr();
+
+    if (mRoot >= 0 && mTokens[mToken].type != TK_END)
+    {
+        mError = QString("Unexpected \"%1\" at offset %2").arg(mTokens[mToken].text).arg(mTokens[mToken].pos);
+        mRoot = -1;
+    }
+
+    return mRoot >= 0;
+}
+
+/**
+ * @brief TFilterQuery::evaluate
+ * Evaluates the compiled query for all rows.
+ *
+ * @param rows  Receives the rows matching the query.
+ */
+void TFilterQuery::evaluate(TRowBitmap& rows)
+{
+    DECL_TRACER("TFilterQuery::evaluate(TRowBitmap& rows)");
+
+    rows.clear();
+
+    if (mRoot < 0)
+        return;
+
+    rows = evaluate(mRoot);
+    rows &= mStore->filled();                                   // Empty rows never match
+}
+
+bool TFilterQuery::tokenize(const QString& query)
+{
+    DECL_TRACER("TFilterQuery::tokenize(const QString& query)");
+
+    mTokens.clear();
+    const QString specials = "()=,!~<>'\"";
+    qsizetype pos = 0, len = query.size();
+
+    while (pos < len)
+    {
+        QChar ch = query[pos];
+
+        if (ch.isSpace())
+        {
+            pos++;
+            continue;
+        }
+
+        TOKEN_t token;
+        token.pos = pos;
+
+        if (ch == '(' || ch == ')' || ch == ',')
+        {
+            token.type = (ch == '(') ? TK_OPEN : (ch == ')') ? TK_CLOSE : TK_COMMA;
+            token.text = ch;
+            pos++;
+        }
+        else if (ch == '\'' || ch == '"')                   // A quoted value; a backslash escapes the next character
+        {
+            token.type = TK_STRING;
+            pos++;
+
+            while (pos < len && query[pos] != ch)
+            {
+                if (query[pos] == '\\' && pos + 1 < len)
+                    pos++;
+
+                token.text.append(query[pos++]);
+            }
+
+            if (pos >= len)
+            {
+                mError = QString("Missing closing quote of the value at offset %1").arg(token.pos);
+                return false;
+            }
+
+            pos++;
+        }
+        else if (ch == '=' || ch == '!' || ch == '~' || ch == '<' || ch == '>')
+        {
+            token.type = TK_OPERATOR;
+            token.text = ch;
+            pos++;
+
+            if (pos < len && (query[pos] == '=' || (ch == '!' && query[pos] == '~')))
+                token.text.append(query[pos++]);
+
+            if (token.text == "!")
+            {
+                mError = QString("Unknown operator at offset %1").arg(token.pos);
+                return false;
+            }
+        }
+        else
+        {
+            token.type = TK_WORD;
+
+            while (pos < len && !query[pos].isSpace() && !specials.contains(query[pos]))
+                token.text.append(query[pos++]);
+        }
+
+        mTokens.push_back(token);
+    }
+
+    TOKEN_t end;
+    end.pos = len;
+    mTokens.push_back(end);
+    return true;
+}
+
+bool TFilterQuery::isKeyword(const char *word) const
+{
+    const TOKEN_t& token = mTokens[mToken];
+    return token.type == TK_WORD && token.text.compare(QLatin1String(word), Qt::CaseInsensitive) == 0;
+}
+
+int TFilterQuery::addNode(const NODE_t& node)
+{
+    mNodes.push_back(node);
+    return static_cast<int>(mNodes.size()) - 1;
+}
+
+int TFilterQuery::parseOr()
+{
+    int left = parseAnd();
+
+    while (left >= 0 && isKeyword("or"))
+    {
+        mToken++;
+        int right = parseAnd();
+
+        if (right < 0)
+            return -1;
+
+        NODE_t node;
+        node.op = OP_OR;
+        node.left = left;
+        node.right = right;
+        left = addNode(node);
+    }
+
+    return left;
+}
+
+int TFilterQuery::parseAnd()
+{
+    int left = parseFactor();
+
+    while (left >= 0 && isKeyword("and"))
+    {
+        mToken++;
+        int right = parseFactor();
+
+        if (right < 0)
+            return -1;
+
+        NODE_t node;
+        node.op = OP_AND;
+        node.left = left;
+        node.right = right;
+        left = addNode(node);
+    }
+
+    return left;
+}
+
+int TFilterQuery::parseFactor()
+{
+    if (isKeyword("not"))
+    {
+        mToken++;
+        int operand = parseFactor();
+
+        if (operand < 0)
+            return -1;
+
+        NODE_t node;
+        node.op = OP_NOT;
+        node.left = operand;
+        return addNode(node);
+    }
+
+    if (mTokens[mToken].type == TK_OPEN)
+    {
+        mToken++;
+        int inner = parseOr();
+
+        if (inner < 0)
+            return -1;
+
+        if (mTokens[mToken].type != TK_CLOSE)
+        {
+            mError = QString("Missing closing parenthesis at offset %1").arg(mTokens[mToken].pos);
+            return -1;
+        }
+
+        mToken++;
+        return inner;
+    }
+
+    return parseComparison();
+}
+
+/**
+ * @brief TFilterQuery::parseComparison
+ * Compiles a comparison: column operator value or column in (values).
+ *
+ * @return The node of the comparison or -1 on error.
+ */
+int TFilterQuery::parseComparison()
+{
+    const TOKEN_t& name = mTokens[mToken];
+
+    if (name.type != TK_WORD && name.type != TK_STRING)
+    {
+        mError = (name.type == TK_END) ? QString("Incomplete query") : QString("Expected a column instead of \"%1\" at offset %2").arg(name.text).arg(name.pos);
+        return -1;
+    }
+
+    NODE_t node;
+    node.column = resolveColumn(name.text);
+
+    if (node.column < 0)
+    {
+        mError = QString("Unknown column \"%1\" at offset %2").arg(name.text).arg(name.pos);
+        return -1;
+    }
+
+    mToken++;
+    const TOKEN_t& op = mTokens[mToken];
+
+    if (isKeyword("in"))
+    {
+        mToken++;
+
+        if (mTokens[mToken].type != TK_OPEN)
+        {
+            mError = QString("Expected \"(\" after \"in\" at offset %1").arg(mTokens[mToken].pos);
+            return -1;
+        }
+
+        do
+        {
+            mToken++;
+            const TOKEN_t& value = mTokens[mToken];
+
+            if (value.type != TK_WORD && value.type != TK_STRING)
+            {
+                mError = QString("Expected a value at offset %1").arg(value.pos);
+                return -1;
+            }
+
+            node.values.append(value.text);
+            mToken++;
+        }
+        while (mTokens[mToken].type == TK_COMMA);
+
+        if (mTokens[mToken].type != TK_CLOSE)
+        {
+            mError = QString("Missing closing parenthesis at offset %1").arg(mTokens[mToken].pos);
+            return -1;
+        }
+
+        mToken++;
+        node.cmp = CMP_EQUAL;
+    }
+    else if (op.type == TK_OPERATOR)
+    {
+        if (op.text == "=" || op.text == "==")
+            node.cmp = CMP_EQUAL;
+        else if (op.text == "!=")
+            node.cmp = CMP_NOT_EQUAL;
+        else if (op.text == "~")
+            node.cmp = CMP_MATCH;
+        else if (op.text == "!~")
+            node.cmp = CMP_NOT_MATCH;
+        else if (op.text == "<")
+            node.cmp = CMP_LESS;
+        else if (op.text == "<=")
+            node.cmp = CMP_LESS_EQUAL;
+        else if (op.text == ">")
+            node.cmp = CMP_GREATER;
+        else if (op.text == ">=")
+            node.cmp = CMP_GREATER_EQUAL;
+        else
+        {
+            mError = QString("Unknown operator \"%1\" at offset %2").arg(op.text).arg(op.pos);
+            return -1;
+        }
+
+        mToken++;
+        const TOKEN_t& value = mTokens[mToken];
+
+        if (value.type != TK_WORD && value.type != TK_STRING)
+        {
+            mError = QString("Expected a value at offset %1").arg(value.pos);
+            return -1;
+        }
+
+        node.values.append(value.text);
+        mToken++;
+    }
+    else
+    {
+        mError = QString("Expected an operator at offset %1").arg(op.pos);
+        return -1;
+    }
+
+    if (node.cmp == CMP_MATCH || node.cmp == CMP_NOT_MATCH)
+    {
+        node.regex.setPattern(node.values[0]);
+        node.regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+
+        if (!node.regex.isValid())
+        {
+            mError = QString("%1 at offset %2 of the expression \"%3\"").arg(node.regex.errorString()).arg(node.regex.patternErrorOffset()).arg(node.values[0]);
+            return -1;
+        }
+
+        node.regex.optimize();
+    }
+    else if (node.cmp >= CMP_LESS && node.column == TConfig::getTimeColumn() - 1 && mIndex && mIndex->hasTimes())
+        node.time = parseTime(node.values[0], &node.usec, &node.timeOfDay);
+    else if (node.column == mStore->levelColumn())                  // Allow the names of the levels instead of the tags
+    {
+        for (QString& value : node.values)
+        {
+            QString level = value.toLower();
+
+            if (level == "info" || level == "information")
+                value = TConfig::getTagInfo();
+            else if (level == "warn" || level == "warning")
+                value = TConfig::getTagWarning();
+            else if (level == "error")
+                value = TConfig::getTagError();
+            else if (level == "trace")
+                value = TConfig::getTagTrace();
+            else if (level == "debug")
+                value = TConfig::getTagDebug();
+        }
+    }
+
+    return addNode(node);
+}
+
+/**
+ * @brief TFilterQuery::resolveColumn
+ * Finds the column of a name. The titles of the columns are tested first.
+ * Then the names known without a title are mapped to the configured
+ * columns.
+ *
+ * @param name  The name of the column.
+ * @return The column, TColumnStore::levelColumn() or -1 if the name is
+ * not known.
+ */
+int TFilterQuery::resolveColumn(const QString& name)
+{
+    DECL_TRACER("TFilterQuery::resolveColumn(const QString& name)");
+
+    QString key = normalized(name);
+    int columns = mStore->columns();
+    QStringList headers = TConfig::headers();
+
+    if (key.startsWith('#'))
+    {
+        bool ok = false;
+        int col = key.mid(1).toInt(&ok);
+        return (ok && col >= 1 && col <= columns) ? col - 1 : -1;
+    }
+
+    for (int i = 0; i < headers.size() && i < columns; ++i)
+    {
+        if (normalized(headers[i]) == key)
+            return i;
+    }
+
+    for (size_t grp = 0; grp < columnSynonyms.size(); ++grp)
+    {
+        if (!columnSynonyms[grp].contains(key))
+            continue;
+
+        for (int i = 0; i < headers.size() && i < columns; ++i)    // A title may be a synonym
+        {
+            if (columnSynonyms[grp].contains(normalized(headers[i])))
+                return i;
+        }
+
+        int col = -1;
+
+        switch (grp)
+        {
+            case SYN_TIME:      col = TConfig::getTimeColumn() - 1; break;
+            case SYN_LEVEL:     return mStore->levelColumn();
+            case SYN_MESSAGE:   col = columns - 1; break;
+            case SYN_THREAD:    col = TConfig::getColumnThreadID() - 1; break;
+        }
+
+        return (col >= 0 && col < columns) ? col : -1;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief TFilterQuery::parseTime
+ * Converts the value of a comparison with the time column. The configured
+ * layout, ISO 8601, epoch values and a time of the day are accepted.
+ *
+ * @param text      The value.
+ * @param usec      Receives the timestamp.
+ * @param timeOfDay Receives TRUE if the value contains only a time.
+ * @return If the value is no timestamp, FALSE is returned.
+ */
+bool TFilterQuery::parseTime(const QString& text, qint64 *usec, bool *timeOfDay)
+{
+    DECL_TRACER("TFilterQuery::parseTime(const QString& text, qint64 *usec, bool *timeOfDay)");
+
+    const QString layouts[] = { TConfig::getTimeLayout(), QString(), "%H:%M:%S.%f", "%H:%M:%S", "%H:%M" };
+    const int timeOnly = 2;
+
+    for (int layout = 0; layout < 5; ++layout)
+    {
+        if (layout == 0 && layouts[0].isEmpty())
+            continue;
+
+        TTimeParser parser(layouts[layout]);
+        qint64 value = parser.parse(text.trimmed());
+
+        if (value != TTimeParser::INVALID)
+        {
+            *usec = value;
+            *timeOfDay = (layout >= timeOnly);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief TFilterQuery::matches
+ * Compares a value of a column.
+ *
+ * @param node  The comparison.
+ * @param value The value of the column.
+ * @return TRUE if the value matches.
+ */
+bool TFilterQuery::matches(const NODE_t& node, const QString& value) const
+{
+    if (node.cmp == CMP_EQUAL || node.cmp == CMP_NOT_EQUAL)
+    {
+        QString trimmed = value.trimmed();
+        bool level = (node.column == mStore->levelColumn());
+        bool equal = false;
+
+        for (const QString& v : node.values)
+        {
+            if (level ? (!trimmed.isEmpty() && trimmed.contains(v, Qt::CaseInsensitive)) : trimmed.compare(v, Qt::CaseInsensitive) == 0)
+            {
+                equal = true;
+                break;
+            }
+        }
+
+        return (node.cmp == CMP_EQUAL) ? equal : !equal;
+    }
+
+    if (node.cmp == CMP_MATCH)
+        return node.regex.match(value).hasMatch();
+
+    if (node.cmp == CMP_NOT_MATCH)
+        return !node.regex.match(value).hasMatch();
+
+    QString trimmed = value.trimmed();
+    bool okValue = false, okOther = false;
+    double number = trimmed.toDouble(&okValue);
+    double other = node.values[0].toDouble(&okOther);
+    int diff = (okValue && okOther) ? ((number < other) ? -1 : (number > other) ? 1 : 0) : trimmed.compare(node.values[0], Qt::CaseInsensitive);
+
+    switch (node.cmp)
+    {
+        case CMP_LESS:          return diff < 0;
+        case CMP_LESS_EQUAL:    return diff <= 0;
+        case CMP_GREATER:       return diff > 0;
+        case CMP_GREATER_EQUAL: return diff >= 0;
+        default:                return false;
+    }
+}
+
+TRowBitmap TFilterQuery::evaluate(int node)
+{
+    const NODE_t& n = mNodes[node];
+    TRowBitmap result;
+
+    switch (n.op)
+    {
+        case OP_COMPARE:
+            result = n.time ? compareTime(n) : compareColumn(n);
+        break;
+
+        case OP_NOT:
+            result = evaluate(n.left).flipped(static_cast<quint32>(mStore->rows()));
+        break;
+
+        case OP_AND:
+            result = evaluate(n.left);
+
+            if (!result.isEmpty())                              // Nothing to intersect with
+                result &= evaluate(n.right);
+        break;
+
+        case OP_OR:
+            result = evaluate(n.left);
+            result |= evaluate(n.right);
+        break;
+    }
+
+    return result;
+}
+
+/**
+ * @brief TFilterQuery::compareColumn
+ * Evaluates a comparison for every distinct value of the column and sets
+ * the bits of the rows holding a matching value.
+ *
+ * @param node  The comparison.
+ * @return The matching rows.
+ */
+TRowBitmap TFilterQuery::compareColumn(const NODE_t& node)
+{
+    const QStringList& dictionary = mStore->dictionary(node.column);
+    const vector<quint32>& ids = mStore->ids(node.column);
+    vector<quint8> hit(dictionary.size());
+
+    for (qsizetype i = 0; i < dictionary.size(); ++i)
+        hit[i] = matches(node, dictionary[i]) ? 1 : 0;
+
+    size_t rows = static_cast<size_t>(mStore->rows());
+    vector<quint64> bitmap((rows + 63) / 64, 0);
+
+    for (size_t w = 0; w < bitmap.size(); ++w)
+    {
+        size_t first = w * 64;
+        size_t count = std::min(static_cast<size_t>(64), rows - first);
+        const quint32 *id = ids.data() + first;
+        quint64 bits = 0;
+
+        for (size_t b = 0; b < count; ++b)
+            bits |= static_cast<quint64>(hit[id[b]]) << b;
+
+        bitmap[w] = bits;
+    }
+
+    return TRowBitmap::fromWords(bitmap);
+}
+
+/**
+ * @brief TFilterQuery::compareTime
+ * Compares the timestamps of the records with the time of a comparison.
+ * Records without a valid timestamp never match.
+ *
+ * @param node  The comparison.
+ * @return The matching rows.
+ */
+TRowBitmap TFilterQuery::compareTime(const NODE_t& node)
+{
+    const vector<qsizetype>& records = mStore->records();
+    size_t rows = static_cast<size_t>(mStore->rows());
+    vector<quint64> bitmap((rows + 63) / 64, 0);
+
+    for (size_t w = 0; w < bitmap.size(); ++w)
+    {
+        size_t first = w * 64;
+        size_t count = std::min(static_cast<size_t>(64), rows - first);
+        quint64 bits = 0;
+
+        for (size_t b = 0; b < count; ++b)
+        {
+            qsizetype record = records[first + b];
+            qint64 usec = (record >= 0 && record < mIndex->size()) ? mIndex->time(record) : TTimeParser::INVALID;
+
+            if (usec == TTimeParser::INVALID)
+                continue;
+
+            if (node.timeOfDay)
+                usec = ((usec % usecDay) + usecDay) % usecDay;
+
+            bool match = false;
+
+            switch (node.cmp)
+            {
+                case CMP_LESS:          match = usec < node.usec; break;
+                case CMP_LESS_EQUAL:    match = usec <= node.usec; break;
+                case CMP_GREATER:       match = usec > node.usec; break;
+                case CMP_GREATER_EQUAL: match = usec >= node.usec; break;
+                default:                break;
+            }
+
+            if (match)
+                bits |= 1ULL << b;
+        }
+
+        bitmap[w] = bits;
+    }
+
+    return TRowBitmap::fromWords(bitmap);
+}
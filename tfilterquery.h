@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TFILTERQUERY_H
+#define TFILTERQUERY_H
+
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+
+#include <vector>
+
+#include "trowbitmap.h"
+
+class TColumnStore;
+class TLogIndex;
+
+/**
+ * @brief The TFilterQuery class
+ * Compiles a filter query and evaluates it into the set of the rows of the
+ * table. A query is made of comparisons combined with "and", "or", "not"
+ * and parentheses:
+ *
+ *   level in (ERR,WRN) and thread = 7f3a and msg ~ 'timeout' and time > 14:00
+ *
+ * A comparison consists of a column, an operator and a value. The column is
+ * the title of a column (blanks removed, case is ignored), #n for the n-th
+ * column or one of the names "time", "level", "thread" and "msg" (and their
+ * synonyms) if no title matches. "level" is the tag found in a row, if
+ * there is no such column.
+ *
+ *   =, !=          The trimmed value equals (not) one of the values
+ *   in (a, b, ...) The trimmed value equals one of the values
+ *   ~, !~          The value matches (not) a regular expression
+ *   <, <=, >, >=   Compares numbers, timestamps or else text
+ *
+ * The case is ignored by all operators. Values containing blanks or
+ * operators are enclosed in quotes (' or "). The timestamps of the time
+ * column are compared as time; a value with only a time of the day is
+ * compared with the time of the day of the rows.
+ *
+ * A comparison is evaluated once for every distinct value of a column (see
+ * TColumnStore). Then the rows are tested in words of 64 rows by looking
+ * up the result of their value. The words are compressed into a row set
+ * (see TRowBitmap) and the sets of the comparisons are combined.
+ */
+class TFilterQuery
+{
+    public:
+        TFilterQuery(TColumnStore *store, const TLogIndex *index);
+
+        bool parse(const QString& query);
+        QString& errorString() { return mError; }
+        void evaluate(TRowBitmap& rows);
+
+    private:
+        typedef enum OP_t
+        {
+            OP_COMPARE,
+            OP_AND,
+            OP_OR,
+            OP_NOT
+        }OP_t;
+
+        typedef enum CMP_t
+        {
+            CMP_EQUAL,
+            CMP_NOT_EQUAL,
+            CMP_MATCH,
+            CMP_NOT_MATCH,
+            CMP_LESS,
+            CMP_LESS_EQUAL,
+            CMP_GREATER,
+            CMP_GREATER_EQUAL
+        }CMP_t;
+
+        typedef enum TOKEN_TYPE_t
+        {
+            TK_END,
+            TK_WORD,
+            TK_STRING,
+            TK_OPERATOR,
+            TK_OPEN,
+            TK_CLOSE,
+            TK_COMMA
+        }TOKEN_TYPE_t;
+
+        typedef struct TOKEN_t
+        {
+            TOKEN_TYPE_t type{TK_END};
+            QString text;
+            qsizetype pos{0};                   // Position in the query
+        }TOKEN_t;
+
+        typedef struct NODE_t
+        {
+            OP_t op{OP_COMPARE};
+            int left{-1};                       // The operands of and, or and not
+            int right{-1};
+            int column{-1};                     // The column to compare
+            CMP_t cmp{CMP_EQUAL};
+            QStringList values;                 // The values to compare with
+            QRegularExpression regex;           // The expression of ~ and !~
+            bool time{false};                   // TRUE = compare the timestamps of the records
+            bool timeOfDay{false};              // TRUE = compare only the time of the day
+            qint64 usec{0};                     // The timestamp to compare with
+        }NODE_t;
+
+        bool tokenize(const QString& query);
+        int parseOr();
+        int parseAnd();
+        int parseFactor();
+        int parseComparison();
+        bool isKeyword(const char *word) const;
+        int addNode(const NODE_t& node);
+        int resolveColumn(const QString& name);
+        bool parseTime(const QString& text, qint64 *usec, bool *timeOfDay);
+        bool matches(const NODE_t& node, const QString& value) const;
+        TRowBitmap evaluate(int node);
+        TRowBitmap compareColumn(const NODE_t& node);
+        TRowBitmap compareTime(const NODE_t& node);
+
+        TColumnStore *mStore{nullptr};
+        const TLogIndex *mIndex{nullptr};
+        QString mError;
+        std::vector<TOKEN_t> mTokens;
+        size_t mToken{0};                       // The next token to parse
+        std::vector<NODE_t> mNodes;             // The compiled query
+        int mRoot{-1};                          // The top node of the query
+};
+
+#endif // TFILTERQUERY_H
@@ -0,0 +1,785 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+#include "tformatdetector.h"
+#include "tlineparser.h"
+#include "tjsonschema.h"
+#include "tlogger.h"
+
+#define SAMPLE_SIZE     (256 * 1024)    // Default number of bytes read from the head and from the tail of a file
+#define MAX_FIELDS      64              // Maximum number of fields of a logfmt or syslog line
+#define MAX_COLUMNS     20              // Maximum number of columns of a table
+#define MIN_SCORE       0.6             // Minimum score of a format to replace the current one
+#define MIN_LAYOUT      0.5             // Minimum fraction of lines starting with a timestamp to use it as record start
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::ifstream;
+
+using FIELD_t = TLineParser::FIELD_t;
+
+namespace
+{
+    // The known timestamp layouts at the start of a line. The first matching
+    // layout wins, so longer layouts must be listed before shorter ones.
+    const struct
+    {
+        const char *name;
+        const char *pattern;
+        const char *regex;
+        const char *format;
+    } timeLayouts[] = {
+        { "ISO 8601",       "dddd-dd-dd?dd:dd:dd",  "\\[?\\d{4}-\\d{2}-\\d{2}[T ]\\d{2}:\\d{2}:\\d{2}",             "" },
+        { "yyyy/MM/dd",     "dddd/dd/dd dd:dd:dd",  "\\[?\\d{4}/\\d{2}/\\d{2} \\d{2}:\\d{2}:\\d{2}",                "%Y/%m/%d %H:%M:%S" },
+        { "dd.MM.yyyy",     "dd.dd.dddd dd:dd:dd",  "\\[?\\d{2}\\.\\d{2}\\.\\d{4} \\d{2}:\\d{2}:\\d{2}",            "%d.%m.%Y %H:%M:%S" },
+        { "Common log",     "dd/aaa/dddd:dd:dd:dd", "\\[?\\d{2}/[A-Za-z]{3}/\\d{4}:\\d{2}:\\d{2}:\\d{2}",           "%d/%b/%Y:%H:%M:%S" },
+        { "BSD syslog",     "aaa Dd dd:dd:dd",      "\\[?[A-Za-z]{3} [ \\d]\\d \\d{2}:\\d{2}:\\d{2}",               "%b %e %H:%M:%S" },
+        { "Time of day",    "dd:dd:dd",             "\\[?\\d{2}:\\d{2}:\\d{2}",                                "%H:%M:%S" },
+        { "Epoch (ms)",     "ddddddddddddd",        "\\[?\\d{13}",                                              "" },
+        { "Epoch",          "dddddddddd",           "\\[?\\d{10}",                                              "" }
+    };
+
+    const char *timeKeys[] = { "timestamp", "time", "ts", "date", "datetime", "@timestamp" };
+
+    const char *levelWords[] = { "TRACE", "DEBUG", "INFO", "NOTICE", "WARN", "WARNING", "ERROR", "ERR", "FATAL", "CRITICAL", "CRIT",
+                                 "TRC", "DBG", "INF", "WRN", "FTL" };
+
+    const char *messageKeys[] = { "msg", "message", "content", "text" };
+    const char *threadKeys[] = { "thread", "tid", "threadid", "thread_id" };
+
+    bool oneOf(string_view word, const char *const *list, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (word.size() != strlen(list[i]))
+                continue;
+
+            bool equal = true;
+
+            for (size_t j = 0; j < word.size() && equal; ++j)
+                equal = (toupper(static_cast<unsigned char>(word[j])) == toupper(static_cast<unsigned char>(list[i][j])));
+
+            if (equal)
+                return true;
+        }
+
+        return false;
+    }
+
+    string_view trimmed(string_view str)
+    {
+        while (!str.empty() && (str.front() == ' ' || str.front() == '\t'))
+            str.remove_prefix(1);
+
+        while (!str.empty() && (str.back() == ' ' || str.back() == '\t'))
+            str.remove_suffix(1);
+
+        return str;
+    }
+
+    size_t countOf(string_view line, string_view delim)
+    {
+        size_t count = 0;
+        size_t pos = line.find(delim);
+
+        while (pos != string_view::npos)
+        {
+            count++;
+            pos = line.find(delim, pos + delim.size());
+        }
+
+        return count;
+    }
+}
+
+TFormatDetector::TFormatDetector(qint64 sampleSize)
+    : mSampleSize(sampleSize > 0 ? sampleSize : SAMPLE_SIZE)
+{
+    DECL_TRACER("TFormatDetector::TFormatDetector(qint64 sampleSize)");
+}
+
+/**
+ * @brief TFormatDetector::detect
+ * Reads the head and the tail of the file \p file and scores all known
+ * formats against it. The best format is stored as the result.
+ *
+ * @param file  The uncompressed logfile.
+ * @return If a sample could be read, TRUE is returned.
+ */
+bool TFormatDetector::detect(const QString& file)
+{
+    DECL_TRACER("TFormatDetector::detect(const QString& file)");
+
+    auto start = std::chrono::steady_clock::now();
+    mResult = RESULT_t();
+    mFile = file;
+    mBuffer.clear();
+    mLines.clear();
+    mRecords.clear();
+
+    ifstream in(file.toStdString(), std::ios::binary);
+
+    if (!in.is_open())
+    {
+        MSG_ERROR("Error opening file " << file.toStdString());
+        return false;
+    }
+
+    in.seekg(0, std::ios::end);
+    qint64 size = static_cast<qint64>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    qint64 head = std::min(size, mSampleSize);
+    mBuffer.resize(head);
+
+    if (head <= 0 || !in.read(mBuffer.data(), head))
+        return false;
+
+    if (size > head)                                // Skip the partial last line of the head
+    {
+        auto nl = std::find(mBuffer.rbegin(), mBuffer.rend(), '\n');
+
+        if (nl != mBuffer.rend())
+            mBuffer.resize(mBuffer.rend() - nl);
+    }
+
+    if (size > head * 2)                            // Add the tail starting at the beginning of a line
+    {
+        vector<char> tail(mSampleSize);
+        in.seekg(size - mSampleSize);
+
+        if (in.read(tail.data(), mSampleSize))
+        {
+            auto nl = std::find(tail.begin(), tail.end(), '\n');
+
+            if (nl != tail.end())
+                mBuffer.insert(mBuffer.end(), nl + 1, tail.end());
+        }
+    }
+
+    splitLines();
+
+    if (mLines.empty())
+        return false;
+
+    detectLayout();
+
+    // Score the candidates. On about equal scores the more specific format wins.
+    QStringList keys;
+    bool rfc5424 = false, priority = false;
+    double json = scoreJson();
+    double syslog = scoreSyslog(&rfc5424, &priority);
+    double logfmt = scoreLogfmt(&keys);
+    const char *delimiters[] = { "\t", ";", "|", "," };
+    string_view delim;
+    int delimCount = 0;
+    double delimited = 0.0;
+
+    for (const char *d : delimiters)
+    {
+        int count = 0;
+        double score = scoreDelimiter(d, &count);
+
+        if (score > delimited + 0.05)
+        {
+            delimited = score;
+            delim = d;
+            delimCount = count;
+        }
+    }
+
+    mResult.format = TConfig::FORMAT_JSON;
+    mResult.score = json;
+
+    if (syslog > mResult.score + 0.05)
+    {
+        mResult.format = TConfig::FORMAT_SYSLOG;
+        mResult.score = syslog;
+    }
+
+    if (logfmt > mResult.score + 0.05)
+    {
+        mResult.format = TConfig::FORMAT_LOGFMT;
+        mResult.score = logfmt;
+    }
+
+    if (delimited > mResult.score + 0.05)
+    {
+        mResult.format = TConfig::FORMAT_DELIMITED;
+        mResult.score = delimited;
+    }
+
+    switch(mResult.format)
+    {
+        case TConfig::FORMAT_JSON:
+            mResult.recordStart.clear();            // The JSON reader finds the records by itself
+            mResult.timeLayout.clear();
+        break;
+
+        case TConfig::FORMAT_SYSLOG:
+            mResult.headers = QStringList({"Timestamp", "Host", "App", "PID"});
+
+            if (rfc5424)
+                mResult.headers << "MsgID";
+
+            if (priority)
+                mResult.headers << "Level";
+
+            mResult.headers << "Message";
+            mResult.threadColumn = 4;
+            mResult.timeColumn = 1;
+            mResult.timeFormat = (rfc5424 ? "" : "%b %e %H:%M:%S");
+        break;
+
+        case TConfig::FORMAT_LOGFMT:
+        {
+            QString msg("Message");
+
+            for (int i = 0; i < keys.size(); ++i)
+            {
+                if (oneOf(keys[i].toStdString(), messageKeys, sizeof(messageKeys) / sizeof(char *)))
+                {
+                    msg = keys.takeAt(i);           // The message is always the last column
+                    break;
+                }
+            }
+
+            while (keys.size() >= MAX_COLUMNS)
+                keys.removeLast();
+
+            for (int i = 0; i < keys.size(); ++i)
+            {
+                string key = keys[i].toStdString();
+
+                if (mResult.threadColumn == 0 && oneOf(key, threadKeys, sizeof(threadKeys) / sizeof(char *)))
+                    mResult.threadColumn = i + 1;
+                else if (mResult.timeColumn == 0 && oneOf(key, timeKeys, sizeof(timeKeys) / sizeof(char *)))
+                    mResult.timeColumn = i + 1;     // ISO 8601 or epoch values are usual in logfmt
+            }
+
+            mResult.headers = keys;
+            mResult.headers << msg;
+        }
+        break;
+
+        default:
+            mResult.delimiter = QString::fromUtf8(delim.data(), static_cast<qsizetype>(delim.size()));
+            mResult.columns = delimCount + 1;
+            proposeDelimited();
+    }
+
+    if (mResult.format != TConfig::FORMAT_JSON)
+        mResult.columns = static_cast<int>(mResult.headers.size());
+
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    MSG_DEBUG("Scores: JSON " << json << ", syslog " << syslog << ", logfmt " << logfmt << ", delimited " << delimited);
+    MSG_DEBUG("Detected " << description().toStdString() << " in " << usec << " usec");
+    return true;
+}
+
+/**
+ * @brief TFormatDetector::fitsConfig
+ * Tests whether the current configuration already matches the detected
+ * format. If the detection is not sure about the format, the configuration
+ * is always considered to fit.
+ *
+ * @return TRUE if the configuration should be kept.
+ */
+bool TFormatDetector::fitsConfig()
+{
+    DECL_TRACER("TFormatDetector::fitsConfig()");
+
+    if (mResult.score < MIN_SCORE)
+        return true;
+
+    TConfig::FORMAT_t format = TConfig::getFormat();
+
+    if (format == TConfig::FORMAT_REGEX)            // A regular expression was written by the user for a reason
+        return true;
+
+    if (format != mResult.format || TConfig::getColumns() < 2)
+        return false;
+
+    switch(format)
+    {
+        case TConfig::FORMAT_DELIMITED: return TConfig::getDelimeter() == mResult.delimiter;
+        case TConfig::FORMAT_JSON:      return TConfig::values().size() == TConfig::getColumns();
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief TFormatDetector::apply
+ * Replaces the format related settings of the current configuration by the
+ * detected ones. The colors and tags are kept. The fields of a JSON file
+ * are discovered first; if this fails, the configuration is not changed.
+ *
+ * @return If the configuration was changed, TRUE is returned.
+ */
+bool TFormatDetector::apply()
+{
+    DECL_TRACER("TFormatDetector::apply()");
+
+    if (mResult.format == TConfig::FORMAT_JSON)
+    {
+        TJsonSchema schema(TConfig::getJsonSamples());
+
+        if (!schema.discover(mFile))
+            return false;
+
+        QList<TValueSelect::VALUES_t> values = schema.proposeValues();
+
+        if (values.size() < 2)                      // Keep the configuration untouched
+            return false;
+
+        TConfig::setFormat(mResult.format);
+        TConfig::setRecordStart(mResult.recordStart);
+
+        while (values.size() > MAX_COLUMNS)         // Keep the message in the last column
+            values.removeAt(values.size() - 2);
+
+        if (TConfig::getDelimeter().isEmpty())
+            TConfig::setDelimeter(",");
+
+        TConfig::setValues(values);
+        TConfig::setHeaders(schema.proposeHeaders(values));
+        TConfig::setColumns(static_cast<int>(values.size()));
+        TConfig::setColAligns(schema.proposeColAligns(values));
+        TConfig::setColumnThreadID(std::max(0, schema.proposeThreadColumn(values)));
+        TConfig::setTimeColumn(0);
+        TConfig::setTimeLayout(QString());
+
+        for (int i = 0; i < values.size(); ++i)
+        {
+            if (oneOf(values[i].name.section('.', -1).toStdString(), timeKeys, sizeof(timeKeys) / sizeof(char *)))
+            {
+                TConfig::setTimeColumn(i + 1);
+                break;
+            }
+        }
+
+        mResult.columns = static_cast<int>(values.size());
+        return true;
+    }
+
+    TConfig::setFormat(mResult.format);
+    TConfig::setRecordStart(mResult.recordStart);
+
+    if (mResult.format == TConfig::FORMAT_DELIMITED)
+        TConfig::setDelimeter(mResult.delimiter);
+
+    TConfig::setColumns(mResult.columns);
+    TConfig::setHeaders(mResult.headers);
+    TConfig::setColAligns(QString());
+    TConfig::setColumnThreadID(mResult.threadColumn);
+    TConfig::setTimeColumn(mResult.timeColumn);
+    TConfig::setTimeLayout(mResult.timeFormat);
+    return true;
+}
+
+QString TFormatDetector::description()
+{
+    QString fmt = TConfig::formatToString(mResult.format);
+
+    if (mResult.format == TConfig::FORMAT_DELIMITED)
+        fmt.append(QString(" by \"%1\"").arg(mResult.delimiter == "\t" ? QString("\\t") : mResult.delimiter));
+
+    QString desc = QString("%1, %2 columns").arg(fmt).arg(mResult.columns);
+
+    if (!mResult.timeLayout.isEmpty())
+        desc.append(QString(", timestamp %1").arg(mResult.timeLayout));
+
+    if (!mResult.recordStart.isEmpty())
+        desc.append(", multi-line records");
+
+    return desc + QString(" (score %1%)").arg(static_cast<int>(mResult.score * 100.0));
+}
+
+void TFormatDetector::splitLines()
+{
+    const char *data = mBuffer.data();
+    size_t size = mBuffer.size();
+    size_t pos = 0;
+    bool first = true;
+
+    while (pos < size)
+    {
+        const char *nl = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+        size_t end = nl ? static_cast<size_t>(nl - data) : size;
+        string_view line(data + pos, end - pos);
+
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        if (!trimmed(line).empty())
+        {
+            if (first)                              // A JSON array must start with an object or a line break
+            {
+                string_view t = trimmed(line);
+                string_view rest = trimmed(t.substr(1));
+                mPrettyJson = (t == "{" || (t.front() == '[' && (rest.empty() || rest.front() == '{')));
+                first = false;
+            }
+
+            mLines.push_back(line);
+        }
+
+        pos = end + 1;
+    }
+}
+
+/**
+ * @brief TFormatDetector::detectLayout
+ * Finds the timestamp layout most lines start with. If some lines don't
+ * start with it, they are continuation lines and the layout becomes the
+ * rule for the start of a record.
+ *
+ * @return If a layout was found, TRUE is returned.
+ */
+bool TFormatDetector::detectLayout()
+{
+    const size_t numLayouts = sizeof(timeLayouts) / sizeof(timeLayouts[0]);
+    vector<size_t> hits(numLayouts, 0);
+    vector<int> layoutOfLine(mLines.size(), -1);
+
+    for (size_t i = 0; i < mLines.size(); ++i)
+    {
+        string_view line = mLines[i];
+
+        if (!line.empty() && line.front() == '[')
+            line.remove_prefix(1);
+
+        for (size_t l = 0; l < numLayouts; ++l)
+        {
+            if (matchesLayout(line, timeLayouts[l].pattern))
+            {
+                hits[l]++;
+                layoutOfLine[i] = static_cast<int>(l);
+                break;
+            }
+        }
+    }
+
+    size_t best = std::max_element(hits.begin(), hits.end()) - hits.begin();
+
+    if (hits[best] == 0 || hits[best] < mLines.size() * MIN_LAYOUT)
+    {
+        mRecords = mLines;
+        return false;
+    }
+
+    mResult.timeLayout = timeLayouts[best].name;
+
+    if (hits[best] == mLines.size())                // Every line is a record
+    {
+        mRecords = mLines;
+        return true;
+    }
+
+    mResult.recordStart = timeLayouts[best].regex;
+
+    for (size_t i = 0; i < mLines.size(); ++i)
+    {
+        if (layoutOfLine[i] == static_cast<int>(best))
+            mRecords.push_back(mLines[i]);
+    }
+
+    return true;
+}
+
+double TFormatDetector::scoreJson()
+{
+    if (mPrettyJson)                                // Nothing else starts like this
+        return 0.95;
+
+    size_t count = 0;
+
+    for (string_view rec : mRecords)
+    {
+        string_view t = trimmed(rec);
+
+        if (t.front() == '{' && t.back() == '}')
+            count++;
+    }
+
+    return static_cast<double>(count) / mRecords.size();
+}
+
+double TFormatDetector::scoreLogfmt(QStringList *keys)
+{
+    FIELD_t fields[MAX_FIELDS];
+    vector<std::pair<string_view, size_t>> seen;    // The keys in order of their first appearance
+    size_t count = 0;
+
+    for (string_view rec : mRecords)
+    {
+        int num = TLineParser::parseLogfmt(rec.data(), static_cast<qint64>(rec.size()), fields, MAX_FIELDS);
+        int pairs = 0;
+
+        for (int i = 0; i < num; ++i)
+        {
+            if (!fields[i].value.empty())
+                pairs++;
+        }
+
+        if (num <= 0 || pairs < 2 || pairs * 2 < num)
+            continue;
+
+        count++;
+
+        for (int i = 0; i < num; ++i)
+        {
+            if (fields[i].value.empty())            // Words of a free text
+                continue;
+
+            auto iter = std::find_if(seen.begin(), seen.end(), [&fields, i](const std::pair<string_view, size_t>& k) { return k.first == fields[i].key; });
+
+            if (iter != seen.end())
+                iter->second++;
+            else if (seen.size() < MAX_FIELDS)
+                seen.emplace_back(fields[i].key, 1);
+        }
+    }
+
+    if (keys)
+    {
+        keys->clear();
+
+        for (const auto& k : seen)
+        {
+            if (k.second * 2 >= count)              // Only keys found in most lines become a column
+                keys->append(QString::fromUtf8(k.first.data(), static_cast<qsizetype>(k.first.size())));
+        }
+    }
+
+    return static_cast<double>(count) / mRecords.size();
+}
+
+double TFormatDetector::scoreSyslog(bool *rfc5424, bool *priority)
+{
+    FIELD_t fields[MAX_FIELDS];
+    size_t count = 0, structured = 0, withPri = 0;
+
+    for (string_view rec : mRecords)
+    {
+        // Without a priority, only the BSD timestamp identifies a syslog line.
+        // An ISO timestamp is typical for many other formats as well.
+        if (rec.front() != '<' && !isalpha(static_cast<unsigned char>(rec.front())))
+            continue;
+
+        int num = TLineParser::parseSyslog(rec.data(), static_cast<qint64>(rec.size()), fields, MAX_FIELDS);
+
+        if (num <= 0)
+            continue;
+
+        count++;
+
+        for (int i = 0; i < num; ++i)
+        {
+            if (fields[i].key == "sd")
+                structured++;
+            else if (fields[i].key == "severity")
+                withPri++;
+        }
+    }
+
+    if (rfc5424)
+        *rfc5424 = (structured * 2 > count);
+
+    if (priority)
+        *priority = (withPri * 2 > count);
+
+    return static_cast<double>(count) / mRecords.size();
+}
+
+/**
+ * @brief TFormatDetector::scoreDelimiter
+ * Scores a delimiter by the consistency of the number of columns. Because
+ * the last column (the message) may contain the delimiter as well, the
+ * number of columns is the highest number of delimiters found in nearly all
+ * records. Records with exactly this number of delimiters score higher.
+ *
+ * @param delim The delimiter.
+ * @param count Receives the number of delimiters separating the columns.
+ * @return The score of the delimiter.
+ */
+double TFormatDetector::scoreDelimiter(string_view delim, int *count)
+{
+    vector<size_t> histogram(MAX_COLUMNS, 0);       // Number of records with at least n delimiters
+
+    for (string_view rec : mRecords)
+    {
+        size_t n = std::min(countOf(rec, delim), static_cast<size_t>(MAX_COLUMNS - 1));
+        histogram[n]++;
+    }
+
+    size_t atLeast = 0;
+    int k = 0;
+    double ge = 0.0;
+
+    for (int n = MAX_COLUMNS - 1; n > 0; --n)
+    {
+        atLeast += histogram[n];
+
+        if (atLeast >= mRecords.size() * 0.9)
+        {
+            k = n;
+            ge = static_cast<double>(atLeast) / mRecords.size();
+            break;
+        }
+    }
+
+    if (count)
+        *count = k;
+
+    if (k == 0)
+        return 0.0;
+
+    double exact = static_cast<double>(histogram[k]) / mRecords.size();
+    return ge * (0.5 + 0.5 * exact);
+}
+
+/**
+ * @brief TFormatDetector::proposeDelimited
+ * Proposes the titles of the columns of a delimited file by looking at the
+ * values of the sampled records.
+ */
+void TFormatDetector::proposeDelimited()
+{
+    if (mResult.columns > MAX_COLUMNS)
+        mResult.columns = MAX_COLUMNS;
+
+    string delim = mResult.delimiter.toStdString();
+    int fields = mResult.columns - 1;               // The columns before the message
+    vector<size_t> times(fields, 0), levels(fields, 0), threads(fields, 0);
+    vector<int> layoutOf(fields, -1);               // The timestamp layout found in a column
+    size_t samples = std::min(mRecords.size(), static_cast<size_t>(1000));
+
+    for (size_t r = 0; r < samples; ++r)
+    {
+        string_view rec = mRecords[r];
+        size_t pos = 0;
+
+        for (int col = 0; col < fields; ++col)
+        {
+            size_t end = rec.find(delim, pos);
+
+            if (end == string_view::npos)
+                break;
+
+            string_view value = trimmed(rec.substr(pos, end - pos));
+            pos = end + delim.size();
+
+            if (!value.empty() && value.front() == '[' && value.back() == ']')
+                value = value.substr(1, value.size() - 2);
+
+            if (value.empty())
+                continue;
+
+            bool isTime = false;
+
+            for (size_t l = 0; l < sizeof(timeLayouts) / sizeof(timeLayouts[0]) && !isTime; ++l)
+            {
+                if ((isTime = matchesLayout(value, timeLayouts[l].pattern)) && layoutOf[col] < 0)
+                    layoutOf[col] = static_cast<int>(l);
+            }
+
+            if (isTime)
+                times[col]++;
+            else if (isLevel(value))
+                levels[col]++;
+            else if ((value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X')) ||
+                     std::all_of(value.begin(), value.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); }))
+                threads[col]++;
+        }
+    }
+
+    mResult.headers.clear();
+    size_t limit = samples * 8 / 10;
+    bool timestamp = false, level = false;
+
+    for (int col = 0; col < fields; ++col)
+    {
+        if (!timestamp && times[col] > limit)
+        {
+            mResult.headers << "Timestamp";
+            mResult.timeColumn = col + 1;
+            mResult.timeFormat = timeLayouts[layoutOf[col]].format;
+            timestamp = true;
+        }
+        else if (!level && levels[col] > limit)
+        {
+            mResult.headers << "Level";
+            level = true;
+        }
+        else if (mResult.threadColumn == 0 && threads[col] > limit && col > 0)
+        {
+            mResult.headers << "Thread";
+            mResult.threadColumn = col + 1;
+        }
+        else
+            mResult.headers << QString("Column %1").arg(col + 1);
+    }
+
+    mResult.headers << "Message";
+}
+
+bool TFormatDetector::matchesLayout(string_view line, const char *pattern)
+{
+    size_t len = strlen(pattern);
+
+    if (line.size() < len)
+        return false;
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(line[i]);
+
+        switch(pattern[i])
+        {
+            case 'd': if (!isdigit(c)) return false; break;
+            case 'D': if (!isdigit(c) && c != ' ') return false; break;
+            case 'a': if (!isalpha(c)) return false; break;
+            case '?': if (c != 'T' && c != ' ') return false; break;
+
+            default:
+                if (static_cast<char>(c) != pattern[i])
+                    return false;
+        }
+    }
+
+    // A layout must not be followed by a further digit (e.g. an epoch must have 10 digits)
+    return line.size() == len || !isdigit(static_cast<unsigned char>(line[len]));
+}
+
+bool TFormatDetector::isLevel(string_view word)
+{
+    if (oneOf(word, levelWords, sizeof(levelWords) / sizeof(char *)))
+        return true;
+
+    // The configured tags are accepted as well
+    QString w = QString::fromUtf8(word.data(), static_cast<qsizetype>(word.size()));
+    return w == TConfig::getTagInfo() || w == TConfig::getTagWarning() || w == TConfig::getTagError() ||
+           w == TConfig::getTagDebug() || w == TConfig::getTagTrace();
+}
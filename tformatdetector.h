@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TFORMATDETECTOR_H
+#define TFORMATDETECTOR_H
+
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+#include <string_view>
+
+#include "tconfig.h"
+
+/**
+ * @brief The TFormatDetector class
+ * Guesses the format of a logfile out of a sample of its first and last
+ * lines. The candidates (JSON lines, logfmt, syslog and delimited columns)
+ * are scored by the fraction of sampled records they can parse. If most
+ * lines start with a known timestamp layout but some don't, the lines not
+ * starting with it are treated as continuation lines.
+ *
+ * Only a few hundred KB are read and all tests work on the raw bytes, so
+ * the detection takes only a few milliseconds even for huge files.
+ */
+class TFormatDetector
+{
+    public:
+        typedef struct RESULT_t
+        {
+            TConfig::FORMAT_t format{TConfig::FORMAT_DELIMITED};
+            QString delimiter;                  // The delimiter of the columns (delimited format only)
+            int columns{0};                     // The number of columns
+            QStringList headers;                // The proposed titles of the columns
+            int threadColumn{0};                // The column containing the thread ID (1 based, 0 = none)
+            QString recordStart;                // Rule for the start of a record; empty = every line is a record
+            QString timeLayout;                 // The name of the timestamp layout found, if any
+            QString timeFormat;                 // The layout for TTimeParser (empty = ISO 8601 or epoch)
+            int timeColumn{0};                  // The column containing the timestamp (1 based, 0 = none)
+            double score{0.0};                  // Fraction of the sampled records matching the format (0.0 - 1.0)
+        }RESULT_t;
+
+        explicit TFormatDetector(qint64 sampleSize=0);
+
+        bool detect(const QString& file);
+        RESULT_t& result() { return mResult; }
+        bool fitsConfig();
+        bool apply();
+        QString description();
+
+    private:
+        void splitLines();
+        bool detectLayout();
+        double scoreJson();
+        double scoreLogfmt(QStringList *keys);
+        double scoreSyslog(bool *rfc5424, bool *priority);
+        double scoreDelimiter(std::string_view delim, int *count);
+        void proposeDelimited();
+        static bool matchesLayout(std::string_view line, const char *pattern);
+        static bool isLevel(std::string_view word);
+
+        QString mFile;
+        qint64 mSampleSize{0};
+        std::vector<char> mBuffer;              // The sampled bytes (head and tail of the file)
+        std::vector<std::string_view> mLines;   // The sampled lines
+        std::vector<std::string_view> mRecords; // The first lines of the sampled records
+        bool mPrettyJson{false};                // TRUE = the file starts like a pretty-printed JSON file or array
+        RESULT_t mResult;
+};
+
+#endif // TFORMATDETECTOR_H
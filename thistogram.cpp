@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QHelpEvent>
+#include <QToolTip>
+
+#include <algorithm>
+#include <vector>
+
+#include "thistogram.h"
+#include "thistogramdata.h"
+#include "ttimeparser.h"
+#include "tlogger.h"
+
+#define AXIS_HEIGHT     20                      // The height of the time axis
+
+THistogram::THistogram(QWidget *parent)
+    : QWidget(parent)
+{
+    DECL_TRACER("THistogram::THistogram(QWidget *parent)");
+
+    setMinimumHeight(AXIS_HEIGHT + 60);
+    setMaximumHeight(AXIS_HEIGHT + 140);
+}
+
+THistogram::~THistogram()
+{
+    DECL_TRACER("THistogram::~THistogram()");
+
+    if (mData)
+        delete mData;
+}
+
+/**
+ * @brief THistogram::setData
+ * Sets the rows to show, shows the whole time range and removes the
+ * selection.
+ *
+ * @param data      The counted rows or NULL. The widget takes the ownership.
+ * @param names     The name of every series.
+ * @param colors    The color of every series.
+ */
+void THistogram::setData(THistogramData *data, const QStringList& names, const QList<QColor>& colors)
+{
+    DECL_TRACER("THistogram::setData(THistogramData *data, const QStringList& names, const QList<QColor>& colors)");
+
+    if (mData && mData != data)
+        delete mData;
+
+    mData = data;
+    mNames = names;
+    mColors = colors;
+    mView.reset(mData ? &mData->timeBins() : nullptr);
+    mSelected = false;
+    update();
+}
+
+void THistogram::clearSelection()
+{
+    DECL_TRACER("THistogram::clearSelection()");
+
+    mSelected = false;
+    update();
+}
+
+bool THistogram::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip && mData)
+    {
+        QHelpEvent *help = static_cast<QHelpEvent *>(event);
+        QRect plot = plotRect();
+
+        if (!plot.contains(help->pos()))
+        {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        double time = mView.timeAt(help->pos().x(), plot);
+        double usecPerPixel = mView.span() / plot.width();
+        int level = mView.levelOfDetail(plot);
+        int from, to;
+        std::vector<quint32> counts(static_cast<size_t>(mData->series()));
+        mView.binsAt(help->pos().x(), plot, level, &from, &to);
+        mData->sample(level, from, to, counts.data());
+
+        QString text = tr("%1 - %2").arg(TTimeParser::toString(static_cast<qint64>(time))).arg(TTimeParser::toString(static_cast<qint64>(time + usecPerPixel)).mid(11));
+
+        for (int s = mData->series() - 1; s >= 0; --s)
+        {
+            if (counts[static_cast<size_t>(s)] > 0)
+                text.append(QString("<br>%1: %2").arg(s < mNames.size() ? mNames[s] : QString::number(s)).arg(counts[static_cast<size_t>(s)]));
+        }
+
+        QToolTip::showText(help->globalPos(), text, this);
+        return true;
+    }
+
+    return QWidget::event(event);
+}
+
+/**
+ * @brief THistogram::paintEvent
+ * Reads the counts of every pixel column from the level of detail whose
+ * buckets are just narrower than a pixel and draws them as stacked bars
+ * scaled to the highest bar visible.
+ */
+void THistogram::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+
+    QRect plot = plotRect();
+
+    if (!mData || plot.width() <= 0 || plot.height() <= 0)
+        return;
+
+    int width = plot.width();
+    int height = plot.height();
+    int series = mData->series();
+    int level = mView.levelOfDetail(plot);
+    std::vector<quint32> counts(static_cast<size_t>(width) * series);
+    quint32 highest = 1;
+
+    for (int x = 0; x < width; ++x)
+    {
+        quint32 *column = counts.data() + static_cast<size_t>(x) * series;
+        quint32 total = 0;
+        int from, to;
+
+        mView.binsAt(plot.left() + x, plot, level, &from, &to);
+        mData->sample(level, from, to, column);
+
+        for (int s = 0; s < series; ++s)
+            total += column[s];
+
+        highest = std::max(highest, total);
+    }
+
+    if (mImage.width() != width || mImage.height() != height)
+        mImage = QImage(width, height, QImage::Format_RGB32);
+
+    mImage.fill(Qt::white);
+
+    for (int x = 0; x < width; ++x)
+    {
+        const quint32 *column = counts.data() + static_cast<size_t>(x) * series;
+        quint64 stacked = 0;
+        int top = height;
+
+        for (int s = 0; s < series && top > 0; ++s)
+        {
+            if (column[s] == 0)
+                continue;
+
+            stacked += column[s];
+            int next = height - static_cast<int>((stacked * static_cast<quint64>(height) + highest - 1) / highest);
+            QRgb rgb = s < mColors.size() ? mColors[s].rgb() : qRgb(0x80, 0x80, 0x80);
+
+            for (int y = std::max(0, next); y < top; ++y)
+                reinterpret_cast<QRgb *>(mImage.scanLine(y))[x] = rgb;
+
+            top = std::max(0, next);
+        }
+    }
+
+    painter.drawImage(plot.topLeft(), mImage);
+
+    if (mSelected)
+    {
+        int x1 = std::max(plot.left(), mView.xOf(mSelFrom, plot));
+        int x2 = std::min(plot.right(), mView.xOf(mSelTo, plot));
+
+        if (x2 >= x1)
+            painter.fillRect(QRect(x1, plot.top(), x2 - x1 + 1, plot.height()), QColor(0, 120, 215, 60));
+    }
+
+    if (mBrushFrom >= 0 && mBrushTo >= 0)
+    {
+        int x1 = std::min(mBrushFrom, mBrushTo);
+        int x2 = std::max(mBrushFrom, mBrushTo);
+        painter.fillRect(QRect(x1, plot.top(), x2 - x1 + 1, plot.height()), QColor(0, 120, 215, 100));
+    }
+
+    painter.setPen(palette().windowText().color());
+    painter.drawText(plot.adjusted(4, 2, -4, 0), Qt::AlignLeft | Qt::AlignTop, QString::number(highest));
+    mView.drawAxis(painter, plot, AXIS_HEIGHT);
+}
+
+void THistogram::wheelEvent(QWheelEvent *event)
+{
+    if (!mData)
+        return;
+
+    mView.zoom(static_cast<int>(event->position().x()), plotRect(), event->angleDelta().y());
+    update();
+    event->accept();
+}
+
+void THistogram::mousePressEvent(QMouseEvent *event)
+{
+    if (!mData)
+        return;
+
+    int x = std::clamp(static_cast<int>(event->position().x()), plotRect().left(), plotRect().right());
+
+    if (event->button() == Qt::LeftButton)
+    {
+        mBrushFrom = x;
+        mBrushTo = x;
+    }
+    else if (event->button() == Qt::RightButton)
+    {
+        mView.startPan(x);
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void THistogram::mouseMoveEvent(QMouseEvent *event)
+{
+    QRect plot = plotRect();
+    int x = std::clamp(static_cast<int>(event->position().x()), plot.left(), plot.right());
+
+    if (mBrushFrom >= 0)
+        mBrushTo = x;
+    else if (mView.isPanning())
+        mView.panTo(x, plot);
+    else
+        return;
+
+    update();
+}
+
+void THistogram::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::RightButton)
+    {
+        mView.endPan();
+        unsetCursor();
+        return;
+    }
+
+    if (event->button() != Qt::LeftButton || mBrushFrom < 0)
+        return;
+
+    int x1 = std::min(mBrushFrom, mBrushTo);
+    int x2 = std::max(mBrushFrom, mBrushTo);
+    mBrushFrom = mBrushTo = -1;
+
+    if (x2 - x1 < 3)                                                        // A click removes the selection
+    {
+        mSelected = false;
+        update();
+        emit rangeCleared();
+        return;
+    }
+
+    mSelected = true;
+    mSelFrom = mView.timeAt(x1, plotRect());
+    mSelTo = mView.timeAt(x2 + 1, plotRect());
+    update();
+    emit rangeSelected(static_cast<qint64>(mSelFrom), static_cast<qint64>(mSelTo));
+}
+
+QRect THistogram::plotRect() const
+{
+    return QRect(4, 2, std::max(0, width() - 8), std::max(0, height() - AXIS_HEIGHT - 2));
+}
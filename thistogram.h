@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef THISTOGRAM_H
+#define THISTOGRAM_H
+
+#include <QWidget>
+#include <QImage>
+
+#include "ttimebins.h"
+
+class THistogramData;
+
+/**
+ * @brief The THistogram class
+ * Draws the rows per time bucket as bars stacked by level. Dragging with
+ * the left mouse button selects a time range and emits rangeSelected(); a
+ * click without dragging emits rangeCleared(). The mouse wheel zooms
+ * around the mouse pointer and dragging with the right mouse button pans.
+ *
+ * The bars are read from the level of detail of THistogramData matching
+ * the zoom, so the rows are never counted again.
+ */
+class THistogram : public QWidget
+{
+        Q_OBJECT
+
+    public:
+        explicit THistogram(QWidget *parent = nullptr);
+        ~THistogram();
+
+        void setData(THistogramData *data, const QStringList& names, const QList<QColor>& colors);
+        bool hasData() const { return mData != nullptr; }
+        void clearSelection();
+
+    signals:
+        void rangeSelected(qint64 from, qint64 to);
+        void rangeCleared();
+
+    protected:
+        bool event(QEvent *event) override;
+        void paintEvent(QPaintEvent *event) override;
+        void wheelEvent(QWheelEvent *event) override;
+        void mousePressEvent(QMouseEvent *event) override;
+        void mouseMoveEvent(QMouseEvent *event) override;
+        void mouseReleaseEvent(QMouseEvent *event) override;
+
+    private:
+        QRect plotRect() const;
+
+        THistogramData *mData{nullptr};         // The counted rows; owned by this widget
+        QStringList mNames;                     // The name of every series
+        QList<QColor> mColors;                  // The color of every series
+        QImage mImage;                          // The bars
+        TTimeView mView;                        // The time shown by the bars
+        int mBrushFrom{-1};                     // The x position where the left mouse button was pressed (-1 = none)
+        int mBrushTo{-1};                       // The current x position while brushing
+        bool mSelected{false};                  // TRUE = a time range is selected
+        double mSelFrom{0.0};                   // The start of the selected time range
+        double mSelTo{0.0};                     // The end of the selected time range
+};
+
+#endif // THISTOGRAM_H
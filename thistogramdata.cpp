@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+#include <thread>
+
+#include "thistogramdata.h"
+#include "tlogindex.h"
+#include "ttimeparser.h"
+#include "tlogger.h"
+
+using std::vector;
+using std::thread;
+
+#define SLICE_ROWS      (1 << 20)               // The rows counted by a thread at once
+
+/**
+ * @brief THistogramData::THistogramData
+ * @param series    The number of series.
+ * @param first     The time of the first row.
+ * @param last      The time of the last row.
+ */
+THistogramData::THistogramData(int series, qint64 first, qint64 last)
+    : mSeries(std::max(1, series)),
+      mBuckets(first, last)
+{
+    DECL_TRACER("THistogramData::THistogramData(int series, qint64 first, qint64 last)");
+
+    mCounts.assign(mBuckets.size() * static_cast<size_t>(mSeries), 0);
+}
+
+/**
+ * @brief THistogramData::build
+ * Counts the rows and builds the levels.
+ *
+ * @param records   The record of every row (-1 = empty row).
+ * @param values    A value of every row, e.g. its level.
+ * @param series    The series of every value. Rows whose value has no
+ * series or a series out of range are not counted.
+ * @param index     The index holding the time of every record.
+ */
+void THistogramData::build(const vector<qsizetype>& records, const vector<quint8>& values, const vector<quint8>& series, const TLogIndex *index)
+{
+    DECL_TRACER("THistogramData::build(const vector<qsizetype>& records, const vector<quint8>& values, const vector<quint8>& series, const TLogIndex *index)");
+
+    mRecords = &records;
+    mValues = &values;
+    mValueSeries = &series;
+    mIndex = index;
+
+    size_t slices = (records.size() + SLICE_ROWS - 1) / SLICE_ROWS;
+    size_t numThreads = std::min(static_cast<size_t>(std::max(1u, thread::hardware_concurrency())), std::max(static_cast<size_t>(1), slices));
+    size_t level0 = static_cast<size_t>(mBuckets.bins(0)) * static_cast<size_t>(mSeries);
+    vector<vector<quint32>> counts(numThreads, vector<quint32>(level0, 0));
+    std::atomic<size_t> next{0};
+    vector<thread> threads;
+
+    for (size_t t = 0; t < numThreads; ++t)
+        threads.emplace_back(countSlices, this, &next, &counts[t]);
+
+    for (thread& th : threads)
+        th.join();
+
+    for (const vector<quint32>& part : counts)                  // Add up the buckets of the threads
+    {
+        for (size_t i = 0; i < level0; ++i)
+            mCounts[i] += part[i];
+    }
+
+    mBuckets.buildLevels(mCounts, static_cast<size_t>(mSeries), [](quint32 a, quint32 b) { return a + b; });
+    mRecords = nullptr;
+    mValues = nullptr;
+    mValueSeries = nullptr;
+    mIndex = nullptr;
+    MSG_DEBUG("Histogram: " << records.size() << " rows in " << mBuckets.bins(0) << " buckets of " << mBuckets.binWidth(0) << " us using " << numThreads << " threads");
+}
+
+void THistogramData::countSlices(const THistogramData *self, std::atomic<size_t> *next, vector<quint32> *counts)
+{
+    size_t rows = self->mRecords->size();
+
+    for (size_t from = (*next)++ * SLICE_ROWS; from < rows; from = (*next)++ * SLICE_ROWS)
+        self->countRows(*counts, from, std::min(rows, from + SLICE_ROWS));
+}
+
+void THistogramData::countRows(vector<quint32>& counts, size_t from, size_t to) const
+{
+    const vector<qsizetype>& records = *mRecords;
+    const vector<quint8>& values = *mValues;
+    const vector<quint8>& series = *mValueSeries;
+
+    for (size_t row = from; row < to && row < values.size(); ++row)
+    {
+        if (records[row] < 0 || values[row] >= series.size() || series[values[row]] >= mSeries)
+            continue;
+
+        qint64 usec = mIndex->time(records[row]);
+        int bucket = usec == TTimeParser::INVALID ? -1 : mBuckets.binOf(usec);
+
+        if (bucket < 0)
+            continue;
+
+        counts[static_cast<size_t>(bucket) * mSeries + series[values[row]]]++;
+    }
+}
+
+/**
+ * @brief THistogramData::sample
+ * Adds up a range of buckets of a level.
+ *
+ * @param level     The level.
+ * @param from      The first bucket.
+ * @param to        The bucket after the last bucket.
+ * @param counts    Returns the rows of every series. Must have room for
+ * series() values.
+ */
+void THistogramData::sample(int level, int from, int to, quint32 *counts) const
+{
+    std::fill(counts, counts + mSeries, 0);
+    from = std::max(0, from);
+    to = std::min(mBuckets.bins(level), to);
+    const quint32 *bucket = mCounts.data() + (mBuckets.offset(level) + static_cast<size_t>(from)) * mSeries;
+
+    for (int b = from; b < to; ++b, bucket += mSeries)
+    {
+        for (int s = 0; s < mSeries; ++s)
+            counts[s] += bucket[s];
+    }
+}
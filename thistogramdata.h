@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef THISTOGRAMDATA_H
+#define THISTOGRAMDATA_H
+
+#include <QtGlobal>
+
+#include <vector>
+#include <atomic>
+
+#include "ttimebins.h"
+
+class TLogIndex;
+
+/**
+ * @brief The THistogramData class
+ * Counts the rows per time bucket, separated into series (the levels).
+ *
+ * The buckets are the bins of a TTimeBins pyramid with one count for every
+ * series. THistogram draws any zoom from the level whose buckets are just
+ * narrower than a pixel.
+ *
+ * The buckets of level 0 are counted in parallel: every thread counts a
+ * slice of the rows into its own buckets, which are added up at the end.
+ */
+class THistogramData
+{
+    public:
+        THistogramData(int series, qint64 first, qint64 last);
+
+        void build(const std::vector<qsizetype>& records, const std::vector<quint8>& values, const std::vector<quint8>& series, const TLogIndex *index);
+
+        int series() const { return mSeries; }
+        const TTimeBins& timeBins() const { return mBuckets; }
+        void sample(int level, int from, int to, quint32 *counts) const;
+
+    private:
+        void countRows(std::vector<quint32>& counts, size_t from, size_t to) const;
+        static void countSlices(const THistogramData *self, std::atomic<size_t> *next, std::vector<quint32> *counts);
+
+        int mSeries{1};
+        TTimeBins mBuckets;                     // The layout of the buckets
+        std::vector<quint32> mCounts;           // The rows of every series of every bucket of every level
+        // Only valid while building
+        const std::vector<qsizetype> *mRecords{nullptr};
+        const std::vector<quint8> *mValues{nullptr};
+        const std::vector<quint8> *mValueSeries{nullptr};
+        const TLogIndex *mIndex{nullptr};
+};
+
+#endif // THISTOGRAMDATA_H
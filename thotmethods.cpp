@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QTableWidgetItem>
+#include <QHeaderView>
+
+#include "thotmethods.h"
+#include "ui_thotmethods.h"
+#include "tlogger.h"
+
+#define ROLE_ROW        (Qt::UserRole + 1)      // The row of the slowest call of a method
+
+THotMethods::THotMethods(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::THotMethods)
+{
+    DECL_TRACER("THotMethods::THotMethods(QWidget *parent)");
+
+    ui->setupUi(this);
+    ui->tableWidgetMethods->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+}
+
+THotMethods::~THotMethods()
+{
+    DECL_TRACER("THotMethods::~THotMethods()");
+
+    delete ui;
+}
+
+/**
+ * @brief THotMethods::setCallTree
+ * Fills the table with the methods of a finished call tree. The times are
+ * shown in milliseconds. The numbers are stored as numbers, so the table
+ * sorts them numerically. Initially the table is sorted by the total time.
+ *
+ * @param tree  The call tree.
+ */
+void THotMethods::setCallTree(const TCallTree& tree)
+{
+    DECL_TRACER("THotMethods::setCallTree(const TCallTree& tree)");
+
+    const std::vector<TCallTree::METHOD_t>& methods = tree.methods();
+    QTableWidget *table = ui->tableWidgetMethods;
+
+    table->setSortingEnabled(false);
+    table->setRowCount(static_cast<int>(methods.size()));
+
+    auto number = [](double value) {
+        QTableWidgetItem *item = new QTableWidgetItem;
+        item->setData(Qt::DisplayRole, value);
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        return item;
+    };
+
+    for (int i = 0; i < static_cast<int>(methods.size()); ++i)
+    {
+        const TCallTree::METHOD_t& m = methods[static_cast<size_t>(i)];
+        QTableWidgetItem *name = new QTableWidgetItem(m.name);
+        name->setData(ROLE_ROW, m.slowestRow);
+        name->setToolTip(tr("Double click to go to the slowest call in line %1").arg(m.slowestRow + 1));
+        table->setItem(i, 0, name);
+        table->setItem(i, 1, number(static_cast<double>(m.calls)));
+        table->setItem(i, 2, number(static_cast<double>(m.inclusive) / 1000.0));
+        table->setItem(i, 3, number(static_cast<double>(m.exclusive) / 1000.0));
+        table->setItem(i, 4, number(static_cast<double>(m.inclusive) / 1000.0 / static_cast<double>(m.calls)));
+        table->setItem(i, 5, number(static_cast<double>(m.p99) / 1000.0));
+        table->setItem(i, 6, number(static_cast<double>(m.maximum) / 1000.0));
+    }
+
+    table->setSortingEnabled(true);
+    table->sortItems(2, Qt::DescendingOrder);
+    ui->labelSummary->setText(tr("%1 methods in %2 threads, %3 block lines without a partner.")
+                              .arg(methods.size()).arg(tree.threads()).arg(tree.unmatched()));
+}
+
+void THotMethods::on_tableWidgetMethods_cellDoubleClicked(int row, int)
+{
+    DECL_TRACER("THotMethods::on_tableWidgetMethods_cellDoubleClicked(int row, int)");
+
+    QTableWidgetItem *item = ui->tableWidgetMethods->item(row, 0);
+
+    if (item && item->data(ROLE_ROW).toInt() >= 0)
+        emit rowSelected(item->data(ROLE_ROW).toInt());
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef THOTMETHODS_H
+#define THOTMETHODS_H
+
+#include <QDialog>
+
+#include "tcalltree.h"
+
+namespace Ui {
+    class THotMethods;
+}
+
+/**
+ * @brief The THotMethods class
+ * Shows the methods measured by TCallTree in a table sortable by every
+ * column. A double click on a method emits rowSelected() with the row of
+ * its slowest call.
+ */
+class THotMethods : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        explicit THotMethods(QWidget *parent = nullptr);
+        ~THotMethods();
+
+        void setCallTree(const TCallTree& tree);
+
+    signals:
+        void rowSelected(int row);
+
+    private slots:
+        void on_tableWidgetMethods_cellDoubleClicked(int row, int column);
+
+    private:
+        Ui::THotMethods *ui;
+};
+
+#endif // THOTMETHODS_H
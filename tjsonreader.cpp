@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QJsonValue>
+
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+#include "tjsonreader.h"
+#include "tjsonschema.h"
+#include "tlogger.h"
+
+#define CHUNK_SIZE      (1024 * 1024)   // Size of the chunks read while scanning
+#define MIN_BATCH       256             // Minimum number of records parsed by one thread
+
+using std::string;
+using std::vector;
+using std::ifstream;
+using std::thread;
+
+using VALTYPES_t = TValueSelect::VALTYPES_t;
+using VALUES_t = TValueSelect::VALUES_t;
+
+TJsonReader::TJsonReader(const QString& file)
+    : mFile(file.toStdString())
+{
+    DECL_TRACER("TJsonReader::TJsonReader(const QString& file)");
+}
+
+/**
+ * @brief TJsonReader::split
+ * Scans the whole file and collects the boundaries of all records. Only a
+ * fixed sized buffer is used, so the memory needed does not depend on the
+ * size of the file.
+ *
+ * @param maxRecords    If this is greater than 0, the scan stops after
+ * this number of records were found.
+ * @return On success TRUE is returned.
+ */
+bool TJsonReader::split(qsizetype maxRecords)
+{
+    DECL_TRACER("TJsonReader::split(qsizetype maxRecords)");
+
+    mRecords.clear();
+    mMaxRecords = maxRecords;
+    mDepth = 0;
+    mInString = mEscape = mInRaw = mArray = mNewLine = false;
+    mFirst = true;
+    mStart = 0;
+
+    ifstream in(mFile, std::ios::binary);
+
+    if (!in.is_open())
+    {
+        MSG_ERROR("Error opening file " << mFile);
+        return false;
+    }
+
+    vector<char> buffer(CHUNK_SIZE);
+    qint64 base = 0;
+
+    while (in)
+    {
+        in.read(buffer.data(), CHUNK_SIZE);
+        qint64 len = static_cast<qint64>(in.gcount());
+
+        if (len <= 0)
+            break;
+
+        feed(buffer.data(), len, base);
+        base += len;
+
+        if (mMaxRecords > 0 && static_cast<qsizetype>(mRecords.size()) >= mMaxRecords)
+            return true;
+    }
+
+    finish(base);
+    MSG_DEBUG("Found " << mRecords.size() << " records" << (mArray ? " in an array." : "."));
+    return true;
+}
+
+void TJsonReader::feed(const char *buf, qint64 len, qint64 base)
+{
+    for (qint64 i = 0; i < len; ++i)
+    {
+        char c = buf[i];
+        bool newLine = mNewLine;
+        mNewLine = (c == '\n');
+
+        if (mInRaw)                                                 // Text outside of a record ends at the end of the line
+        {
+            if (c == '\n')
+            {
+                mInRaw = false;
+                addRecord(base + i, false);
+            }
+
+            continue;
+        }
+
+        if (mDepth == 0)                                            // Between records
+        {
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                continue;
+
+            if (c == '{')
+            {
+                mFirst = false;
+                mStart = base + i;
+                mDepth = 1;
+                continue;
+            }
+
+            if (mFirst && c == '[')                                 // All records are part of an array
+            {
+                mFirst = false;
+                mArray = true;
+                continue;
+            }
+
+            if (mArray && (c == ',' || c == ']'))                   // Separators of the array elements
+                continue;
+
+            mFirst = false;
+            mInRaw = true;
+            mStart = base + i;
+            continue;
+        }
+
+        if (newLine && c == '{')                                    // A record starting while the last one is unbalanced
+        {
+            addRecord(base + i - 1, false);                         // The broken record without the line feed
+            mStart = base + i;
+            mDepth = 1;
+            mInString = mEscape = false;
+            continue;
+        }
+
+        if (mInString)
+        {
+            if (mEscape)
+                mEscape = false;
+            else if (c == '\\')
+                mEscape = true;
+            else if (c == '"')
+                mInString = false;
+
+            continue;
+        }
+
+        switch(c)
+        {
+            case '"': mInString = true; break;
+            case '{':
+            case '[': mDepth++; break;
+
+            case '}':
+            case ']':
+                mDepth--;
+
+                if (mDepth == 0)
+                    addRecord(base + i + 1, true);
+            break;
+        }
+
+        if (mMaxRecords > 0 && static_cast<qsizetype>(mRecords.size()) >= mMaxRecords)
+            return;
+    }
+}
+
+void TJsonReader::finish(qint64 end)
+{
+    if (mInRaw || mDepth > 0)                                       // An unterminated record is kept as raw text
+        addRecord(end, false);
+
+    mInRaw = mInString = mEscape = false;
+    mDepth = 0;
+}
+
+void TJsonReader::addRecord(qint64 end, bool json)
+{
+    RECORD_t rec;
+    rec.offset = mStart;
+    rec.length = end - mStart;
+    rec.json = json;
+
+    if (rec.length > 0)
+        mRecords.push_back(rec);
+}
+
+/**
+ * @brief TJsonReader::parse
+ * Parses all records found by split(). The records are divided into
+ * contiguous batches and every batch is parsed by its own thread. Each
+ * thread reads its records directly from the file.
+ *
+ * @param values    The values to extract from every record.
+ * @param delimiter The delimiter used to join the values.
+ * @param rows      A vector receiving one row for every record.
+ * @return On success TRUE is returned.
+ */
+bool TJsonReader::parse(const QList<VALUES_t>& values, const QString& delimiter, vector<ROW_t>& rows)
+{
+    DECL_TRACER("TJsonReader::parse(const QList<VALUES_t>& values, const QString& delimiter, vector<ROW_t>& rows)");
+
+    rows.clear();
+    rows.resize(mRecords.size());
+
+    if (mRecords.empty())
+        return true;
+
+    size_t numThreads = std::max(1u, thread::hardware_concurrency());
+    numThreads = std::min(numThreads, std::max(static_cast<size_t>(1), mRecords.size() / MIN_BATCH));
+    vector<thread> threads;
+    size_t start = 0;
+
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        size_t end = mRecords.size() * (t + 1) / numThreads;
+        threads.emplace_back(parseRecords, mFile, &mRecords, start, end, &values, &delimiter, &rows);
+        start = end;
+    }
+
+    for (thread& th : threads)
+        th.join();
+
+    return true;
+}
+
+void TJsonReader::parseRecords(const string& file, const vector<RECORD_t> *records, size_t from, size_t to,
+                               const QList<VALUES_t> *values, const QString *delimiter, vector<ROW_t> *rows)
+{
+    ifstream in(file, std::ios::binary);
+
+    if (!in.is_open())
+        return;
+
+    QByteArray raw;
+
+    for (size_t i = from; i < to; ++i)
+    {
+        const RECORD_t& rec = records->at(i);
+        ROW_t& row = rows->at(i);
+        raw.resize(rec.length);
+        in.clear();
+        in.seekg(rec.offset);
+
+        if (!in.read(raw.data(), rec.length))
+            raw.resize(in.gcount());
+
+        if (rec.json)
+        {
+            QJsonParseError err;
+            QJsonDocument jdoc = QJsonDocument::fromJson(raw, &err);
+
+            if (err.error == QJsonParseError::NoError && jdoc.isObject())
+            {
+                row.line = toLine(jdoc.object(), *values, *delimiter);
+                continue;
+            }
+
+            row.line = QString::fromUtf8(raw).simplified();     // A pretty-printed record may contain line feeds
+        }
+        else
+        {
+            if (raw.endsWith('\r'))
+                raw.chop(1);
+
+            row.line = QString::fromUtf8(raw);
+        }
+
+        row.json = false;
+    }
+}
+
+/**
+ * @brief TJsonReader::toLine
+ * Extracts the values \p values out of the JSON object \p obj and joins
+ * them with the delimiter \p delimiter.
+ *
+ * @param obj       The JSON object of a record.
+ * @param values    The wanted values.
+ * @param delimiter The delimiter between the values.
+ * @return The line with the values.
+ */
+QString TJsonReader::toLine(const QJsonObject& obj, const QList<VALUES_t>& values, const QString& delimiter)
+{
+    QString line;
+
+    for (qsizetype i = 0; i < values.size(); ++i)                           // Loop through all JSON values
+    {
+        const VALUES_t& vt = values[i];
+
+        if (i > 0)                                                          // If it is not the first element ...
+            line.append(delimiter);                                         // Append the delimiter
+
+        if (i == values.size() - 1)                                         // If it is the last entry in the list ...
+            line.append(" ");                                               // Append a blank to avoid cutting off first character
+
+        // A name containing dots (.) is a path to a value in nested objects
+        QJsonValue content = TJsonSchema::valueAt(obj, vt.name);           // Get the wanted value
+
+        switch(vt.type)                                                     // Switch through possible value types
+        {
+            case VALTYPES_t::VTYPE_STRING:
+            {
+                QString p = content.toString(" ");                          // Get the string from the value
+                p.replace(",", " ");                                        // Replace all commas into spaces
+                line.append(p);                                             // Append it to the line
+            }
+            break;
+
+            case VALTYPES_t::VTYPE_INT:
+                line.append(QString("%1").arg(content.toInt()));
+            break;
+
+            case VALTYPES_t::VTYPE_LONG:
+                line.append(QString("%1").arg(content.toInteger()));
+            break;
+
+            case VALTYPES_t::VTYPE_FLOAT:
+            case VALTYPES_t::VTYPE_DOUBLE:
+                line.append(QString("%1").arg(content.toDouble()));
+            break;
+
+            case VALTYPES_t::VTYPE_BOOL:
+                line.append(QString("%1").arg(content.toBool()));
+            break;
+        }
+    }
+
+    return line;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TJSONREADER_H
+#define TJSONREADER_H
+
+#include <QString>
+#include <QList>
+
+#include <string>
+#include <vector>
+
+#include "tvalueselect.h"
+
+class QJsonObject;
+
+/**
+ * @brief The TJsonReader class
+ * Reads JSON formatted logfiles. The file is scanned in chunks by a small
+ * state machine tracking the brace depth and whether the current position is
+ * inside a string. This finds the boundaries of every record without building
+ * a DOM. So it doesn't matter whether a file contains one record per line,
+ * pretty-printed records spreading over several lines or whether all records
+ * are wrapped into one top level array.
+ *
+ * Once the boundaries are known, the records are parsed in parallel. Text
+ * outside of any record is returned as a raw record. A '{' at the start of
+ * a line inside a record starts a new record; the truncated record before
+ * it is returned as a raw record, so one broken line of a file with one
+ * record per line doesn't swallow the rest of the file.
+ */
+class TJsonReader
+{
+    public:
+        typedef struct RECORD_t
+        {
+            qint64 offset{0};                   // The offset of the first byte of the record in the file
+            qint64 length{0};                   // The length of the record in bytes
+            bool json{true};                    // FALSE = raw text outside of a JSON object
+        }RECORD_t;
+
+        typedef struct ROW_t
+        {
+            QString line;                       // The values of the record joined by the delimiter
+            bool json{true};                    // FALSE = the record was not a valid JSON object
+        }ROW_t;
+
+        explicit TJsonReader(const QString& file);
+
+        bool split(qsizetype maxRecords=-1);
+        std::vector<RECORD_t>& records() { return mRecords; }
+        bool isArray() { return mArray; }
+        bool parse(const QList<TValueSelect::VALUES_t>& values, const QString& delimiter, std::vector<ROW_t>& rows);
+
+        static QString toLine(const QJsonObject& obj, const QList<TValueSelect::VALUES_t>& values, const QString& delimiter);
+
+    private:
+        void feed(const char *buf, qint64 len, qint64 base);
+        void finish(qint64 end);
+        void addRecord(qint64 end, bool json);
+        static void parseRecords(const std::string& file, const std::vector<RECORD_t> *records, size_t from, size_t to,
+                                 const QList<TValueSelect::VALUES_t> *values, const QString *delimiter, std::vector<ROW_t> *rows);
+
+        std::string mFile;
+        std::vector<RECORD_t> mRecords;
+        qsizetype mMaxRecords{-1};
+        // State of the scanner
+        int mDepth{0};                          // The actual depth of nested objects and arrays
+        bool mInString{false};                  // TRUE = inside a quoted string
+        bool mEscape{false};                    // TRUE = last character was a backslash inside a string
+        bool mInRaw{false};                     // TRUE = inside a line of text outside of a record
+        bool mArray{false};                     // TRUE = the records are wrapped into a top level array
+        bool mFirst{true};                      // TRUE = no character other than white space was found yet
+        bool mNewLine{false};                   // TRUE = the last character was a line feed
+        qint64 mStart{0};                       // The offset of the actual record
+};
+
+#endif // TJSONREADER_H
@@ -0,0 +1,607 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QJsonArray>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+
+#include "tjsonschema.h"
+#include "tjsonreader.h"
+#include "tlogger.h"
+
+#define MAX_DISTINCT    10000       // Maximum number of distinct values counted per key
+#define MAX_DEPTH       8           // Maximum depth of nested objects
+#define MAX_SKIP_LINES  8           // Maximum number of lines skipped to find a JSON record
+
+namespace fs = std::filesystem;
+using std::string;
+using std::vector;
+using std::ifstream;
+using std::thread;
+
+using VALTYPES_t = TValueSelect::VALTYPES_t;
+using VALUES_t = TValueSelect::VALUES_t;
+
+TJsonSchema::TJsonSchema(int samples)
+    : mSamples(samples)
+{
+    DECL_TRACER("TJsonSchema::TJsonSchema(int samples)");
+
+    if (mSamples < 1)
+        mSamples = 1;
+}
+
+/**
+ * @brief TJsonSchema::discover
+ * Samples up to the configured number of records of the file \p file. The
+ * sample offsets are spread evenly over the whole file and every thread
+ * reads and parses its own contiguous range of offsets. Only one line is
+ * read per offset, so the time needed does not depend on the size of the
+ * file.
+ *
+ * @param file  The uncompressed logfile.
+ * @return On success TRUE is returned.
+ */
+bool TJsonSchema::discover(const QString& file)
+{
+    DECL_TRACER("TJsonSchema::discover(const QString& file)");
+
+    mKeys.clear();
+    mRecords = 0;
+    string fname = file.toStdString();
+    std::error_code ec;
+
+    if (!fs::is_regular_file(fname, ec))
+    {
+        MSG_ERROR("File " << fname << " is not a regular file!");
+        return false;
+    }
+
+    qint64 size = static_cast<qint64>(fs::file_size(fname, ec));
+
+    if (ec || size <= 0)
+    {
+        MSG_ERROR("File " << fname << " is empty or not readable!");
+        return false;
+    }
+
+    // Spread the offsets evenly over the whole file
+    vector<qint64> offsets;
+
+    for (int i = 0; i < mSamples; ++i)
+    {
+        qint64 off = static_cast<qint64>((static_cast<double>(size) / mSamples) * i);
+
+        if (offsets.empty() || off > offsets.back())
+            offsets.push_back(off);
+    }
+
+    int numThreads = std::max(1, static_cast<int>(thread::hardware_concurrency()));
+    numThreads = std::min(numThreads, static_cast<int>(offsets.size()));
+    vector<SAMPLE_RESULT_t> results(numThreads);
+    vector<thread> threads;
+    size_t start = 0;
+
+    for (int t = 0; t < numThreads; ++t)
+    {
+        size_t end = offsets.size() * (t + 1) / numThreads;
+        vector<qint64> part(offsets.begin() + start, offsets.begin() + end);
+        qint64 limit = (end < offsets.size()) ? offsets[end] : size;
+        threads.emplace_back(sampleOffsets, fname, part, limit, &results[t]);
+        start = end;
+    }
+
+    for (thread& th : threads)
+        th.join();
+
+    qsizetype found = 0;
+
+    for (const SAMPLE_RESULT_t& res : results)
+        found += res.records;
+
+    if (found == 0)                                             // No record starts on a line of its own?
+        sampleHead(fname, mSamples, &results[0]);               // Then the file may contain pretty-printed records
+
+    // Merge the results of all threads
+    QHash<QString, KEY_STAT_t> stats;
+
+    for (SAMPLE_RESULT_t& res : results)
+    {
+        mRecords += res.records;
+        QHash<QString, KEY_STAT_t>::iterator iter;
+
+        for (iter = res.stats.begin(); iter != res.stats.end(); ++iter)
+        {
+            KEY_STAT_t& st = stats[iter.key()];
+            const KEY_STAT_t& src = iter.value();
+            st.count += src.count;
+            st.nBool += src.nBool;
+            st.nInt += src.nInt;
+            st.nLong += src.nLong;
+            st.nDouble += src.nDouble;
+            st.nString += src.nString;
+            st.totalLength += src.totalLength;
+            st.positions += src.positions;
+            st.capped = st.capped || src.capped;
+
+            for (const QString& v : src.distinct)
+            {
+                if (st.distinct.size() >= MAX_DISTINCT)
+                {
+                    st.capped = true;
+                    break;
+                }
+
+                st.distinct.insert(v);
+            }
+        }
+    }
+
+    if (mRecords == 0)
+    {
+        MSG_WARN("No JSON records found in file " << fname);
+        return false;
+    }
+
+    QHash<QString, KEY_STAT_t>::iterator iter;
+
+    for (iter = stats.begin(); iter != stats.end(); ++iter)
+    {
+        const KEY_STAT_t& st = iter.value();
+        KEY_INFO_t ki;
+        ki.path = iter.key();
+        ki.count = st.count;
+        ki.cardinality = st.distinct.size();
+        ki.cardCapped = st.capped;
+        ki.avgLength = st.count ? static_cast<double>(st.totalLength) / st.count : 0.0;
+        ki.position = st.count ? st.positions / st.count : 0.0;
+        qsizetype numeric = st.nInt + st.nLong + st.nDouble;
+
+        if (st.nString > 0 || (st.nBool > 0 && numeric > 0))
+            ki.type = VALTYPES_t::VTYPE_STRING;
+        else if (st.nBool > 0)
+            ki.type = VALTYPES_t::VTYPE_BOOL;
+        else if (st.nDouble > 0)
+            ki.type = VALTYPES_t::VTYPE_DOUBLE;
+        else if (st.nLong > 0)
+            ki.type = VALTYPES_t::VTYPE_LONG;
+        else if (st.nInt > 0)
+            ki.type = VALTYPES_t::VTYPE_INT;
+        else
+            ki.type = VALTYPES_t::VTYPE_STRING;
+
+        mKeys.append(ki);
+    }
+
+    // Keep the order the keys have in the records
+    std::sort(mKeys.begin(), mKeys.end(), [](const KEY_INFO_t& a, const KEY_INFO_t& b) {
+        return a.position < b.position;
+    });
+
+    MSG_DEBUG("Sampled " << mRecords << " records with " << mKeys.size() << " different keys.");
+    return true;
+}
+
+/**
+ * @brief TJsonSchema::sampleHead
+ * Reads the first \p samples records from the start of the file. This is
+ * used for files where the records are pretty-printed or wrapped into an
+ * array. In such a file it is not possible to find the start of a record
+ * from an arbitrary offset.
+ *
+ * @param file      The name of the file.
+ * @param samples   The maximum number of records to read.
+ * @param result    The result receiving the statistics.
+ */
+void TJsonSchema::sampleHead(const string& file, int samples, SAMPLE_RESULT_t *result)
+{
+    DECL_TRACER("TJsonSchema::sampleHead(const string& file, int samples, SAMPLE_RESULT_t *result)");
+
+    TJsonReader reader(QString::fromStdString(file));
+
+    if (!result || !reader.split(samples))
+        return;
+
+    ifstream in(file, std::ios::binary);
+
+    if (!in.is_open())
+        return;
+
+    for (const TJsonReader::RECORD_t& rec : reader.records())
+    {
+        if (!rec.json)
+            continue;
+
+        QByteArray raw(rec.length, 0);
+        in.clear();
+        in.seekg(rec.offset);
+
+        if (!in.read(raw.data(), rec.length))
+            continue;
+
+        QJsonParseError err;
+        QJsonDocument jdoc = QJsonDocument::fromJson(raw, &err);
+
+        if (err.error != QJsonParseError::NoError || !jdoc.isObject())
+            continue;
+
+        collect(jdoc.object(), jdoc.object(), QString(), raw, 0, result->stats, 0);
+        result->records++;
+    }
+}
+
+void TJsonSchema::sampleOffsets(const string& file, const vector<qint64>& offsets, qint64 limit, SAMPLE_RESULT_t *result)
+{
+    ifstream in(file, std::ios::binary);
+
+    if (!in.is_open() || !result)
+        return;
+
+    qint64 lastEnd = -1;                                    // End of the last line read; it is always the start of a line
+    string line;
+
+    for (qint64 off : offsets)
+    {
+        qint64 pos = std::max(off, lastEnd);
+
+        if (pos >= limit)                                   // The next thread starts here
+            break;
+
+        in.clear();
+
+        if (pos > 0 && pos != lastEnd)                      // Are we possibly in the middle of a line?
+        {                                                   // Yes, then skip to the start of the next line
+            in.seekg(pos - 1);
+            char c = 0;
+
+            if (!in.get(c))
+                break;
+
+            if (c != '\n')
+                getline(in, line);
+        }
+        else
+            in.seekg(pos);
+
+        for (int skip = 0; skip < MAX_SKIP_LINES; ++skip)
+        {
+            qint64 lineStart = static_cast<qint64>(in.tellg());
+
+            if (lineStart < 0 || lineStart >= limit || !getline(in, line))
+                break;
+
+            lastEnd = static_cast<qint64>(in.tellg());
+
+            if (lastEnd < 0)                                // Last line without a line feed
+                lastEnd = limit;
+
+            size_t first = line.find_first_not_of(" \t");
+
+            if (first == string::npos || line[first] != '{')
+                continue;
+
+            QByteArray raw(line.c_str(), static_cast<qsizetype>(line.size()));
+            QJsonParseError err;
+            QJsonDocument jdoc = QJsonDocument::fromJson(raw, &err);
+
+            if (err.error != QJsonParseError::NoError || !jdoc.isObject())
+                continue;
+
+            collect(jdoc.object(), jdoc.object(), QString(), raw, 0, result->stats, 0);
+            result->records++;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief TJsonSchema::collect
+ * Adds the values of an object to the statistics. The keys of nested
+ * objects are joined by a dot. A key may contain a dot itself, so a path
+ * can name more than one value. Only the value valueAt() returns for the
+ * path is counted.
+ *
+ * @param root      The object of the record.
+ * @param obj       The object to add.
+ * @param prefix    The path of \p obj.
+ * @param raw       The raw record.
+ * @param from      The position of \p obj in the raw record.
+ * @param stats     Receives the statistics.
+ * @param depth     The nesting depth of \p obj.
+ */
+void TJsonSchema::collect(const QJsonObject& root, const QJsonObject& obj, const QString& prefix, const QByteArray& raw, qsizetype from, QHash<QString, KEY_STAT_t>& stats, int depth)
+{
+    if (depth >= MAX_DEPTH)
+        return;
+
+    QJsonObject::const_iterator iter;
+
+    for (iter = obj.constBegin(); iter != obj.constEnd(); ++iter)
+    {
+        QString path = prefix.isEmpty() ? iter.key() : prefix + "." + iter.key();
+        QJsonValue val = iter.value();
+        // QJsonObject keeps the keys sorted. To get the original order, the
+        // position of the key in the raw record is used.
+        QByteArray needle = "\"" + iter.key().toUtf8() + "\"";
+        qsizetype pos = raw.indexOf(needle, from);
+
+        if (pos < 0)
+            pos = from;
+
+        if (val.isObject())
+        {
+            collect(root, val.toObject(), path, raw, pos, stats, depth + 1);
+            continue;
+        }
+
+        if (val.isArray() || val.isNull() || val.isUndefined())     // Arrays can't be mapped to a single column
+            continue;
+
+        if (depth > 0 && valueAt(root, path) != val)        // Hidden by a key containing a dot
+            continue;
+
+        KEY_STAT_t& st = stats[path];
+        st.count++;
+        st.positions += raw.isEmpty() ? 0.0 : static_cast<double>(pos) / raw.size();
+        QString text;
+
+        if (val.isBool())
+        {
+            st.nBool++;
+            text = val.toBool() ? "true" : "false";
+        }
+        else if (val.isDouble())
+        {
+            double d = val.toDouble();
+
+            if (std::floor(d) == d && std::fabs(d) <= INT_MAX)
+                st.nInt++;
+            else if (std::floor(d) == d && std::fabs(d) < 9007199254740992.0)     // 2^53
+                st.nLong++;
+            else
+                st.nDouble++;
+
+            text = QString::number(d, 'g', 17);
+        }
+        else
+        {
+            st.nString++;
+            text = val.toString();
+        }
+
+        st.totalLength += text.length();
+
+        if (st.distinct.size() < MAX_DISTINCT)
+            st.distinct.insert(text);
+        else if (!st.distinct.contains(text))
+            st.capped = true;
+    }
+}
+
+double TJsonSchema::frequency(const KEY_INFO_t& key)
+{
+    if (mRecords <= 0)
+        return 0.0;
+
+    return static_cast<double>(key.count) / mRecords;
+}
+
+/**
+ * @brief TJsonSchema::proposeValues
+ * Creates a column set out of the discovered keys. Only keys found in at
+ * least \p minFrequency of all sampled records are used. The string value
+ * with the largest average length is assumed to be the message and is
+ * moved to the last column, because the last column is the one with the
+ * free text.
+ *
+ * @param minFrequency  The minimum frequency of a key (0.0 - 1.0)
+ * @return The list of values usable as JSON values of a profile.
+ */
+QList<VALUES_t> TJsonSchema::proposeValues(double minFrequency)
+{
+    DECL_TRACER("TJsonSchema::proposeValues(double minFrequency)");
+
+    QList<VALUES_t> values;
+    qsizetype message = -1;
+    double maxLength = 0.0;
+
+    for (const KEY_INFO_t& ki : mKeys)
+    {
+        if (frequency(ki) < minFrequency)
+            continue;
+
+        VALUES_t vt;
+        vt.name = ki.path;
+        vt.type = ki.type;
+
+        if (ki.type == VALTYPES_t::VTYPE_STRING && ki.avgLength > maxLength)
+        {
+            maxLength = ki.avgLength;
+            message = values.size();
+        }
+
+        values.append(vt);
+    }
+
+    if (message >= 0 && message < values.size() - 1)
+    {
+        VALUES_t vt = values.takeAt(message);
+        values.append(vt);
+    }
+
+    return values;
+}
+
+QStringList TJsonSchema::proposeHeaders(const QList<VALUES_t>& values)
+{
+    DECL_TRACER("TJsonSchema::proposeHeaders(const QList<VALUES_t>& values)");
+
+    QStringList headers;
+
+    for (const VALUES_t& vt : values)
+    {
+        QString head = vt.name.section('.', -1);
+
+        if (!head.isEmpty())
+            head[0] = head[0].toUpper();
+
+        headers << head;
+    }
+
+    return headers;
+}
+
+QString TJsonSchema::proposeColAligns(const QList<VALUES_t>& values)
+{
+    DECL_TRACER("TJsonSchema::proposeColAligns(const QList<VALUES_t>& values)");
+
+    QStringList aligns;
+
+    for (const VALUES_t& vt : values)
+    {
+        if (vt.type == VALTYPES_t::VTYPE_STRING || vt.type == VALTYPES_t::VTYPE_BOOL)
+            aligns << "l";
+        else
+            aligns << "r";
+    }
+
+    return aligns.join(",");
+}
+
+/**
+ * @brief TJsonSchema::proposeThreadColumn
+ * Looks for a value which is named like a thread ID.
+ *
+ * @param values    The proposed values.
+ * @return The number of the column (1 based) or 0 if there is no such column.
+ */
+int TJsonSchema::proposeThreadColumn(const QList<VALUES_t>& values)
+{
+    DECL_TRACER("TJsonSchema::proposeThreadColumn(const QList<VALUES_t>& values)");
+
+    QStringList names = { "thread", "threadid", "thread_id", "tid" };
+
+    for (qsizetype i = 0; i < values.size(); ++i)
+    {
+        if (names.contains(values[i].name.section('.', -1).toLower()))
+            return static_cast<int>(i + 1);
+    }
+
+    return 0;
+}
+
+QString TJsonSchema::report(double minFrequency)
+{
+    DECL_TRACER("TJsonSchema::report(double minFrequency)");
+
+    QString rep = QString("<p>Sampled <b>%1</b> records.</p>").arg(mRecords);
+    rep.append("<table><tr><th align=\"left\">Key</th><th align=\"left\">Type</th><th align=\"right\">Frequency</th><th align=\"right\">Distinct</th></tr>");
+
+    for (const KEY_INFO_t& ki : mKeys)
+    {
+        QString type;
+
+        switch(ki.type)
+        {
+            case VALTYPES_t::VTYPE_STRING:  type = "String"; break;
+            case VALTYPES_t::VTYPE_INT:     type = "Integer"; break;
+            case VALTYPES_t::VTYPE_LONG:    type = "Long integer"; break;
+            case VALTYPES_t::VTYPE_FLOAT:   type = "Float"; break;
+            case VALTYPES_t::VTYPE_DOUBLE:  type = "Double"; break;
+            case VALTYPES_t::VTYPE_BOOL:    type = "Bool"; break;
+        }
+
+        double freq = frequency(ki);
+        QString name = ki.path.toHtmlEscaped();
+
+        if (freq < minFrequency)
+            name = "<i>" + name + "</i>";
+
+        // A single arg() call, so a "%" in a key isn't replaced by the following arguments.
+        rep.append(QString("<tr><td>%1</td><td>%2</td><td align=\"right\">%3%</td><td align=\"right\">%4%5</td></tr>")
+                   .arg(name, type, QString::number(freq * 100.0, 'f', 1), QString(ki.cardCapped ? ">" : ""), QString::number(ki.cardinality)));
+    }
+
+    rep.append("</table>");
+    return rep;
+}
+
+/**
+ * @brief TJsonSchema::valueAt
+ * Returns the value of the dotted path \p path. A key may contain a dot
+ * itself, so the rest of the path is first tried as a key of the object.
+ * Otherwise the part up to the first dot names the next object. A numeric
+ * part is used as an index if the parent is an array.
+ *
+ * @param obj   The base object.
+ * @param path  The path of the value, e.g. "header.pid".
+ * @return The value or an undefined value if the path doesn't exist.
+ */
+QJsonValue TJsonSchema::valueAt(const QJsonObject& obj, const QString& path)
+{
+    QJsonObject::const_iterator iter = obj.constFind(path);
+
+    if (iter != obj.constEnd() || !path.contains(u'.'))
+        return iter != obj.constEnd() ? iter.value() : QJsonValue(QJsonValue::Undefined);
+
+    return descend(obj, QStringView(path));
+}
+
+QJsonValue TJsonSchema::descend(const QJsonObject& obj, QStringView path)
+{
+    QJsonValue val(obj);
+
+    while (!path.isEmpty())
+    {
+        if (val.isObject())
+        {
+            QJsonObject o = val.toObject();
+            QJsonObject::const_iterator iter = o.constFind(path);
+
+            if (iter != o.constEnd())
+                return iter.value();
+        }
+
+        qsizetype dot = path.indexOf(u'.');
+        QStringView part = dot < 0 ? path : path.left(dot);
+        path = dot < 0 ? QStringView() : path.mid(dot + 1);
+
+        if (val.isObject())
+            val = val.toObject().value(part);
+        else if (val.isArray())
+        {
+            bool ok = false;
+            int idx = part.toInt(&ok);
+
+            if (!ok)
+                return QJsonValue(QJsonValue::Undefined);
+
+            val = val.toArray().at(idx);
+        }
+        else
+            return QJsonValue(QJsonValue::Undefined);
+    }
+
+    return val;
+}
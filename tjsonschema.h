@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TJSONSCHEMA_H
+#define TJSONSCHEMA_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonValue>
+#include <QHash>
+#include <QSet>
+
+#include <vector>
+
+#include "tvalueselect.h"
+
+class QJsonObject;
+
+/**
+ * @brief The TJsonSchema class
+ * Discovers the structure of a JSON formatted logfile by sampling a limited
+ * number of records spread over the whole file. The records are read and
+ * parsed in parallel. For every key path found, the type, the frequency and
+ * the cardinality (number of distinct values) is collected. Out of this a
+ * column set is proposed which can be used directly as the JSON values of a
+ * profile.
+ */
+class TJsonSchema
+{
+    public:
+        typedef struct KEY_INFO_t
+        {
+            QString path;                       // The dotted path of the value (e.g. "header.pid")
+            TValueSelect::VALTYPES_t type{TValueSelect::VTYPE_STRING};  // The inferred type
+            qsizetype count{0};                 // Number of sampled records containing the path
+            qsizetype cardinality{0};           // Number of distinct values found
+            bool cardCapped{false};             // TRUE = there are more distinct values than counted
+            double avgLength{0.0};              // Average length of the value as text
+            double position{0.0};               // Average relative position of the key in a record
+        }KEY_INFO_t;
+
+        explicit TJsonSchema(int samples=1000);
+
+        bool discover(const QString& file);
+        QList<KEY_INFO_t>& keys() { return mKeys; }
+        qsizetype sampledRecords() { return mRecords; }
+        double frequency(const KEY_INFO_t& key);
+
+        QList<TValueSelect::VALUES_t> proposeValues(double minFrequency=0.5);
+        QStringList proposeHeaders(const QList<TValueSelect::VALUES_t>& values);
+        QString proposeColAligns(const QList<TValueSelect::VALUES_t>& values);
+        int proposeThreadColumn(const QList<TValueSelect::VALUES_t>& values);
+        QString report(double minFrequency=0.5);
+
+        static QJsonValue valueAt(const QJsonObject& obj, const QString& path);
+
+    private:
+        typedef struct KEY_STAT_t
+        {
+            qsizetype count{0};                 // Number of records containing the key
+            qsizetype nBool{0};                 // Number of boolean values
+            qsizetype nInt{0};                  // Number of integer values fitting into an int
+            qsizetype nLong{0};                 // Number of integer values needing 64 bit
+            qsizetype nDouble{0};               // Number of floating point values
+            qsizetype nString{0};               // Number of strings
+            qint64 totalLength{0};              // Sum of the length of all values as text
+            double positions{0.0};              // Sum of the relative positions in the records
+            QSet<QString> distinct;             // The distinct values (limited)
+            bool capped{false};                 // TRUE = limit of distinct values reached
+        }KEY_STAT_t;
+
+        typedef struct SAMPLE_RESULT_t
+        {
+            qsizetype records{0};               // Number of records parsed
+            QHash<QString, KEY_STAT_t> stats;   // The statistics of each key path
+        }SAMPLE_RESULT_t;
+
+        static void sampleOffsets(const std::string& file, const std::vector<qint64>& offsets, qint64 limit, SAMPLE_RESULT_t *result);
+        static void sampleHead(const std::string& file, int samples, SAMPLE_RESULT_t *result);
+        static QJsonValue descend(const QJsonObject& obj, QStringView path);
+        static void collect(const QJsonObject& root, const QJsonObject& obj, const QString& prefix, const QByteArray& raw, qsizetype from, QHash<QString, KEY_STAT_t>& stats, int depth);
+
+        int mSamples{1000};
+        qsizetype mRecords{0};
+        QList<KEY_INFO_t> mKeys;
+};
+
+#endif // TJSONSCHEMA_H
@@ -0,0 +1,942 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QRegularExpression>
+
+#include <thread>
+#include <algorithm>
+#include <string_view>
+#include <cstring>
+#include <cctype>
+
+#include "tlineparser.h"
+#include "tlogindex.h"
+#include "tlogger.h"
+
+#define MIN_BATCH       4096            // Minimum number of records parsed by one thread
+#define MAX_FIELDS      64              // Maximum number of fields of a line in logfmt or syslog format
+
+using std::vector;
+using std::string;
+using std::thread;
+using std::string_view;
+
+namespace
+{
+    // Synonyms of field names. A column accepts all names of the group
+    // containing its (lower case) header name.
+    const vector<vector<string>> fieldSynonyms = {
+        { "timestamp", "time", "ts", "date", "datetime", "@timestamp" },
+        { "level", "lvl", "severity", "loglevel", "priority" },
+        { "msg", "message", "content", "text" },
+        { "thread", "tid", "threadid", "thread_id" },
+        { "procid", "pid", "process" },
+        { "hostname", "host" },
+        { "app", "appname", "application", "program", "tag", "logger" },
+        { "msgid" },
+        { "facility" },
+        { "sd", "structureddata", "structured_data" }
+    };
+
+    const int levelGroup = 1;           // Index of the level synonyms in fieldSynonyms
+    const int messageGroup = 2;         // Index of the message synonyms in fieldSynonyms
+
+    const char *sysFacilities[] = {
+        "kern", "user", "mail", "daemon", "auth", "syslog", "lpr", "news",
+        "uucp", "cron", "authpriv", "ftp", "ntp", "security", "console", "solaris-cron",
+        "local0", "local1", "local2", "local3", "local4", "local5", "local6", "local7"
+    };
+
+    const char *sysSeverities = "01234567";
+
+    bool equalsNoCase(string_view a, string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i])))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool startsWithNoCase(string_view str, string_view prefix)
+    {
+        return str.size() >= prefix.size() && equalsNoCase(str.substr(0, prefix.size()), prefix);
+    }
+
+    bool isHexDigit(QChar c)
+    {
+        ushort u = c.unicode();
+        ushort lower = u | 0x20;                                    // Lower case for the letters
+        return (u >= '0' && u <= '9') || (lower >= 'a' && lower <= 'f');
+    }
+
+    // Tests whether a regular expression contains an option group like
+    // (?i), (?mi), (?x-s:...) or (?^i) setting or clearing the option "i"
+    // (case insensitive) or "x" (extended, white space is ignored).
+    bool hasCaseOrSpaceOption(const QString& pattern)
+    {
+        qsizetype pos = 0;
+
+        while ((pos = pattern.indexOf(QStringLiteral("(?"), pos)) >= 0)
+        {
+            qsizetype slashes = 0;
+
+            while (slashes < pos && pattern[pos - slashes - 1] == '\\')
+                slashes++;
+
+            if (slashes % 2)                                        // An escaped parenthesis
+            {
+                pos += 2;
+                continue;
+            }
+
+            bool option = false;
+
+            for (pos += 2; pos < pattern.size(); ++pos)
+            {
+                QChar c = pattern[pos];
+
+                if (c == 'i' || c == 'x')
+                    option = true;
+                else if (c != '-' && c != '^' && !c.isLetter())
+                    break;
+            }
+
+            if (option && pos < pattern.size() && (pattern[pos] == ')' || pattern[pos] == ':'))
+                return true;
+        }
+
+        return false;
+    }
+
+    // Skips the operand of an escape sequence starting with a letter or a
+    // digit, e.g. the "41" of "\x41" or the "<name>" of "\k<name>".
+    // Returns the position of the last character of the sequence.
+    qsizetype skipEscape(const QString& pattern, qsizetype pos)
+    {
+        qsizetype len = pattern.size();
+        QChar c = pattern[pos];
+
+        auto skipEnclosed = [&pattern, len](qsizetype i) -> qsizetype {
+            if (i + 1 >= len)
+                return i;
+
+            QChar open = pattern[i + 1];
+            QChar close = (open == '{') ? QChar('}') : (open == '<') ? QChar('>') : (open == '\'') ? QChar('\'') : QChar();
+
+            if (close.isNull())
+                return i;
+
+            qsizetype end = pattern.indexOf(close, i + 2);
+            return (end < 0) ? len - 1 : end;
+        };
+
+        if (c == 'x')                                               // \xhh or \x{hhh..}
+        {
+            if (pos + 1 < len && pattern[pos + 1] == '{')
+                return skipEnclosed(pos);
+
+            for (int n = 0; n < 2 && pos + 1 < len && isHexDigit(pattern[pos + 1]); ++n)
+                pos++;
+
+            return pos;
+        }
+
+        if (c == 'c')                                               // \cX
+            return std::min(pos + 1, len - 1);
+
+        if (c == 'o' || c == 'k' || c == 'N' || c == 'p' || c == 'P' || c == 'g')
+        {
+            qsizetype end = skipEnclosed(pos);
+
+            if (end != pos)
+                return end;
+
+            if (c == 'p' || c == 'P')                               // \pL
+                return std::min(pos + 1, len - 1);
+
+            if (c == 'g' && pos + 1 < len && (pattern[pos + 1] == '-' || pattern[pos + 1] == '+'))
+                pos++;
+
+            if (c != 'g')
+                return pos;
+        }
+
+        if (c.isDigit() || c == 'g')                                // \0nn, \nnn or \g1
+        {
+            while (pos + 1 < len && pattern[pos + 1].isDigit())
+                pos++;
+        }
+
+        return pos;
+    }
+}
+
+TLineParser::TLineParser(const TLogIndex *index, int columns)
+    : mIndex(index),
+      mColumns(columns)
+{
+    DECL_TRACER("TLineParser::TLineParser(const TLogIndex *index, int columns)");
+}
+
+/**
+ * @brief TLineParser::setRegex
+ * Sets the regular expression defining the format of a line and assigns
+ * the capture groups to the columns.
+ *
+ * @param pattern   The regular expression.
+ * @param headers   The headers of the columns.
+ * @return If the expression is valid TRUE is returned.
+ */
+bool TLineParser::setRegex(const QString& pattern, const QStringList& headers)
+{
+    DECL_TRACER("TLineParser::setRegex(const QString& pattern, const QStringList& headers)");
+
+    QRegularExpression re(pattern);
+
+    if (!re.isValid())
+    {
+        mError = QString("%1 at offset %2").arg(re.errorString()).arg(re.patternErrorOffset());
+        MSG_ERROR("Invalid line format: " << mError.toStdString());
+        return false;
+    }
+
+    mFormat = TConfig::FORMAT_REGEX;
+    mPattern = pattern;
+    mGroups.assign(mColumns, -1);
+    QStringList names = re.namedCaptureGroups();
+    bool named = false;
+
+    for (int col = 0; col < mColumns && col < headers.size(); ++col)
+    {
+        QString head = headers[col].simplified().remove(' ');
+
+        for (int grp = 1; grp < names.size(); ++grp)
+        {
+            if (!names[grp].isEmpty() && names[grp].compare(head, Qt::CaseInsensitive) == 0)
+            {
+                mGroups[col] = grp;
+                named = true;
+                break;
+            }
+        }
+    }
+
+    if (!named)                                     // No group name matches a header; take them in order
+    {
+        for (int col = 0; col < mColumns && col < re.captureCount(); ++col)
+            mGroups[col] = col + 1;
+    }
+
+    mLiteral = requiredLiteral(pattern).toUtf8();
+    MSG_DEBUG("Line format has " << re.captureCount() << " groups; prefilter literal: \"" << mLiteral.toStdString() << "\"");
+    return true;
+}
+
+/**
+ * @brief TLineParser::setFormat
+ * Sets one of the built-in formats and assigns the field names to the
+ * columns. If no column accepts the message, it is written into the last
+ * column.
+ *
+ * @param format    The format (logfmt or syslog).
+ * @param headers   The headers of the columns.
+ * @return If the format is a built-in format TRUE is returned.
+ */
+bool TLineParser::setFormat(TConfig::FORMAT_t format, const QStringList& headers)
+{
+    DECL_TRACER("TLineParser::setFormat(TConfig::FORMAT_t format, const QStringList& headers)");
+
+    if (format != TConfig::FORMAT_LOGFMT && format != TConfig::FORMAT_SYSLOG)
+    {
+        mError = "Not a built-in format";
+        return false;
+    }
+
+    mFormat = format;
+    mKeys.assign(mColumns, vector<string>());
+    mLevelColumn.assign(mColumns, false);
+    mMessageColumn = -1;
+
+    for (int col = 0; col < mColumns && col < headers.size(); ++col)
+    {
+        string head = headers[col].simplified().remove(' ').toLower().toStdString();
+        mKeys[col].push_back(head);
+
+        for (size_t grp = 0; grp < fieldSynonyms.size(); ++grp)
+        {
+            const vector<string>& names = fieldSynonyms[grp];
+
+            if (std::find(names.begin(), names.end(), head) == names.end())
+                continue;
+
+            mKeys[col] = names;
+
+            if (grp == levelGroup)
+                mLevelColumn[col] = true;
+            else if (grp == messageGroup && mMessageColumn < 0)
+                mMessageColumn = col;
+
+            break;
+        }
+    }
+
+    if (mMessageColumn < 0 && mColumns > 0)             // Nobody wants the message? Then it goes into the last column.
+    {
+        mMessageColumn = mColumns - 1;
+        const vector<string>& names = fieldSynonyms[messageGroup];
+        mKeys[mMessageColumn].insert(mKeys[mMessageColumn].end(), names.begin(), names.end());
+    }
+
+    mTags[0] = TConfig::getTagError();
+    mTags[1] = TConfig::getTagWarning();
+    mTags[2] = TConfig::getTagInfo();
+    mTags[3] = TConfig::getTagDebug();
+    mTags[4] = TConfig::getTagTrace();
+    return true;
+}
+
+/**
+ * @brief TLineParser::parse
+ * Parses the first line of every record. The records are divided into
+ * contiguous ranges, one for every thread.
+ *
+ * @param rows  A vector receiving the columns of every record. If a line
+ * doesn't match the format, the list of columns is empty.
+ * @return On success TRUE is returned.
+ */
+bool TLineParser::parse(vector<QStringList>& rows)
+{
+    DECL_TRACER("TLineParser::parse(vector<QStringList>& rows)");
+
+    rows.clear();
+
+    if (!mIndex || (mFormat == TConfig::FORMAT_REGEX && mPattern.isEmpty()))
+        return false;
+
+    qsizetype total = mIndex->size();
+    rows.resize(total);
+
+    if (total == 0)
+        return true;
+
+    qsizetype numThreads = std::max(1u, thread::hardware_concurrency());
+    numThreads = std::max(static_cast<qsizetype>(1), std::min(numThreads, total / MIN_BATCH));
+    vector<thread> threads;
+    qsizetype start = 0;
+
+    for (qsizetype t = 0; t < numThreads; ++t)
+    {
+        qsizetype end = total * (t + 1) / numThreads;
+        threads.emplace_back(parseRange, this, start, end, &rows);
+        start = end;
+    }
+
+    for (thread& th : threads)
+        th.join();
+
+    return true;
+}
+
+void TLineParser::parseRange(const TLineParser *parser, qsizetype from, qsizetype to, vector<QStringList> *rows)
+{
+    // Every thread uses its own compiled expression
+    QRegularExpression re;
+    bool regex = (parser->mFormat == TConfig::FORMAT_REGEX);
+
+    if (regex)
+    {
+        re.setPattern(parser->mPattern);
+        re.optimize();
+    }
+
+    const TLogIndex *index = parser->mIndex;
+
+    for (qsizetype i = from; i < to; ++i)
+    {
+        const char *start = index->data() + index->offset(i);
+        qint64 len = index->length(i);
+        const char *nl = static_cast<const char *>(memchr(start, '\n', len));
+
+        if (nl)                                     // Only the first line contains the columns
+            len = nl - start;
+
+        if (len > 0 && start[len - 1] == '\r')
+            len--;
+
+        parser->parseColumns(re, start, len, (*rows)[i]);
+    }
+}
+
+/**
+ * @brief TLineParser::parseColumns
+ * Splits one line into columns.
+ *
+ * @param re        The compiled regular expression (regex format only).
+ * @param line      The line without the line feed.
+ * @param len       The length of the line.
+ * @param parts     Receives the columns. It stays empty if the line doesn't
+ * match the format.
+ */
+void TLineParser::parseColumns(const QRegularExpression& re, const char *line, qint64 len, QStringList& parts) const
+{
+    if (mFormat != TConfig::FORMAT_REGEX)
+    {
+        FIELD_t fields[MAX_FIELDS];
+        int count = 0;
+
+        if (mFormat == TConfig::FORMAT_LOGFMT)
+            count = parseLogfmt(line, len, fields, MAX_FIELDS);
+        else
+            count = parseSyslog(line, len, fields, MAX_FIELDS);
+
+        if (count > 0)
+            assign(fields, count, parts);
+
+        return;
+    }
+
+    string_view literal(mLiteral.constData(), mLiteral.size());
+
+    if (!literal.empty() && string_view(line, len).find(literal) == string_view::npos)
+        return;                                     // Can't match
+
+    QRegularExpressionMatch match = re.match(QString::fromUtf8(line, len));
+
+    if (!match.hasMatch())
+        return;
+
+    for (int grp : mGroups)
+        parts << (grp > 0 ? match.captured(grp) : QString());
+}
+
+/**
+ * @brief TLineParser::parseLine
+ * Splits a single line into columns. This is meant for a few lines only
+ * (e.g. to probe timestamps). Use parse() to split all records.
+ *
+ * @param line  The line without the line feed.
+ * @param len   The length of the line.
+ * @return The columns or an empty list if the line doesn't match.
+ */
+QStringList TLineParser::parseLine(const char *line, qint64 len)
+{
+    if (mFormat == TConfig::FORMAT_REGEX && mRegex.pattern() != mPattern)
+    {
+        mRegex.setPattern(mPattern);
+        mRegex.optimize();
+    }
+
+    QStringList parts;
+    parseColumns(mRegex, line, len, parts);
+    return parts;
+}
+
+/**
+ * @brief TLineParser::parseLogfmt
+ * Finds the key=value pairs of a line in logfmt format. A value may be
+ * quoted. A key without a value is allowed.
+ *
+ * @param line      The line.
+ * @param len       The length of the line.
+ * @param fields    An array receiving the fields.
+ * @param max       The size of the array.
+ * @return The number of fields found. If the line contains no pair at all,
+ * 0 is returned.
+ */
+int TLineParser::parseLogfmt(const char *line, qint64 len, FIELD_t *fields, int max)
+{
+    int count = 0;
+    bool pair = false;
+    qint64 i = 0;
+
+    while (i < len && count < max)
+    {
+        while (i < len && (line[i] == ' ' || line[i] == '\t'))
+            i++;
+
+        if (i >= len)
+            break;
+
+        qint64 ks = i;
+
+        while (i < len && line[i] != '=' && line[i] != ' ' && line[i] != '\t' && line[i] != '"')
+            i++;
+
+        FIELD_t& field = fields[count];
+        field.key = string_view(line + ks, i - ks);
+        field.value = string_view();
+        field.quoted = false;
+
+        if (i < len && line[i] == '=')
+        {
+            pair = true;
+            i++;
+
+            if (i < len && line[i] == '"')
+            {
+                qint64 vs = ++i;
+
+                while (i < len && line[i] != '"')
+                {
+                    if (line[i] == '\\' && i + 1 < len)
+                        i++;
+
+                    i++;
+                }
+
+                field.value = string_view(line + vs, i - vs);
+                field.quoted = true;
+
+                if (i < len)                        // Skip the closing quote
+                    i++;
+            }
+            else
+            {
+                qint64 vs = i;
+
+                while (i < len && line[i] != ' ' && line[i] != '\t')
+                    i++;
+
+                field.value = string_view(line + vs, i - vs);
+            }
+        }
+        else if (i < len && line[i] == '"')         // A quote without a key is not valid
+        {
+            i++;
+            continue;
+        }
+
+        if (!field.key.empty())
+            count++;
+    }
+
+    return pair ? count : 0;
+}
+
+/**
+ * @brief TLineParser::parseSyslog
+ * Finds the fields of a syslog line. Lines in RFC 5424 format are detected
+ * by the version following the priority. All other lines are parsed as
+ * RFC 3164 (BSD) format, where the priority is optional because it is
+ * usually not written into files.
+ *
+ * @param line      The line.
+ * @param len       The length of the line.
+ * @param fields    An array receiving the fields.
+ * @param max       The size of the array.
+ * @return The number of fields found. If the line is not in syslog format,
+ * 0 is returned.
+ */
+int TLineParser::parseSyslog(const char *line, qint64 len, FIELD_t *fields, int max)
+{
+    int count = 0;
+    qint64 i = 0;
+
+    auto add = [fields, max, &count](const char *key, const char *val, qint64 vlen) {
+        if (count >= max)
+            return;
+
+        if (vlen == 1 && *val == '-')               // NILVALUE
+            vlen = 0;
+
+        fields[count].key = key;
+        fields[count].value = string_view(val, vlen);
+        fields[count].quoted = false;
+        count++;
+    };
+
+    auto token = [line, len, &i]() {
+        qint64 start = i;
+
+        while (i < len && line[i] != ' ')
+            i++;
+
+        string_view tok(line + start, i - start);
+
+        if (i < len)
+            i++;
+
+        return tok;
+    };
+
+    if (len > 2 && line[0] == '<')                  // Priority
+    {
+        int pri = 0;
+        i = 1;
+
+        while (i < len && i < 5 && isdigit(static_cast<unsigned char>(line[i])))
+            pri = pri * 10 + (line[i++] - '0');
+
+        if (i == 1 || i >= len || line[i] != '>' || pri > 191)
+            return 0;
+
+        i++;
+        add("severity", sysSeverities + (pri % 8), 1);
+        const char *fac = sysFacilities[pri / 8];
+        add("facility", fac, static_cast<qint64>(strlen(fac)));
+    }
+
+    if (i + 1 < len && isdigit(static_cast<unsigned char>(line[i])) && line[i+1] == ' ')    // RFC 5424
+    {
+        i += 2;
+        const char *names[] = { "timestamp", "hostname", "app", "procid", "msgid" };
+
+        for (const char *name : names)
+        {
+            string_view tok = token();
+            add(name, tok.data(), static_cast<qint64>(tok.size()));
+        }
+
+        qint64 sd = i;
+
+        if (i < len && line[i] == '-')
+            i++;
+        else
+        {
+            while (i < len && line[i] == '[')       // Every element of the structured data is in brackets
+            {
+                bool quoted = false;
+
+                for (i++; i < len; ++i)
+                {
+                    if (quoted && line[i] == '\\')
+                        i++;
+                    else if (line[i] == '"')
+                        quoted = !quoted;
+                    else if (!quoted && line[i] == ']')
+                    {
+                        i++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        add("sd", line + sd, i - sd);
+
+        if (i < len && line[i] == ' ')
+            i++;
+
+        if (len - i >= 3 && memcmp(line + i, "\xEF\xBB\xBF", 3) == 0)    // UTF-8 byte order mark
+            i += 3;
+
+        add("msg", line + i, len - i);
+        return count;
+    }
+
+    // RFC 3164: "Mmm dd hh:mm:ss" or a high precision ISO timestamp
+    if (len - i >= 15 && isalpha(static_cast<unsigned char>(line[i])) && line[i+3] == ' ' &&
+        line[i+6] == ' ' && line[i+9] == ':' && line[i+12] == ':')
+    {
+        add("timestamp", line + i, 15);
+        i += 15;
+
+        if (i < len && line[i] == ' ')
+            i++;
+    }
+    else if (i < len && isdigit(static_cast<unsigned char>(line[i])))
+    {
+        string_view tok = token();
+
+        if (tok.size() < 10 || tok[4] != '-' || tok.find('T') == string_view::npos)
+            return 0;
+
+        add("timestamp", tok.data(), static_cast<qint64>(tok.size()));
+    }
+    else
+        return 0;
+
+    // The hostname is optional. The next word is the tag if it ends with a
+    // colon or contains the PID.
+    qint64 hs = i;
+
+    while (i < len && line[i] != ' ' && line[i] != ':' && line[i] != '[')
+        i++;
+
+    if (i < len && line[i] == ' ')
+    {
+        add("hostname", line + hs, i - hs);
+        hs = ++i;
+
+        while (i < len && line[i] != ' ' && line[i] != ':' && line[i] != '[')
+            i++;
+    }
+
+    add("app", line + hs, i - hs);
+
+    if (i < len && line[i] == '[')
+    {
+        qint64 ps = ++i;
+
+        while (i < len && line[i] != ']')
+            i++;
+
+        add("procid", line + ps, i - ps);
+
+        if (i < len)
+            i++;
+    }
+
+    if (i < len && line[i] == ':')
+        i++;
+
+    if (i < len && line[i] == ' ')
+        i++;
+
+    add("msg", line + i, len - i);
+    return count;
+}
+
+/**
+ * @brief TLineParser::assign
+ * Assigns the fields of a line to the columns. Fields not accepted by any
+ * column are appended to the last column in the form key=value.
+ *
+ * @param fields    The fields of the line.
+ * @param count     The number of fields.
+ * @param parts     The list receiving the columns.
+ */
+void TLineParser::assign(const FIELD_t *fields, int count, QStringList& parts) const
+{
+    parts.clear();
+
+    for (int col = 0; col < mColumns; ++col)
+        parts << QString();
+
+    QString rest;
+
+    for (int f = 0; f < count; ++f)
+    {
+        const FIELD_t& field = fields[f];
+        int col = columnOfKey(field.key);
+        QString val;
+
+        if (col >= 0 && mLevelColumn[col])
+            val = levelTag(field.value);
+        else
+        {
+            val = QString::fromUtf8(field.value.data(), static_cast<qsizetype>(field.value.size()));
+
+            if (field.quoted && val.contains('\\'))
+                val.replace("\\\"", "\"").replace("\\\\", "\\");
+        }
+
+        if (col < 0)
+        {
+            if (!rest.isEmpty())
+                rest.append(' ');
+
+            rest.append(QString::fromUtf8(field.key.data(), static_cast<qsizetype>(field.key.size())));
+
+            if (!val.isEmpty())
+                rest.append('=').append(val);
+        }
+        else if (parts[col].isEmpty())
+            parts[col] = val;
+        else if (!val.isEmpty())
+            parts[col].append(' ').append(val);
+    }
+
+    if (!rest.isEmpty() && mColumns > 0)
+    {
+        QString& last = parts[mColumns - 1];
+
+        if (last.isEmpty())
+            last = rest;
+        else
+            last.append(' ').append(rest);
+    }
+}
+
+int TLineParser::columnOfKey(string_view key) const
+{
+    for (int col = 0; col < mColumns; ++col)
+    {
+        for (const string& name : mKeys[col])
+        {
+            if (equalsNoCase(name, key))
+                return col;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief TLineParser::levelTag
+ * Converts a level or a numerical syslog severity into the configured tag.
+ *
+ * @param value The level.
+ * @return The configured tag or the value itself if it is unknown.
+ */
+QString TLineParser::levelTag(string_view value) const
+{
+    int tag = -1;
+
+    if (value.size() == 1 && value[0] >= '0' && value[0] <= '7')     // Syslog severity
+    {
+        int sev = value[0] - '0';
+
+        if (sev <= 3)
+            tag = 0;
+        else if (sev == 4)
+            tag = 1;
+        else if (sev <= 6)
+            tag = 2;
+        else
+            tag = 3;
+    }
+    else if (startsWithNoCase(value, "err") || startsWithNoCase(value, "crit") || startsWithNoCase(value, "fatal") ||
+             startsWithNoCase(value, "emerg") || startsWithNoCase(value, "alert") || startsWithNoCase(value, "panic"))
+        tag = 0;
+    else if (startsWithNoCase(value, "warn"))
+        tag = 1;
+    else if (startsWithNoCase(value, "info") || startsWithNoCase(value, "notice"))
+        tag = 2;
+    else if (startsWithNoCase(value, "debug"))
+        tag = 3;
+    else if (startsWithNoCase(value, "trace"))
+        tag = 4;
+
+    if (tag >= 0 && !mTags[tag].isEmpty())
+        return mTags[tag];
+
+    return QString::fromUtf8(value.data(), static_cast<qsizetype>(value.size()));
+}
+
+/**
+ * @brief TLineParser::requiredLiteral
+ * Finds the longest literal which must be part of every string matched by
+ * the expression \p pattern. Only literals on the top level of the pattern
+ * are considered. If the pattern contains an alternative or an option
+ * changing the case sensitivity, no literal is returned.
+ *
+ * @param pattern   A regular expression.
+ * @return The literal or an empty string.
+ */
+QString TLineParser::requiredLiteral(const QString& pattern)
+{
+    DECL_TRACER("TLineParser::requiredLiteral(const QString& pattern)");
+
+    if (pattern.contains('|') || hasCaseOrSpaceOption(pattern))
+        return QString();
+
+    QString best, cur;
+    int depth = 0;
+    qsizetype len = pattern.size();
+
+    auto flush = [&best, &cur]() {
+        if (cur.size() > best.size())
+            best = cur;
+
+        cur.clear();
+    };
+
+    for (qsizetype i = 0; i < len; ++i)
+    {
+        QChar c = pattern[i];
+
+        if (c == '\\' && i + 1 < len)
+        {
+            QChar d = pattern[++i];
+
+            if (d == 'Q')                           // \Q...\E quotes a literal
+            {
+                qsizetype end = pattern.indexOf(QStringLiteral("\\E"), i + 1);
+                qsizetype stop = (end < 0) ? len : end;
+
+                if (depth == 0)
+                    cur.append(QStringView(pattern).mid(i + 1, stop - i - 1));
+
+                i = (end < 0) ? len : end + 1;
+                continue;
+            }
+
+            if (d.isLetterOrNumber())               // A class (\d, \s, ...), an anchor, a back reference or a code
+            {
+                flush();
+                i = skipEscape(pattern, i);         // The operands of the escape are no literal
+            }
+            else if (depth == 0)                    // An escaped character is a literal
+                cur.append(d);
+
+            continue;
+        }
+
+        switch(c.unicode())
+        {
+            case '[':                               // Skip a character class
+                flush();
+                i++;
+
+                if (i < len && pattern[i] == '^')
+                    i++;
+
+                if (i < len && pattern[i] == ']')
+                    i++;
+
+                while (i < len && pattern[i] != ']')
+                {
+                    if (pattern[i] == '\\')
+                        i++;
+
+                    i++;
+                }
+            break;
+
+            case '(': depth++; flush(); break;
+            case ')': depth--; flush(); break;
+
+            case '.':
+            case '^':
+            case '$':
+            case '+':                               // The last character is needed at least once
+                flush();
+            break;
+
+            case '*':
+            case '?':
+            case '{':                               // The last character is optional
+                if (!cur.isEmpty())
+                    cur.chop(1);
+
+                flush();
+
+                if (c == '{')
+                {
+                    while (i < len && pattern[i] != '}')
+                        i++;
+                }
+            break;
+
+            default:
+                if (depth == 0)
+                    cur.append(c);
+                else
+                    flush();
+        }
+    }
+
+    flush();
+    return best;
+}
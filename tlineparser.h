@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TLINEPARSER_H
+#define TLINEPARSER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QRegularExpression>
+
+#include <vector>
+#include <string>
+#include <string_view>
+
+#include "tconfig.h"
+
+class TLogIndex;
+
+/**
+ * @brief The TLineParser class
+ * Splits the first line of every record of a TLogIndex into columns. The
+ * records are parsed in parallel. The format of a line is either defined by
+ * a regular expression or it is one of the built-in formats logfmt and
+ * syslog (RFC 5424 and RFC 3164).
+ *
+ * The named capture groups of an expression are assigned to the columns with
+ * the same header name. If no group name matches a header, the groups are
+ * assigned in their order. The expression is compiled once per thread.
+ * Before it is applied, a literal which must be part of every matching line
+ * is searched in the raw bytes. Lines not containing it are skipped without
+ * running the expression.
+ *
+ * The built-in formats are parsed by hand-written parsers working directly
+ * on the raw bytes. They find the fields without allocating any memory. The
+ * fields are assigned to the columns by the header names, where usual
+ * synonyms (e.g. "msg" for "Message") are accepted. A level or severity is
+ * replaced by the configured tag, so the usual level classification works.
+ */
+class TLineParser
+{
+    public:
+        TLineParser(const TLogIndex *index, int columns);
+
+        bool setRegex(const QString& pattern, const QStringList& headers);
+        bool setFormat(TConfig::FORMAT_t format, const QStringList& headers);
+        QString& errorString() { return mError; }
+        bool parse(std::vector<QStringList>& rows);
+        QStringList parseLine(const char *line, qint64 len);
+
+        typedef struct FIELD_t
+        {
+            std::string_view key;               // The name of the field
+            std::string_view value;             // The raw value of the field
+            bool quoted{false};                 // TRUE = the value may contain escaped characters
+        }FIELD_t;
+
+        static QString requiredLiteral(const QString& pattern);
+        static int parseLogfmt(const char *line, qint64 len, FIELD_t *fields, int max);
+        static int parseSyslog(const char *line, qint64 len, FIELD_t *fields, int max);
+
+    private:
+        static void parseRange(const TLineParser *parser, qsizetype from, qsizetype to, std::vector<QStringList> *rows);
+        void parseColumns(const QRegularExpression& re, const char *line, qint64 len, QStringList& parts) const;
+        void assign(const FIELD_t *fields, int count, QStringList& parts) const;
+        int columnOfKey(std::string_view key) const;
+        QString levelTag(std::string_view value) const;
+
+        const TLogIndex *mIndex{nullptr};
+        int mColumns{0};
+        TConfig::FORMAT_t mFormat{TConfig::FORMAT_REGEX};
+        std::vector<std::vector<std::string>> mKeys;    // The accepted field names of every column (lower case)
+        std::vector<bool> mLevelColumn;         // TRUE = the column contains the level
+        int mMessageColumn{-1};                 // The column containing the message
+        QString mTags[5];                       // The configured tags: error, warning, info, debug, trace
+        QString mPattern;                       // The regular expression
+        QRegularExpression mRegex;              // The compiled expression used by parseLine()
+        std::vector<int> mGroups;               // The capture group of every column (-1 = none)
+        QByteArray mLiteral;                    // A literal every matching line must contain (UTF-8)
+        QString mError;
+};
+
+#endif // TLINEPARSER_H
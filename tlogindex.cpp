@@ -0,0 +1,587 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QRegularExpression>
+
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+
+#include "tlogindex.h"
+#include "tlogger.h"
+
+#define MIN_CHUNK_SIZE  (1024 * 1024)   // Files smaller than this are scanned by one thread
+#define MAX_START_MATCH 256             // Maximum number of characters of a line tested for the start of a record
+#define TIME_BLOCK      256             // Number of records of a block of the time index
+#define PROBE_SPAN      (64 * 1024)     // A binary search on the file ends if the range is smaller than this
+#define MAX_PROBE       (1024 * 1024)   // Maximum number of bytes searched for a line with a timestamp
+
+using std::vector;
+using std::thread;
+
+TLogIndex::TLogIndex()
+{
+    DECL_TRACER("TLogIndex::TLogIndex()");
+}
+
+TLogIndex::~TLogIndex()
+{
+    DECL_TRACER("TLogIndex::~TLogIndex()");
+
+    close();
+}
+
+/**
+ * @brief TLogIndex::open
+ * Maps the file \p file into memory. A previously opened file is closed
+ * first.
+ *
+ * @param file  The uncompressed logfile.
+ * @return On success TRUE is returned.
+ */
+bool TLogIndex::open(const QString& file)
+{
+    DECL_TRACER("TLogIndex::open(const QString& file)");
+
+    close();
+    mFile.setFileName(file);
+
+    if (!mFile.open(QIODevice::ReadOnly))
+    {
+        MSG_ERROR("Error opening file " << file.toStdString() << ": " << mFile.errorString().toStdString());
+        return false;
+    }
+
+    mSize = mFile.size();
+    mBegin = 0;
+    mEnd = mSize;
+
+    if (mSize == 0)                                 // An empty file can't be mapped
+        return true;
+
+    mData = reinterpret_cast<const char *>(mFile.map(0, mSize));
+
+    if (!mData)
+    {
+        MSG_ERROR("Error mapping file " << file.toStdString() << ": " << mFile.errorString().toStdString());
+        mFile.close();
+        mSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void TLogIndex::close()
+{
+    DECL_TRACER("TLogIndex::close()");
+
+    mOffsets.clear();
+    mLengths.clear();
+    mTimes.clear();
+    mTimeBlocks.clear();
+
+    if (mData)
+        mFile.unmap(reinterpret_cast<uchar *>(const_cast<char *>(mData)));
+
+    if (mFile.isOpen())
+        mFile.close();
+
+    mData = nullptr;
+    mSize = 0;
+    mBegin = mEnd = 0;
+}
+
+/**
+ * @brief TLogIndex::scan
+ * Finds all records of the mapped file. If \p recordStart is not empty, it
+ * is a regular expression which must match at the start of a line to start
+ * a new record. All lines not matching are continuation lines and belong to
+ * the previous record.
+ *
+ * @param recordStart   A regular expression matching the start of a record.
+ * @return On success TRUE is returned.
+ */
+bool TLogIndex::scan(const QString& recordStart)
+{
+    DECL_TRACER("TLogIndex::scan(const QString& recordStart)");
+
+    mOffsets.clear();
+    mLengths.clear();
+    mTimes.clear();
+    mTimeBlocks.clear();
+
+    if (!mData || mSize == 0)
+        return mFile.isOpen();
+
+    if (!recordStart.isEmpty() && !QRegularExpression(recordStart).isValid())
+    {
+        MSG_ERROR("Invalid regular expression for the start of a record: " << recordStart.toStdString());
+        return false;
+    }
+
+    // Split the file (or the window) into chunks starting at the beginning
+    // of a line
+    qint64 size = mEnd - mBegin;
+    qint64 numThreads = std::max(1u, thread::hardware_concurrency());
+    numThreads = std::max(static_cast<qint64>(1), std::min(numThreads, size / MIN_CHUNK_SIZE));
+    vector<qint64> bounds = { mBegin };
+
+    for (qint64 t = 1; t < numThreads; ++t)
+    {
+        qint64 pos = std::max(bounds.back(), mBegin + size * t / numThreads);
+        const char *nl = static_cast<const char *>(memchr(mData + pos, '\n', mEnd - pos));
+        bounds.push_back(nl ? (nl - mData + 1) : mEnd);
+    }
+
+    bounds.push_back(mEnd);
+    vector<CHUNK_t> chunks(numThreads);
+    vector<thread> threads;
+
+    for (qint64 t = 0; t < numThreads; ++t)
+        threads.emplace_back(scanChunk, mData, bounds[t], bounds[t+1], &recordStart, &chunks[t]);
+
+    for (thread& th : threads)
+        th.join();
+
+    // Merge the chunks. If a chunk starts with continuation lines, they
+    // belong to the last record of the previous chunk.
+    size_t total = 0;
+
+    for (const CHUNK_t& chunk : chunks)
+        total += chunk.offsets.size();
+
+    mOffsets.reserve(total);
+    mLengths.reserve(total);
+
+    for (CHUNK_t& chunk : chunks)
+    {
+        size_t i = 0;
+
+        if (chunk.continues && !chunk.offsets.empty() && !mOffsets.empty())
+        {
+            qint64 len = chunk.offsets[0] + chunk.lengths[0] - mOffsets.back();
+            mLengths.back() = static_cast<quint32>(std::min(len, static_cast<qint64>(UINT_MAX)));
+            i = 1;
+        }
+
+        mOffsets.insert(mOffsets.end(), chunk.offsets.begin() + i, chunk.offsets.end());
+        mLengths.insert(mLengths.end(), chunk.lengths.begin() + i, chunk.lengths.end());
+        chunk.offsets.clear();
+        chunk.lengths.clear();
+    }
+
+    MSG_DEBUG("Found " << mOffsets.size() << " records using " << numThreads << " threads.");
+    return true;
+}
+
+void TLogIndex::scanChunk(const char *data, qint64 from, qint64 to, const QString *recordStart, CHUNK_t *chunk)
+{
+    QRegularExpression re;
+    bool rule = recordStart && !recordStart->isEmpty();
+
+    if (rule)
+    {
+        re.setPattern(QString("\\A(?:%1)").arg(*recordStart));     // The rule must match at the start of the line
+        re.optimize();
+    }
+
+    qint64 pos = from;
+    qint64 recStart = -1;
+    qint64 recEnd = -1;
+    bool first = true;
+
+    while (pos < to)
+    {
+        const char *nl = static_cast<const char *>(memchr(data + pos, '\n', to - pos));
+        qint64 lineEnd = nl ? (nl - data) : to;
+        qint64 end = lineEnd;
+
+        if (end > pos && data[end - 1] == '\r')
+            end--;
+
+        bool start = true;
+
+        if (rule)
+        {
+            qint64 len = std::min(end - pos, static_cast<qint64>(MAX_START_MATCH));
+            start = re.match(QString::fromUtf8(data + pos, len)).hasMatch();
+        }
+
+        if (start || recStart < 0)
+        {
+            if (recStart >= 0)
+            {
+                chunk->offsets.push_back(recStart);
+                chunk->lengths.push_back(static_cast<quint32>(std::min(recEnd - recStart, static_cast<qint64>(UINT_MAX))));
+            }
+            else if (!start && first)
+                chunk->continues = true;
+
+            recStart = pos;
+        }
+
+        recEnd = end;
+        first = false;
+        pos = lineEnd + 1;
+    }
+
+    if (recStart >= 0)
+    {
+        chunk->offsets.push_back(recStart);
+        chunk->lengths.push_back(static_cast<quint32>(std::min(recEnd - recStart, static_cast<qint64>(UINT_MAX))));
+    }
+}
+
+/**
+ * @brief TLogIndex::setRecords
+ * Takes the records found by another scanner (e.g. TJsonReader) instead of
+ * scanning the file for lines.
+ *
+ * @param records   The records.
+ */
+void TLogIndex::setRecords(const vector<TJsonReader::RECORD_t>& records)
+{
+    DECL_TRACER("TLogIndex::setRecords(const vector<TJsonReader::RECORD_t>& records)");
+
+    mOffsets.clear();
+    mLengths.clear();
+    mTimes.clear();
+    mTimeBlocks.clear();
+    mOffsets.reserve(records.size());
+    mLengths.reserve(records.size());
+
+    for (const TJsonReader::RECORD_t& rec : records)
+    {
+        mOffsets.push_back(rec.offset);
+        mLengths.push_back(static_cast<quint32>(std::min(rec.length, static_cast<qint64>(UINT_MAX))));
+    }
+}
+
+QByteArray TLogIndex::record(qsizetype idx) const
+{
+    if (!mData || idx < 0 || idx >= size())
+        return QByteArray();
+
+    return QByteArray(mData + mOffsets[idx], mLengths[idx]);
+}
+
+/**
+ * @brief TLogIndex::firstLine
+ * Returns the first line of a record. For a record without continuation
+ * lines this is the whole record.
+ *
+ * @param idx   The index of the record.
+ * @return The first line of the record.
+ */
+QString TLogIndex::firstLine(qsizetype idx) const
+{
+    if (!mData || idx < 0 || idx >= size())
+        return QString();
+
+    const char *start = mData + mOffsets[idx];
+    const char *nl = static_cast<const char *>(memchr(start, '\n', mLengths[idx]));
+
+    if (!nl)
+        return QString::fromUtf8(start, mLengths[idx]);
+
+    if (nl > start && *(nl - 1) == '\r')
+        nl--;
+
+    return QString::fromUtf8(start, nl - start);
+}
+
+/**
+ * @brief TLogIndex::text
+ * Returns the whole record including all continuation lines.
+ *
+ * @param idx   The index of the record.
+ * @return The text of the record.
+ */
+QString TLogIndex::text(qsizetype idx) const
+{
+    if (!mData || idx < 0 || idx >= size())
+        return QString();
+
+    QString txt = QString::fromUtf8(mData + mOffsets[idx], mLengths[idx]);
+
+    if (txt.contains('\r'))
+        txt.remove('\r');
+
+    return txt;
+}
+
+qsizetype TLogIndex::lineCount(qsizetype idx) const
+{
+    if (!mData || idx < 0 || idx >= size())
+        return 0;
+
+    const char *start = mData + mOffsets[idx];
+    return std::count(start, start + mLengths[idx], '\n') + 1;
+}
+
+/**
+ * @brief TLogIndex::setTimes
+ * Takes the timestamps of all records and builds the sparse time index.
+ *
+ * @param times The timestamp of every record in microseconds.
+ */
+void TLogIndex::setTimes(vector<qint64>&& times)
+{
+    DECL_TRACER("TLogIndex::setTimes(vector<qint64>&& times)");
+
+    mTimes = std::move(times);
+    mTimeBlocks.clear();
+    mTimeBlocks.reserve(mTimes.size() / TIME_BLOCK + 1);
+    qint64 highest = LLONG_MIN;
+
+    for (size_t i = 0; i < mTimes.size(); ++i)
+    {
+        highest = std::max(highest, mTimes[i]);
+
+        if ((i + 1) % TIME_BLOCK == 0 || i + 1 == mTimes.size())
+            mTimeBlocks.push_back(highest);
+    }
+}
+
+/**
+ * @brief TLogIndex::findTime
+ * Finds the first record with a timestamp not less than \p usec. All
+ * blocks before the one found contain only earlier timestamps, so only
+ * one block must be scanned.
+ *
+ * @param usec  The wanted time in microseconds since the epoch.
+ * @return The index of the record or -1 if there is no such record.
+ */
+qsizetype TLogIndex::findTime(qint64 usec) const
+{
+    auto block = std::lower_bound(mTimeBlocks.begin(), mTimeBlocks.end(), usec);
+
+    if (block == mTimeBlocks.end())
+        return -1;
+
+    size_t start = static_cast<size_t>(block - mTimeBlocks.begin()) * TIME_BLOCK;
+    size_t end = std::min(start + TIME_BLOCK, mTimes.size());
+
+    for (size_t i = start; i < end; ++i)
+    {
+        if (mTimes[i] >= usec)
+            return static_cast<qsizetype>(i);
+    }
+
+    return -1;
+}
+
+/**
+ * @brief TLogIndex::setWindow
+ * Limits the next scan to the bytes from \p from up to \p to. Both offsets
+ * must be at the start of a line (or at the end of the file).
+ *
+ * @param from  The offset of the first line of the window.
+ * @param to    The offset after the last line of the window.
+ * @return If the window is empty or out of the file, FALSE is returned.
+ */
+bool TLogIndex::setWindow(qint64 from, qint64 to)
+{
+    DECL_TRACER("TLogIndex::setWindow(qint64 from, qint64 to)");
+
+    if (from < 0 || to > mSize || from >= to)
+        return false;
+
+    mBegin = from;
+    mEnd = to;
+    MSG_DEBUG("Window set to bytes " << from << " - " << to << " of " << mSize);
+    return true;
+}
+
+/**
+ * @brief TLogIndex::probe
+ * Searches the first line with a timestamp starting at or after the offset
+ * \p pos and before \p limit. If \p pos is in the middle of a line, the
+ * search starts with the next line. Lines without a timestamp (e.g.
+ * continuation lines) are skipped.
+ *
+ * @param pos       The offset to start at.
+ * @param limit     Only lines starting before this offset are tested.
+ * @param timeOf    Returns the timestamp of a line.
+ * @param start     Receives the offset of the line found.
+ * @param next      Receives the offset of the line following the line found.
+ * @return The timestamp of the line or LLONG_MIN if there is no line with a
+ * timestamp.
+ */
+qint64 TLogIndex::probe(qint64 pos, qint64 limit, const TIMEOF_t& timeOf, qint64 *start, qint64 *next) const
+{
+    limit = std::min(limit, mSize);
+
+    if (pos > 0 && pos < mSize && mData[pos - 1] != '\n')  // In the middle of a line?
+    {
+        const char *nl = static_cast<const char *>(memchr(mData + pos, '\n', mSize - pos));
+        pos = nl ? (nl - mData + 1) : mSize;
+    }
+
+    while (pos < limit)
+    {
+        const char *nl = static_cast<const char *>(memchr(mData + pos, '\n', mSize - pos));
+        qint64 lineEnd = nl ? (nl - mData) : mSize;
+        qint64 end = lineEnd;
+
+        if (end > pos && mData[end - 1] == '\r')
+            end--;
+
+        qint64 usec = timeOf(mData + pos, end - pos);
+
+        if (usec != LLONG_MIN)
+        {
+            *start = pos;
+            *next = lineEnd + 1;
+            return usec;
+        }
+
+        pos = lineEnd + 1;
+    }
+
+    return LLONG_MIN;
+}
+
+/**
+ * @brief TLogIndex::findOffset
+ * Finds the offset of the first line with a timestamp not less than
+ * \p usec. The lines are expected to be ordered by time. The search
+ * halves the range of bytes by probing the line at the middle until the
+ * range is small enough to test it line by line. So only a few pages of
+ * the file are read. If there is no timestamp between the middle and the
+ * end of the range, the first line with a timestamp after the start of
+ * the range is tested and the start moved behind it.
+ *
+ * @param usec      The wanted time in microseconds since the epoch.
+ * @param timeOf    Returns the timestamp of a line.
+ * @return The offset of the line or the size of the file if all lines are
+ * earlier.
+ */
+qint64 TLogIndex::findOffset(qint64 usec, const TIMEOF_t& timeOf) const
+{
+    DECL_TRACER("TLogIndex::findOffset(qint64 usec, const TIMEOF_t& timeOf)");
+
+    if (!mData)
+        return 0;
+
+    qint64 low = 0;                                 // Always the start of a line
+    qint64 high = mSize;
+    qint64 found = mSize;                           // The first line known to be not earlier
+    qint64 start, next;
+    int probes = 0;
+
+    while (high - low > PROBE_SPAN)
+    {
+        qint64 mid = low + (high - low) / 2;
+        qint64 t = LLONG_MIN;
+
+        // Probe forward in steps of MAX_PROBE bytes, so a long run of
+        // lines without a timestamp doesn't hide the lines behind it.
+        for (qint64 from = mid; t == LLONG_MIN && from < high; from += MAX_PROBE)
+        {
+            t = probe(from, std::min(high, from + MAX_PROBE), timeOf, &start, &next);
+            probes++;
+        }
+
+        if (t == LLONG_MIN)                         // No timestamp between mid and high
+        {
+            // The line wanted starts before mid, or is the one already found.
+            t = probe(low, mid, timeOf, &start, &next);
+            probes++;
+
+            if (t == LLONG_MIN)                     // No timestamp in the whole range
+            {
+                high = low;
+                break;
+            }
+
+            if (t >= usec)
+                return start;
+
+            low = next;
+            high = mid;
+        }
+        else if (t < usec)
+            low = next;
+        else
+        {
+            found = start;
+            high = mid;
+        }
+    }
+
+    // The remaining range is tested line by line
+    while (low < high)
+    {
+        qint64 t = probe(low, high, timeOf, &start, &next);
+
+        if (t == LLONG_MIN)
+            break;
+
+        if (t >= usec)
+            return start;
+
+        low = next;
+    }
+
+    MSG_DEBUG("Found offset of time after " << probes << " probes.");
+    return found;
+}
+
+/**
+ * @brief TLogIndex::firstTime
+ * @param timeOf    Returns the timestamp of a line.
+ * @return The timestamp of the first line having one or LLONG_MIN.
+ */
+qint64 TLogIndex::firstTime(const TIMEOF_t& timeOf) const
+{
+    qint64 start, next;
+
+    if (!mData)
+        return LLONG_MIN;
+
+    return probe(0, MAX_PROBE, timeOf, &start, &next);
+}
+
+/**
+ * @brief TLogIndex::lastTime
+ * Reads the lines at the end of the file to find the last timestamp. If
+ * there is no timestamp, the range is enlarged up to MAX_PROBE bytes.
+ *
+ * @param timeOf    Returns the timestamp of a line.
+ * @return The timestamp of the last line having one or LLONG_MIN.
+ */
+qint64 TLogIndex::lastTime(const TIMEOF_t& timeOf) const
+{
+    if (!mData)
+        return LLONG_MIN;
+
+    for (qint64 span = PROBE_SPAN; ; span *= 2)
+    {
+        qint64 pos = std::max(static_cast<qint64>(0), mSize - span);
+        qint64 last = LLONG_MIN;
+        qint64 start, next;
+
+        for (qint64 t; (t = probe(pos, mSize, timeOf, &start, &next)) != LLONG_MIN; pos = next)
+            last = t;
+
+        if (last != LLONG_MIN || span >= MAX_PROBE || span >= mSize)
+            return last;
+    }
+}
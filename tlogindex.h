@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TLOGINDEX_H
+#define TLOGINDEX_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+
+#include <vector>
+#include <functional>
+
+#include "tjsonreader.h"
+
+/**
+ * @brief The TLogIndex class
+ * Maps a logfile into memory and keeps the position of every record. A
+ * record is a line or, if a rule for the start of a record is defined, a
+ * line followed by all continuation lines (e.g. the lines of a stack trace).
+ * The file is scanned in parallel. Each thread scans a part of the file
+ * which starts at the beginning of a line.
+ *
+ * The content of a record is not copied. It is read from the mapped file
+ * only when it is needed.
+ *
+ * If a time column is configured, the timestamp of every record is kept as
+ * microseconds since the epoch (see TTimeParser). For every block of records
+ * the highest timestamp up to the end of the block is kept as well. This
+ * sequence never decreases, even if the records are only partially ordered,
+ * so a timestamp can be found by a binary search.
+ *
+ * To open only a time window of a huge file, the byte offsets of the window
+ * are searched before the file is scanned. A binary search probes the
+ * timestamps of lines at sampled offsets of the mapped file. Only the window
+ * is scanned afterwards, so only its pages are read from the disk.
+ */
+class TLogIndex
+{
+    public:
+        typedef std::function<qint64(const char *line, qint64 len)> TIMEOF_t;  // Returns the timestamp of a line or LLONG_MIN
+
+        TLogIndex();
+        ~TLogIndex();
+
+        bool open(const QString& file);
+        void close();
+        bool scan(const QString& recordStart=QString());
+        bool setWindow(qint64 from, qint64 to);
+        bool isWindow() const { return mBegin > 0 || mEnd < mSize; }
+        qint64 findOffset(qint64 usec, const TIMEOF_t& timeOf) const;
+        qint64 firstTime(const TIMEOF_t& timeOf) const;
+        qint64 lastTime(const TIMEOF_t& timeOf) const;
+        void setRecords(const std::vector<TJsonReader::RECORD_t>& records);
+
+        qsizetype size() const { return static_cast<qsizetype>(mOffsets.size()); }
+        qint64 offset(qsizetype idx) const { return mOffsets[idx]; }
+        const std::vector<qint64>& offsets() const { return mOffsets; }
+        qint64 length(qsizetype idx) const { return mLengths[idx]; }
+        const char *data() const { return mData; }
+        qint64 fileSize() const { return mSize; }
+
+        QByteArray record(qsizetype idx) const;
+        QString firstLine(qsizetype idx) const;
+        QString text(qsizetype idx) const;
+        qsizetype lineCount(qsizetype idx) const;
+
+        void setTimes(std::vector<qint64>&& times);
+        bool hasTimes() const { return !mTimes.empty(); }
+        qint64 time(qsizetype idx) const { return mTimes[idx]; }
+        qsizetype findTime(qint64 usec) const;
+
+    private:
+        typedef struct CHUNK_t
+        {
+            std::vector<qint64> offsets;        // The offsets of the records found
+            std::vector<quint32> lengths;       // The lengths of the records found
+            bool continues{false};              // TRUE = the first record continues the last record of the previous chunk
+        }CHUNK_t;
+
+        // Not copyable
+        TLogIndex(const TLogIndex&) = delete;
+        TLogIndex& operator=(const TLogIndex&) = delete;
+
+        qint64 probe(qint64 pos, qint64 limit, const TIMEOF_t& timeOf, qint64 *start, qint64 *next) const;
+        static void scanChunk(const char *data, qint64 from, qint64 to, const QString *recordStart, CHUNK_t *chunk);
+
+        QFile mFile;
+        const char *mData{nullptr};             // The mapped file
+        qint64 mSize{0};                        // The size of the mapped file
+        qint64 mBegin{0};                       // The offset of the first byte to scan
+        qint64 mEnd{0};                         // The offset after the last byte to scan
+        std::vector<qint64> mOffsets;           // The offset of every record
+        std::vector<quint32> mLengths;          // The length of every record without the line feed
+        std::vector<qint64> mTimes;             // The timestamp of every record in microseconds (TTimeParser::INVALID = none)
+        std::vector<qint64> mTimeBlocks;        // The highest timestamp up to the end of every block of records
+};
+
+#endif // TLOGINDEX_H
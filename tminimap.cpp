@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QScrollBar>
+
+#include <algorithm>
+#include <cmath>
+
+#include "tminimap.h"
+#include "tlogger.h"
+
+#define MAX_BUCKETS     4096                    // The highest number of buckets
+#define MINIMAP_WIDTH   14                      // The width of the ruler
+
+TMinimap::TMinimap(QScrollBar *scrollBar, QWidget *parent)
+    : QWidget(parent),
+      mScrollBar(scrollBar)
+{
+    DECL_TRACER("TMinimap::TMinimap(QScrollBar *scrollBar, QWidget *parent)");
+
+    setFixedWidth(MINIMAP_WIDTH);
+    setCursor(Qt::PointingHandCursor);
+    setToolTip(tr("Red: errors, orange: warnings, blue: search hits. Click to scroll there."));
+
+    if (mScrollBar)                                                         // Scrolling only moves the frame
+    {
+        connect(mScrollBar, &QScrollBar::valueChanged, this, [this]() { update(); });
+        connect(mScrollBar, &QScrollBar::rangeChanged, this, [this]() { update(); });
+    }
+}
+
+/**
+ * @brief TMinimap::reset
+ * Removes all marks and sets the number of rows shown by the table.
+ *
+ * @param rows  The number of rows.
+ */
+void TMinimap::reset(int rows)
+{
+    DECL_TRACER("TMinimap::reset(int rows)");
+
+    mRows = std::max(0, rows);
+    mBuckets = std::min(mRows, MAX_BUCKETS);
+    mCounts.assign(static_cast<size_t>(mBuckets) * MARK_MAX, 0);
+    std::fill(mMaxCount, mMaxCount + MARK_MAX, 0);
+    mDirty = true;
+}
+
+/**
+ * @brief TMinimap::add
+ * Marks a row. Call refresh() after adding the marks to show them.
+ *
+ * @param row   The row of the table (not the row of the model).
+ * @param mark  The mark.
+ */
+void TMinimap::add(int row, MARK_t mark)
+{
+    if (row < 0 || row >= mRows)
+        return;
+
+    size_t bucket = static_cast<size_t>(static_cast<qint64>(row) * mBuckets / mRows);
+    quint32& count = mCounts[bucket * MARK_MAX + mark];
+    count++;
+    mMaxCount[mark] = std::max(mMaxCount[mark], count);
+    mDirty = true;
+}
+
+/**
+ * @brief TMinimap::clear
+ * Removes all marks of one kind, e.g. the hits of the last search.
+ *
+ * @param mark  The mark to remove.
+ */
+void TMinimap::clear(MARK_t mark)
+{
+    DECL_TRACER("TMinimap::clear(MARK_t mark)");
+
+    for (size_t bucket = 0; bucket < static_cast<size_t>(mBuckets); ++bucket)
+        mCounts[bucket * MARK_MAX + mark] = 0;
+
+    mMaxCount[mark] = 0;
+    mDirty = true;
+    update();
+}
+
+void TMinimap::refresh()
+{
+    mDirty = true;
+    update();
+}
+
+void TMinimap::paintEvent(QPaintEvent *)
+{
+    if (mDirty || mImage.width() != width() || mImage.height() != height())
+        render();
+
+    QPainter painter(this);
+    painter.drawImage(0, 0, mImage);
+
+    if (!mScrollBar || mRows == 0)
+        return;
+
+    // The frame of the visible rows
+    double total = static_cast<double>(mScrollBar->maximum() - mScrollBar->minimum() + mScrollBar->pageStep());
+
+    if (total <= 0.0)
+        return;
+
+    int top = static_cast<int>((mScrollBar->value() - mScrollBar->minimum()) * height() / total);
+    int frame = std::max(3, static_cast<int>(mScrollBar->pageStep() * height() / total));
+    painter.fillRect(QRect(0, top, width(), frame), QColor(0, 0, 0, 40));
+    painter.setPen(QColor(0x40, 0x40, 0x40));
+    painter.drawRect(QRect(0, top, width() - 1, frame - 1));
+}
+
+/**
+ * @brief TMinimap::render
+ * Draws the marks into mImage. Every pixel row merges the buckets it
+ * covers. Errors are drawn over warnings, the darker the more rows of a
+ * pixel row have the mark. Search hits are drawn as a stripe at the left.
+ */
+void TMinimap::render()
+{
+    int h = std::max(1, height());
+    int w = std::max(1, width());
+
+    if (mImage.width() != w || mImage.height() != h)
+        mImage = QImage(w, h, QImage::Format_RGB32);
+
+    mImage.fill(QColor(0xf0, 0xf0, 0xf0));
+    mDirty = false;
+
+    if (mBuckets == 0)
+        return;
+
+    int stripe = std::max(3, w / 3);
+
+    for (int y = 0; y < h; ++y)
+    {
+        int from = static_cast<int>(static_cast<qint64>(y) * mBuckets / h);
+        int to = std::max(from + 1, static_cast<int>(static_cast<qint64>(y + 1) * mBuckets / h));
+        quint32 counts[MARK_MAX] = {};
+
+        for (int bucket = from; bucket < to && bucket < mBuckets; ++bucket)
+        {
+            for (int m = 0; m < MARK_MAX; ++m)
+                counts[m] += mCounts[static_cast<size_t>(bucket) * MARK_MAX + m];
+        }
+
+        QRgb *line = reinterpret_cast<QRgb *>(mImage.scanLine(y));
+        QRgb color = 0;
+
+        if (counts[MARK_ERROR] > 0 || counts[MARK_WARNING] > 0)
+        {
+            MARK_t mark = counts[MARK_ERROR] > 0 ? MARK_ERROR : MARK_WARNING;
+            double density = std::log1p(counts[mark]) / std::log1p(static_cast<double>(mMaxCount[mark]) * (to - from));
+            double alpha = 0.35 + 0.65 * std::min(1.0, density);
+            QColor base = mark == MARK_ERROR ? QColor(0xd0, 0x10, 0x10) : QColor(0xf0, 0x90, 0x00);
+            color = qRgb(static_cast<int>(0xf0 - alpha * (0xf0 - base.red())),
+                         static_cast<int>(0xf0 - alpha * (0xf0 - base.green())),
+                         static_cast<int>(0xf0 - alpha * (0xf0 - base.blue())));
+
+            for (int x = stripe; x < w; ++x)
+                line[x] = color;
+        }
+
+        if (counts[MARK_HIT] > 0)
+        {
+            for (int x = 0; x < stripe; ++x)
+                line[x] = qRgb(0x20, 0x60, 0xe0);
+        }
+    }
+}
+
+void TMinimap::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton)
+        scrollTo(static_cast<int>(event->position().y()));
+}
+
+void TMinimap::mouseMoveEvent(QMouseEvent *event)
+{
+    if (event->buttons() & Qt::LeftButton)
+        scrollTo(static_cast<int>(event->position().y()));
+}
+
+/**
+ * @brief TMinimap::scrollTo
+ * Scrolls the table so that the rows at a position of the ruler are in
+ * the middle of the table.
+ *
+ * @param y The position on the ruler.
+ */
+void TMinimap::scrollTo(int y)
+{
+    if (!mScrollBar || height() <= 0)
+        return;
+
+    double total = static_cast<double>(mScrollBar->maximum() - mScrollBar->minimum() + mScrollBar->pageStep());
+    int value = mScrollBar->minimum() + static_cast<int>(std::clamp(y, 0, height()) * total / height()) - mScrollBar->pageStep() / 2;
+    mScrollBar->setValue(std::clamp(value, mScrollBar->minimum(), mScrollBar->maximum()));
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TMINIMAP_H
+#define TMINIMAP_H
+
+#include <QWidget>
+#include <QImage>
+
+#include <vector>
+
+class QScrollBar;
+
+/**
+ * @brief The TMinimap class
+ * An overview ruler beside the table showing where errors, warnings and
+ * search hits are in the whole file, and which part is visible.
+ *
+ * The rows are aggregated into at most 4096 buckets which count the marks
+ * of their rows. The marks are added once when a file is loaded or the
+ * filter changes, and search hits are added as they are found. The ruler
+ * is drawn from the buckets into an image which is only redrawn when the
+ * marks or the size change; scrolling only moves the frame of the visible
+ * rows. A click or drag on the ruler scrolls the table.
+ */
+class TMinimap : public QWidget
+{
+        Q_OBJECT
+
+    public:
+        typedef enum MARK_t
+        {
+            MARK_ERROR,
+            MARK_WARNING,
+            MARK_HIT,
+            MARK_MAX                            // The number of marks
+        }MARK_t;
+
+        explicit TMinimap(QScrollBar *scrollBar, QWidget *parent = nullptr);
+
+        void reset(int rows);
+        void add(int row, MARK_t mark);
+        void clear(MARK_t mark);
+        void refresh();
+
+    protected:
+        void paintEvent(QPaintEvent *event) override;
+        void mousePressEvent(QMouseEvent *event) override;
+        void mouseMoveEvent(QMouseEvent *event) override;
+
+    private:
+        void render();
+        void scrollTo(int y);
+
+        QScrollBar *mScrollBar{nullptr};        // The vertical scrollbar of the table
+        int mRows{0};                           // The number of rows shown by the table
+        int mBuckets{0};                        // The number of buckets
+        std::vector<quint32> mCounts;           // The count of every mark of every bucket
+        quint32 mMaxCount[MARK_MAX]{};          // The highest count of every mark in a bucket
+        QImage mImage;                          // The rendered marks
+        bool mDirty{true};                      // TRUE = the marks changed since mImage was rendered
+};
+
+#endif // TMINIMAP_H
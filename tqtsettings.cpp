@@ -18,11 +18,19 @@
 #include <QFileDialog>
 #include <QColorDialog>
 #include <QKeyEvent>
+#include <QMessageBox>
+
+#include <filesystem>
 
 #include "tqtsettings.h"
 #include "ui_tqtsettings.h"
 #include "tconfig.h"
 #include "tlogger.h"
+#include "tjsonschema.h"
+#include "texceptiongroups.h"
+#include "expand.h"
+
+namespace fs = std::filesystem;
 
 TQtSettings::TQtSettings(QWidget *parent)
     : QDialog(parent)
@@ -49,12 +57,23 @@ TQtSettings::TQtSettings(QWidget *parent)
     mHeaders = TConfig::headers();
     mColAlign = TConfig::getColAligns();
     mColumnThreadID = TConfig::getColumnThreadID();
+    mRecordStart = TConfig::getRecordStart();
+    mLineRegex = TConfig::getLineRegex();
+    mFormat = TConfig::getFormat();
+    mTimeColumn = TConfig::getTimeColumn();
+    mTimeLayout = TConfig::getTimeLayout();
     mValues = TConfig::values();
 
     mLogfile = TConfig::getLogfile();
     mSourcePath = TConfig::getSourcePath();
     mResultPath = TConfig::getResultPath();
     mLogLevel = TConfig::getLogLevel();
+    mJsonSamples = TConfig::getJsonSamples();
+    mAutoDetect = TConfig::getAutoDetect();
+    mSearchIndex = TConfig::getSearchIndex();
+    mExceptionPattern = TConfig::getExceptionPattern();
+    mStackPattern = TConfig::getStackPattern();
+    mContextLines = TConfig::getContextLines();
 
     ui->lineEditStart->setText(mBlockEntry);
     ui->lineEditEnd->setText(mBlockExit);
@@ -79,11 +98,26 @@ TQtSettings::TQtSettings(QWidget *parent)
     ui->listWidgetColumns->addItems(mHeaders);
     ui->lineEditColAlign->setText(mColAlign);
     ui->spinBoxThreadID->setValue(mColumnThreadID);
+    ui->lineEditRecordStart->setText(mRecordStart);
+    ui->lineEditLineRegex->setText(mLineRegex);
+    TConfig::FORMAT_t format = mFormat;
+    ui->comboBoxFormat->setCurrentIndex(format);
+    on_comboBoxFormat_currentIndexChanged(format);
+    ui->spinBoxTimeColumn->setValue(mTimeColumn);
+    ui->lineEditTimeLayout->setText(mTimeLayout);
 
     ui->lineEditLogfile->setText(mLogfile);
     ui->lineEditSourcePath->setText(mSourcePath);
     ui->lineEditResultPath->setText(mResultPath);
     ui->spinBoxLogLevel->setValue(mLogLevel);
+    ui->spinBoxJsonSamples->setValue(mJsonSamples);
+    ui->checkBoxAutoDetect->setChecked(mAutoDetect);
+    ui->checkBoxSearchIndex->setChecked(mSearchIndex);
+    ui->lineEditExceptions->setText(mExceptionPattern);
+    ui->lineEditExceptions->setPlaceholderText(TExceptionGroups::defaultPattern());
+    ui->lineEditStackPattern->setText(mStackPattern);
+    ui->lineEditStackPattern->setPlaceholderText(TExceptionGroups::defaultStackPattern());
+    ui->spinBoxContextLines->setValue(mContextLines);
 }
 
 TQtSettings::~TQtSettings()
@@ -167,6 +201,12 @@ void TQtSettings::on_spinBoxColumns_valueChanged(int arg1)
         mColumnThreadID = mColumns;
         ui->spinBoxThreadID->setValue(mColumnThreadID);
     }
+
+    if (mTimeColumn > mColumns)
+    {
+        mTimeColumn = mColumns;
+        ui->spinBoxTimeColumn->setValue(mTimeColumn);
+    }
 }
 
 void TQtSettings::on_spinBoxThreadID_valueChanged(int arg1)
@@ -191,6 +231,134 @@ void TQtSettings::on_toolButtonValue_clicked()
     mValues = ts.getValues();
 }
 
+/**
+ * @brief TQtSettings::on_toolButtonDiscover_clicked
+ * Asks for a JSON logfile and samples it to find the keys of the records.
+ * The found keys are shown to the user. If the user accepts them, they
+ * replace the configured values, headers, alignments and the thread column.
+ */
+void TQtSettings::on_toolButtonDiscover_clicked()
+{
+    DECL_TRACER("TQtSettings::on_toolButtonDiscover_clicked()");
+
+    QString file = QFileDialog::getOpenFileName(this, tr("Discover JSON values"), TConfig::lastOpenPath(), tr("JSon (*.json *.log *.dat *.gz);;All (*)"));
+
+    if (file.isEmpty())
+        return;
+
+    QString target = file;
+
+    if (file.endsWith(".gz"))
+    {
+        QString f = file.mid(file.lastIndexOf("/") + 1);
+        Expand exp(file.toStdString());
+        target = QString("/tmp/%1.discover").arg(f);
+
+        if (fs::exists(target.toStdString()))
+            fs::remove(target.toStdString());
+
+        exp.setTemporaryFileName(target.toStdString());
+
+        if (exp.unzip(false) == -1)
+        {
+            QMessageBox::critical(this, windowTitle(), tr("Error unzipping file ")+f);
+            return;
+        }
+    }
+
+    TJsonSchema schema(mJsonSamples);
+    bool ok = schema.discover(target);
+
+    if (target != file && fs::exists(target.toStdString()))
+        fs::remove(target.toStdString());
+
+    if (!ok)
+    {
+        QMessageBox::warning(this, windowTitle(), tr("No JSON records found in file <i>%1</i>!").arg(file));
+        return;
+    }
+
+    QList<TValueSelect::VALUES_t> values = schema.proposeValues();
+
+    if (values.size() < ui->spinBoxColumns->minimum())
+    {
+        QMessageBox::warning(this, windowTitle(), tr("Not enough values were found often enough to become a column!"));
+        return;
+    }
+
+    // Keep the message in the last column if there are more values than
+    // the table can have columns.
+    while (values.size() > ui->spinBoxColumns->maximum())
+        values.removeAt(values.size() - 2);
+
+    QString msg = schema.report() + tr("<p>Apply the proposed columns?</p>");
+
+    if (QMessageBox::question(this, windowTitle(), msg) != QMessageBox::Yes)
+        return;
+
+    // The values and headers must be set before the number of columns is
+    // changed, because the slot of the spin box adds or removes entries
+    // only if the number differs from the current one.
+    mValues = values;
+    mHeaders = schema.proposeHeaders(values);
+    mColumns = static_cast<int>(values.size());
+    ui->spinBoxColumns->setValue(mColumns);
+    ui->listWidgetColumns->clear();
+    ui->listWidgetColumns->addItems(mHeaders);
+    mColAlign = schema.proposeColAligns(values);
+    ui->lineEditColAlign->setText(mColAlign);
+    int thread = schema.proposeThreadColumn(values);
+
+    if (thread > 0)
+    {
+        mColumnThreadID = thread;
+        ui->spinBoxThreadID->setValue(mColumnThreadID);
+    }
+}
+
+void TQtSettings::on_lineEditRecordStart_textChanged(const QString &arg1)
+{
+    DECL_TRACER("TQtSettings::on_lineEditRecordStart_textChanged(const QString &arg1)");
+
+    mRecordStart = arg1;
+}
+
+void TQtSettings::on_lineEditLineRegex_textChanged(const QString &arg1)
+{
+    DECL_TRACER("TQtSettings::on_lineEditLineRegex_textChanged(const QString &arg1)");
+
+    mLineRegex = arg1;
+}
+
+void TQtSettings::on_comboBoxFormat_currentIndexChanged(int index)
+{
+    DECL_TRACER("TQtSettings::on_comboBoxFormat_currentIndexChanged(int index)");
+
+    if (index < TConfig::FORMAT_DELIMITED || index > TConfig::FORMAT_JSON)
+        return;
+
+    mFormat = static_cast<TConfig::FORMAT_t>(index);
+    ui->lineEditLineRegex->setEnabled(mFormat == TConfig::FORMAT_REGEX);
+    ui->lineEditDelimeter->setEnabled(mFormat == TConfig::FORMAT_DELIMITED || mFormat == TConfig::FORMAT_JSON);
+}
+
+void TQtSettings::on_spinBoxTimeColumn_valueChanged(int arg1)
+{
+    DECL_TRACER("TQtSettings::on_spinBoxTimeColumn_valueChanged(int arg1)");
+
+    if (arg1 <= mColumns)
+        mTimeColumn = arg1;
+    else
+        ui->spinBoxTimeColumn->setValue(mTimeColumn);
+}
+
+void TQtSettings::on_lineEditTimeLayout_textChanged(const QString &arg1)
+{
+    DECL_TRACER("TQtSettings::on_lineEditTimeLayout_textChanged(const QString &arg1)");
+
+    mTimeLayout = arg1;
+}
+
 void TQtSettings::on_lineEditLogfile_textChanged(const QString &arg1)
 {
     mLogfile = arg1;
@@ -254,6 +422,48 @@ void TQtSettings::on_spinBoxLogLevel_valueChanged(int arg1)
     mLogLevel = arg1;
 }
 
+void TQtSettings::on_spinBoxJsonSamples_valueChanged(int arg1)
+{
+    DECL_TRACER("TQtSettings::on_spinBoxJsonSamples_valueChanged(int arg1)");
+
+    mJsonSamples = arg1;
+}
+
+void TQtSettings::on_checkBoxAutoDetect_toggled(bool checked)
+{
+    DECL_TRACER("TQtSettings::on_checkBoxAutoDetect_toggled(bool checked)");
+
+    mAutoDetect = checked;
+}
+
+void TQtSettings::on_checkBoxSearchIndex_toggled(bool checked)
+{
+    DECL_TRACER("TQtSettings::on_checkBoxSearchIndex_toggled(bool checked)");
+
+    mSearchIndex = checked;
+}
+
+void TQtSettings::on_lineEditExceptions_textChanged(const QString &arg1)
+{
+    DECL_TRACER("TQtSettings::on_lineEditExceptions_textChanged(const QString &arg1)");
+
+    mExceptionPattern = arg1;
+}
+
+void TQtSettings::on_lineEditStackPattern_textChanged(const QString &arg1)
+{
+    DECL_TRACER("TQtSettings::on_lineEditStackPattern_textChanged(const QString &arg1)");
+
+    mStackPattern = arg1;
+}
+
+void TQtSettings::on_spinBoxContextLines_valueChanged(int arg1)
+{
+    DECL_TRACER("TQtSettings::on_spinBoxContextLines_valueChanged(int arg1)");
+
+    mContextLines = arg1;
+}
+
 void TQtSettings::on_lineEditTrace_textChanged(const QString &arg1)
 {
     DECL_TRACER("TQtSettings::on_lineEditTrace_textChanged(const QString &arg1)");
@@ -390,9 +600,20 @@ void TQtSettings::saveValues()
     TConfig::setHeaders(mHeaders);
     TConfig::setColAligns(mColAlign);
     TConfig::setColumnThreadID(mColumnThreadID);
+    TConfig::setRecordStart(mRecordStart);
+    TConfig::setLineRegex(mLineRegex);
+    TConfig::setFormat(mFormat);
+    TConfig::setTimeColumn(mTimeColumn);
+    TConfig::setTimeLayout(mTimeLayout);
     TConfig::setValues(mValues);
     TConfig::setSourcePath(mSourcePath);
     TConfig::setResultPath(mResultPath);
+    TConfig::setJsonSamples(mJsonSamples);
+    TConfig::setAutoDetect(mAutoDetect);
+    TConfig::setSearchIndex(mSearchIndex);
+    TConfig::setExceptionPattern(mExceptionPattern);
+    TConfig::setStackPattern(mStackPattern);
+    TConfig::setContextLines(mContextLines);
 
     if (mLogfile != TConfig::getLogfile())
     {
@@ -406,6 +627,7 @@ void TQtSettings::saveValues()
         TLogger::setLogLevel(static_cast<LOG_LEVEL_t>(mLogLevel));
     }
 
+    TConfig::discardFormat();                   // The shown format was confirmed, even if it was detected
     TConfig::saveConfig();
 }
 
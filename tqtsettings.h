@@ -21,6 +21,7 @@
 #include <QDialog>
 
 #include "tvalueselect.h"
+#include "tconfig.h"
 
 namespace Ui {
 class TQtSettings;
@@ -61,11 +62,23 @@ class TQtSettings : public QDialog
         void on_lineEditColAlign_textChanged(const QString &arg1);
         void on_spinBoxThreadID_valueChanged(int arg1);
         void on_toolButtonValue_clicked();
+        void on_toolButtonDiscover_clicked();
+        void on_lineEditRecordStart_textChanged(const QString &arg1);
+        void on_lineEditLineRegex_textChanged(const QString &arg1);
+        void on_comboBoxFormat_currentIndexChanged(int index);
+        void on_spinBoxTimeColumn_valueChanged(int arg1);
+        void on_lineEditTimeLayout_textChanged(const QString &arg1);
 
         void on_lineEditLogfile_textChanged(const QString &arg1);
         void on_lineEditResultPath_textChanged(const QString &arg1);
         void on_lineEditSourcePath_textChanged(const QString &arg1);
         void on_spinBoxLogLevel_valueChanged(int arg1);
+        void on_spinBoxJsonSamples_valueChanged(int arg1);
+        void on_checkBoxAutoDetect_toggled(bool checked);
+        void on_checkBoxSearchIndex_toggled(bool checked);
+        void on_lineEditExceptions_textChanged(const QString &arg1);
+        void on_lineEditStackPattern_textChanged(const QString &arg1);
+        void on_spinBoxContextLines_valueChanged(int arg1);
 
         void on_toolButtonLogfile_clicked();
         void on_toolButtonResultPath_clicked();
@@ -92,11 +105,22 @@ class TQtSettings : public QDialog
         QStringList mHeaders;
         QString mColAlign;
         int mColumnThreadID{0};
+        QString mRecordStart;
+        QString mLineRegex;
+        TConfig::FORMAT_t mFormat{TConfig::FORMAT_DELIMITED};
+        int mTimeColumn{0};
+        QString mTimeLayout;
 
         QString mLogfile;
         QString mSourcePath;
         QString mResultPath;
         int mLogLevel{0};
+        int mJsonSamples{1000};
+        bool mAutoDetect{true};
+        bool mSearchIndex{false};
+        QString mExceptionPattern;
+        QString mStackPattern;
+        int mContextLines{3};
         QListWidgetItem *mLastEditItem{nullptr};
         QList<TValueSelect::VALUES_t> mValues;
 };
@@ -0,0 +1,615 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+#include <iterator>
+
+#include "trowbitmap.h"
+
+using std::vector;
+
+/**
+ * @brief TRowBitmap::fromWords
+ * Compresses a plain bitmap.
+ *
+ * @param words The bitmap. Bit n of word n / 64 belongs to row n.
+ * @return The set of rows.
+ */
+TRowBitmap TRowBitmap::fromWords(const vector<quint64>& words)
+{
+    TRowBitmap result;
+
+    for (size_t first = 0; first < words.size(); first += WORDS)
+    {
+        size_t last = std::min(first + WORDS, words.size());
+        quint32 count = 0;
+
+        for (size_t w = first; w < last; ++w)
+            count += qPopulationCount(words[w]);
+
+        if (!count)
+            continue;
+
+        CHUNK_t chunk;
+        chunk.key = static_cast<quint16>(first / WORDS);
+        chunk.count = count;
+        chunk.bits.assign(WORDS, 0);
+        std::copy(words.begin() + first, words.begin() + last, chunk.bits.begin());
+        shrink(chunk);
+        result.mChunks.push_back(std::move(chunk));
+    }
+
+    return result;
+}
+
+/**
+ * @brief TRowBitmap::range
+ * @param from  The first row.
+ * @param to    The row after the last row.
+ * @return A set containing all rows from \p from to \p to - 1.
+ */
+TRowBitmap TRowBitmap::range(quint32 from, quint32 to)
+{
+    TRowBitmap result;
+
+    if (from >= to)
+        return result;
+
+    for (quint64 base = from & ~0xffffU; base < to; base += 0x10000)
+    {
+        quint32 lo = static_cast<quint32>(std::max<quint64>(from, base) - base);
+        quint32 hi = static_cast<quint32>(std::min<quint64>(to, base + 0x10000) - base);
+        CHUNK_t chunk;
+        chunk.key = static_cast<quint16>(base >> 16);
+        chunk.count = hi - lo;
+
+        if (chunk.count <= MAX_ARRAY)
+        {
+            for (quint32 low = lo; low < hi; ++low)
+                chunk.array.push_back(static_cast<quint16>(low));
+        }
+        else
+        {
+            chunk.bits.assign(WORDS, 0);
+
+            for (quint32 w = lo / 64; w <= (hi - 1) / 64; ++w)
+            {
+                quint32 first = std::max(lo, w * 64);
+                quint32 last = std::min(hi, w * 64 + 64);
+                quint64 mask = (last - first == 64) ? ~0ULL : ((1ULL << (last - first)) - 1) << (first - w * 64);
+                chunk.bits[w] |= mask;
+            }
+        }
+
+        result.mChunks.push_back(std::move(chunk));
+    }
+
+    return result;
+}
+
+/**
+ * @brief TRowBitmap::add
+ * Adds a row. Adding the rows in ascending order is the fastest way to
+ * build a set.
+ *
+ * @param row   The row.
+ */
+void TRowBitmap::add(quint32 row)
+{
+    quint16 key = static_cast<quint16>(row >> 16);
+    quint16 low = static_cast<quint16>(row & 0xffff);
+    size_t idx = (!mChunks.empty() && mChunks.back().key <= key) ? mChunks.size() - (mChunks.back().key == key ? 1 : 0) : find(key);
+
+    if (idx == mChunks.size() || mChunks[idx].key != key)
+    {
+        CHUNK_t chunk;
+        chunk.key = key;
+        mChunks.insert(mChunks.begin() + idx, std::move(chunk));
+    }
+
+    CHUNK_t& chunk = mChunks[idx];
+
+    if (!chunk.bits.empty())
+    {
+        quint64 bit = 1ULL << (low % 64);
+
+        if (chunk.bits[low / 64] & bit)
+            return;
+
+        chunk.bits[low / 64] |= bit;
+        chunk.count++;
+        return;
+    }
+
+    if (chunk.array.empty() || chunk.array.back() < low)
+        chunk.array.push_back(low);
+    else
+    {
+        auto iter = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+
+        if (iter != chunk.array.end() && *iter == low)
+            return;
+
+        chunk.array.insert(iter, low);
+    }
+
+    chunk.count++;
+
+    if (chunk.count > MAX_ARRAY)
+        toBitmap(chunk);
+}
+
+bool TRowBitmap::contains(quint32 row) const
+{
+    size_t idx = find(static_cast<quint16>(row >> 16));
+
+    if (idx == mChunks.size() || mChunks[idx].key != (row >> 16))
+        return false;
+
+    return chunkContains(mChunks[idx], static_cast<quint16>(row & 0xffff));
+}
+
+qint64 TRowBitmap::cardinality() const
+{
+    qint64 total = 0;
+
+    for (const CHUNK_t& chunk : mChunks)
+        total += chunk.count;
+
+    return total;
+}
+
+/**
+ * @brief TRowBitmap::rank
+ * @param row   A row.
+ * @return The number of rows of the set less than \p row.
+ */
+qint64 TRowBitmap::rank(quint32 row) const
+{
+    quint16 key = static_cast<quint16>(row >> 16);
+    quint16 low = static_cast<quint16>(row & 0xffff);
+    qint64 total = 0;
+
+    for (const CHUNK_t& chunk : mChunks)
+    {
+        if (chunk.key < key)
+        {
+            total += chunk.count;
+            continue;
+        }
+
+        if (chunk.key > key)
+            break;
+
+        if (chunk.bits.empty())
+            return total + (std::lower_bound(chunk.array.begin(), chunk.array.end(), low) - chunk.array.begin());
+
+        for (size_t w = 0; w < low / 64u; ++w)
+            total += qPopulationCount(chunk.bits[w]);
+
+        if (low % 64)
+            total += qPopulationCount(chunk.bits[low / 64] & ((1ULL << (low % 64)) - 1));
+
+        break;
+    }
+
+    return total;
+}
+
+/**
+ * @brief TRowBitmap::select
+ * @param pos   A position in the set (0 based).
+ * @return The row at the position or -1 if the set is smaller.
+ */
+qint64 TRowBitmap::select(qint64 pos) const
+{
+    if (pos < 0)
+        return -1;
+
+    for (const CHUNK_t& chunk : mChunks)
+    {
+        if (pos >= chunk.count)
+        {
+            pos -= chunk.count;
+            continue;
+        }
+
+        qint64 base = static_cast<qint64>(chunk.key) << 16;
+
+        if (chunk.bits.empty())
+            return base | chunk.array[pos];
+
+        for (size_t w = 0; w < WORDS; ++w)
+        {
+            quint64 word = chunk.bits[w];
+            qint64 count = qPopulationCount(word);
+
+            if (pos >= count)
+            {
+                pos -= count;
+                continue;
+            }
+
+            while (pos-- > 0)
+                word &= word - 1;
+
+            return base | static_cast<qint64>(w * 64 + qCountTrailingZeroBits(word));
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief TRowBitmap::next
+ * @param row   A row.
+ * @return The first row of the set at or after \p row or -1 if there is
+ * none.
+ */
+qint64 TRowBitmap::next(quint32 row) const
+{
+    quint16 key = static_cast<quint16>(row >> 16);
+
+    for (size_t idx = find(key); idx < mChunks.size(); ++idx)
+    {
+        const CHUNK_t& chunk = mChunks[idx];
+        quint32 start = (chunk.key == key) ? (row & 0xffff) : 0;
+        qint64 base = static_cast<qint64>(chunk.key) << 16;
+
+        if (chunk.bits.empty())
+        {
+            auto iter = std::lower_bound(chunk.array.begin(), chunk.array.end(), start);
+
+            if (iter != chunk.array.end())
+                return base | *iter;
+
+            continue;
+        }
+
+        quint64 word = chunk.bits[start / 64] & (~0ULL << (start % 64));
+
+        for (size_t w = start / 64; ; )
+        {
+            if (word)
+                return base | static_cast<qint64>(w * 64 + qCountTrailingZeroBits(word));
+
+            if (++w >= WORDS)
+                break;
+
+            word = chunk.bits[w];
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief TRowBitmap::previous
+ * @param row   A row.
+ * @return The last row of the set before \p row or -1 if there is none.
+ */
+qint64 TRowBitmap::previous(quint32 row) const
+{
+    if (row == 0 || mChunks.empty())
+        return -1;
+
+    quint32 target = row - 1;                       // The last row to consider
+    quint16 key = static_cast<quint16>(target >> 16);
+    size_t idx = find(key);
+
+    if (idx == mChunks.size() || mChunks[idx].key != key)
+    {
+        if (idx == 0)
+            return -1;
+
+        idx--;
+    }
+
+    for (size_t i = idx + 1; i-- > 0; )
+    {
+        const CHUNK_t& chunk = mChunks[i];
+        quint32 start = (chunk.key == key) ? (target & 0xffff) : 0xffff;
+        qint64 base = static_cast<qint64>(chunk.key) << 16;
+
+        if (chunk.bits.empty())
+        {
+            auto iter = std::upper_bound(chunk.array.begin(), chunk.array.end(), start);
+
+            if (iter != chunk.array.begin())
+                return base | *(iter - 1);
+
+            continue;
+        }
+
+        quint64 word = chunk.bits[start / 64] & (~0ULL >> (63 - start % 64));
+
+        for (size_t w = start / 64; ; )
+        {
+            if (word)
+                return base | static_cast<qint64>(w * 64 + 63 - qCountLeadingZeroBits(word));
+
+            if (w-- == 0)
+                break;
+
+            word = chunk.bits[w];
+        }
+    }
+
+    return -1;
+}
+
+size_t TRowBitmap::memoryUsage() const
+{
+    size_t total = mChunks.capacity() * sizeof(CHUNK_t);
+
+    for (const CHUNK_t& chunk : mChunks)
+        total += chunk.array.capacity() * sizeof(quint16) + chunk.bits.capacity() * sizeof(quint64);
+
+    return total;
+}
+
+TRowBitmap& TRowBitmap::operator&=(const TRowBitmap& other)
+{
+    vector<CHUNK_t> result;
+    size_t j = 0;
+
+    for (CHUNK_t& chunk : mChunks)
+    {
+        while (j < other.mChunks.size() && other.mChunks[j].key < chunk.key)
+            j++;
+
+        if (j == other.mChunks.size())
+            break;
+
+        if (other.mChunks[j].key != chunk.key)
+            continue;
+
+        chunkAnd(chunk, other.mChunks[j]);
+
+        if (chunk.count)
+            result.push_back(std::move(chunk));
+    }
+
+    mChunks = std::move(result);
+    return *this;
+}
+
+TRowBitmap& TRowBitmap::operator|=(const TRowBitmap& other)
+{
+    vector<CHUNK_t> result;
+    result.reserve(mChunks.size() + other.mChunks.size());
+    size_t i = 0, j = 0;
+
+    while (i < mChunks.size() || j < other.mChunks.size())
+    {
+        if (j == other.mChunks.size() || (i < mChunks.size() && mChunks[i].key < other.mChunks[j].key))
+            result.push_back(std::move(mChunks[i++]));
+        else if (i == mChunks.size() || other.mChunks[j].key < mChunks[i].key)
+            result.push_back(other.mChunks[j++]);
+        else
+        {
+            chunkOr(mChunks[i], other.mChunks[j++]);
+            result.push_back(std::move(mChunks[i++]));
+        }
+    }
+
+    mChunks = std::move(result);
+    return *this;
+}
+
+/**
+ * @brief TRowBitmap::andNot
+ * Removes all rows of another set.
+ *
+ * @param other The rows to remove.
+ * @return This set.
+ */
+TRowBitmap& TRowBitmap::andNot(const TRowBitmap& other)
+{
+    vector<CHUNK_t> result;
+    size_t j = 0;
+
+    for (CHUNK_t& chunk : mChunks)
+    {
+        while (j < other.mChunks.size() && other.mChunks[j].key < chunk.key)
+            j++;
+
+        if (j < other.mChunks.size() && other.mChunks[j].key == chunk.key)
+            chunkAndNot(chunk, other.mChunks[j]);
+
+        if (chunk.count)
+            result.push_back(std::move(chunk));
+    }
+
+    mChunks = std::move(result);
+    return *this;
+}
+
+/**
+ * @brief TRowBitmap::flipped
+ * @param rows  The number of rows of the table.
+ * @return The rows from 0 to \p rows - 1 not contained in this set.
+ */
+TRowBitmap TRowBitmap::flipped(quint32 rows) const
+{
+    TRowBitmap result = range(0, rows);
+    result.andNot(*this);
+    return result;
+}
+
+size_t TRowBitmap::find(quint16 key) const
+{
+    auto iter = std::lower_bound(mChunks.begin(), mChunks.end(), key, [](const CHUNK_t& chunk, quint16 k) { return chunk.key < k; });
+    return static_cast<size_t>(iter - mChunks.begin());
+}
+
+void TRowBitmap::toBitmap(CHUNK_t& chunk)
+{
+    if (!chunk.bits.empty())
+        return;
+
+    chunk.bits.assign(WORDS, 0);
+
+    for (quint16 low : chunk.array)
+        chunk.bits[low / 64] |= 1ULL << (low % 64);
+
+    vector<quint16>().swap(chunk.array);
+}
+
+/**
+ * @brief TRowBitmap::shrink
+ * Converts a bitmap chunk into an array, if it holds only a few rows.
+ * The count of the chunk must be correct.
+ *
+ * @param chunk The chunk.
+ */
+void TRowBitmap::shrink(CHUNK_t& chunk)
+{
+    if (chunk.bits.empty() || chunk.count > MAX_ARRAY)
+        return;
+
+    chunk.array.clear();
+    chunk.array.reserve(chunk.count);
+
+    for (size_t w = 0; w < WORDS; ++w)
+    {
+        quint64 word = chunk.bits[w];
+
+        while (word)
+        {
+            chunk.array.push_back(static_cast<quint16>(w * 64 + qCountTrailingZeroBits(word)));
+            word &= word - 1;
+        }
+    }
+
+    vector<quint64>().swap(chunk.bits);
+}
+
+bool TRowBitmap::chunkContains(const CHUNK_t& chunk, quint16 low)
+{
+    if (!chunk.bits.empty())
+        return (chunk.bits[low / 64] >> (low % 64)) & 1;
+
+    return std::binary_search(chunk.array.begin(), chunk.array.end(), low);
+}
+
+void TRowBitmap::chunkAnd(CHUNK_t& chunk, const CHUNK_t& other)
+{
+    if (chunk.bits.empty())
+    {
+        if (other.bits.empty())
+        {
+            vector<quint16> result;
+            std::set_intersection(chunk.array.begin(), chunk.array.end(), other.array.begin(), other.array.end(), std::back_inserter(result));
+            chunk.array = std::move(result);
+        }
+        else
+            chunk.array.erase(std::remove_if(chunk.array.begin(), chunk.array.end(), [&other](quint16 low) { return !chunkContains(other, low); }), chunk.array.end());
+
+        chunk.count = static_cast<quint32>(chunk.array.size());
+        return;
+    }
+
+    if (other.bits.empty())                         // The result is not larger than the array
+    {
+        vector<quint16> result;
+
+        for (quint16 low : other.array)
+        {
+            if (chunkContains(chunk, low))
+                result.push_back(low);
+        }
+
+        vector<quint64>().swap(chunk.bits);
+        chunk.array = std::move(result);
+        chunk.count = static_cast<quint32>(chunk.array.size());
+        return;
+    }
+
+    chunk.count = 0;
+
+    for (size_t w = 0; w < WORDS; ++w)
+    {
+        chunk.bits[w] &= other.bits[w];
+        chunk.count += qPopulationCount(chunk.bits[w]);
+    }
+
+    shrink(chunk);
+}
+
+void TRowBitmap::chunkOr(CHUNK_t& chunk, const CHUNK_t& other)
+{
+    if (chunk.bits.empty() && other.bits.empty())
+    {
+        vector<quint16> result;
+        result.reserve(chunk.array.size() + other.array.size());
+        std::set_union(chunk.array.begin(), chunk.array.end(), other.array.begin(), other.array.end(), std::back_inserter(result));
+        chunk.array = std::move(result);
+        chunk.count = static_cast<quint32>(chunk.array.size());
+
+        if (chunk.count > MAX_ARRAY)
+            toBitmap(chunk);
+
+        return;
+    }
+
+    toBitmap(chunk);
+
+    if (other.bits.empty())
+    {
+        for (quint16 low : other.array)
+            chunk.bits[low / 64] |= 1ULL << (low % 64);
+    }
+    else
+    {
+        for (size_t w = 0; w < WORDS; ++w)
+            chunk.bits[w] |= other.bits[w];
+    }
+
+    chunk.count = 0;
+
+    for (size_t w = 0; w < WORDS; ++w)
+        chunk.count += qPopulationCount(chunk.bits[w]);
+}
+
+void TRowBitmap::chunkAndNot(CHUNK_t& chunk, const CHUNK_t& other)
+{
+    if (chunk.bits.empty())
+    {
+        chunk.array.erase(std::remove_if(chunk.array.begin(), chunk.array.end(), [&other](quint16 low) { return chunkContains(other, low); }), chunk.array.end());
+        chunk.count = static_cast<quint32>(chunk.array.size());
+        return;
+    }
+
+    if (other.bits.empty())
+    {
+        for (quint16 low : other.array)
+            chunk.bits[low / 64] &= ~(1ULL << (low % 64));
+    }
+    else
+    {
+        for (size_t w = 0; w < WORDS; ++w)
+            chunk.bits[w] &= ~other.bits[w];
+    }
+
+    chunk.count = 0;
+
+    for (size_t w = 0; w < WORDS; ++w)
+        chunk.count += qPopulationCount(chunk.bits[w]);
+
+    shrink(chunk);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TROWBITMAP_H
+#define TROWBITMAP_H
+
+#include <QtAlgorithms>
+
+#include <vector>
+
+/**
+ * @brief The TRowBitmap class
+ * A compressed set of rows. The rows are split into chunks of 65536 rows
+ * sharing the upper 16 bits. A chunk holding only a few rows keeps them
+ * as a sorted array of the lower 16 bits (2 bytes per row). A chunk with
+ * more than 4096 rows keeps a bitmap of 8 KB instead. Empty chunks are not
+ * stored at all. This is the layout of "Roaring" bitmaps.
+ *
+ * Therefore a set costs at most about one bit per row of the table and
+ * much less if it is sparse. The set operations work chunk by chunk on
+ * whole words. rank() and select() map between a row and its position in
+ * the set, so a row set can be navigated like a sorted list.
+ */
+class TRowBitmap
+{
+    public:
+        TRowBitmap() = default;
+
+        static TRowBitmap fromWords(const std::vector<quint64>& words);
+        static TRowBitmap range(quint32 from, quint32 to);
+
+        void add(quint32 row);
+        bool contains(quint32 row) const;
+        void clear() { mChunks.clear(); }
+        bool isEmpty() const { return mChunks.empty(); }
+        qint64 cardinality() const;
+        qint64 rank(quint32 row) const;
+        qint64 select(qint64 pos) const;
+        qint64 next(quint32 row) const;
+        qint64 previous(quint32 row) const;
+        size_t memoryUsage() const;
+
+        TRowBitmap& operator&=(const TRowBitmap& other);
+        TRowBitmap& operator|=(const TRowBitmap& other);
+        TRowBitmap& andNot(const TRowBitmap& other);
+        TRowBitmap flipped(quint32 rows) const;
+
+        /**
+         * @brief forEach
+         * Calls a function for every row of the set in ascending order.
+         *
+         * @param func  The function receiving the row as quint32.
+         */
+        template<typename F> void forEach(F func) const
+        {
+            for (const CHUNK_t& chunk : mChunks)
+            {
+                quint32 base = static_cast<quint32>(chunk.key) << 16;
+
+                if (chunk.bits.empty())
+                {
+                    for (quint16 low : chunk.array)
+                        func(base | low);
+
+                    continue;
+                }
+
+                for (size_t w = 0; w < WORDS; ++w)
+                {
+                    quint64 word = chunk.bits[w];
+
+                    while (word)
+                    {
+                        func(base | static_cast<quint32>(w * 64 + qCountTrailingZeroBits(word)));
+                        word &= word - 1;
+                    }
+                }
+            }
+        }
+
+    private:
+        static constexpr size_t WORDS = 1024;           // The words of a bitmap chunk (65536 rows)
+        static constexpr size_t MAX_ARRAY = 4096;       // The most rows kept as array
+
+        typedef struct CHUNK_t
+        {
+            quint16 key{0};                     // The upper 16 bits of the rows
+            quint32 count{0};                   // The number of rows in the chunk
+            std::vector<quint16> array;         // The sorted lower 16 bits, if the chunk is sparse
+            std::vector<quint64> bits;          // The bitmap of the rows, if the chunk is dense
+        }CHUNK_t;
+
+        size_t find(quint16 key) const;
+        static void toBitmap(CHUNK_t& chunk);
+        static void shrink(CHUNK_t& chunk);
+        static bool chunkContains(const CHUNK_t& chunk, quint16 low);
+        static void chunkAnd(CHUNK_t& chunk, const CHUNK_t& other);
+        static void chunkOr(CHUNK_t& chunk, const CHUNK_t& other);
+        static void chunkAndNot(CHUNK_t& chunk, const CHUNK_t& other);
+
+        std::vector<CHUNK_t> mChunks;           // The non empty chunks, sorted by key
+};
+
+#endif // TROWBITMAP_H
@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <thread>
+#include <algorithm>
+#include <cstring>
+
+#include "tsearch.h"
+#include "tlogindex.h"
+#include "tlineparser.h"
+#include "tlogger.h"
+
+#define PART_SIZE       (8 * 1024 * 1024)   // Number of bytes of a part searched by a thread in one go
+#define PART_RANGES     256                 // Maximum number of candidate ranges of a part
+#define MATCH_LIMIT     1000000             // Maximum number of backtracking steps of a regular expression for one record
+
+using std::vector;
+using std::thread;
+
+/**
+ * @brief byteRank
+ * Estimates how often a byte occurs in a typical logfile. Blanks, digits
+ * (timestamps) and lower case letters are frequent, most other bytes are
+ * rare.
+ *
+ * @param c     The byte.
+ * @return A rank; the higher the more frequent.
+ */
+static int byteRank(unsigned char c)
+{
+    static const char *frequent = " 0123456789:.-etaoinsrlhdcu,/_mfpgTEIRNSAOyb=[]wvkDCL";
+    const char *p = strchr(frequent, c);
+
+    if (c == 0 || !p)
+        return 0;
+
+    return static_cast<int>(strlen(frequent) - (p - frequent));
+}
+
+TSearch::TSearch(const TLogIndex *index)
+    : mIndex(index)
+{
+    DECL_TRACER("TSearch::TSearch(const TLogIndex *index)");
+}
+
+TSearch::~TSearch()
+{
+    DECL_TRACER("TSearch::~TSearch()");
+
+    mCanceled = true;
+
+    if (mThread.joinable())
+        mThread.join();
+}
+
+/**
+ * @brief TSearch::setText
+ * Sets the string to search for.
+ *
+ * @param text  The string. The search is case sensitive. An empty string
+ * matches every record.
+ */
+void TSearch::setText(const QString& text)
+{
+    DECL_TRACER("TSearch::setText(const QString& text)");
+
+    mNeedle = text.toUtf8();
+    mRare = rarestByte(mNeedle.constData(), mNeedle.size());
+    mPattern.clear();
+}
+
+/**
+ * @brief TSearch::setRegex
+ * Sets a regular expression to search for. The expression may match
+ * anywhere in a record; ^ and $ match at the start and end of every line.
+ *
+ * @param pattern           The regular expression.
+ * @param caseInsensitive   TRUE = ignore the case of letters.
+ * @return If the expression is not valid, FALSE is returned.
+ */
+bool TSearch::setRegex(const QString& pattern, bool caseInsensitive)
+{
+    DECL_TRACER("TSearch::setRegex(const QString& pattern, bool caseInsensitive)");
+
+    mOptions = QRegularExpression::MultilineOption;
+
+    if (caseInsensitive)
+        mOptions |= QRegularExpression::CaseInsensitiveOption;
+
+    QRegularExpression re(pattern, mOptions);
+
+    if (pattern.isEmpty() || !re.isValid())
+    {
+        mError = pattern.isEmpty() ? QString("Empty expression") : QString("%1 at offset %2").arg(re.errorString()).arg(re.patternErrorOffset());
+        MSG_ERROR("Invalid search expression: " << mError.toStdString());
+        return false;
+    }
+
+    mPattern = pattern;
+    // The literal is compared case sensitive, so it can't be used otherwise
+    mNeedle = caseInsensitive ? QByteArray() : TLineParser::requiredLiteral(pattern).toUtf8();
+    mRare = rarestByte(mNeedle.constData(), mNeedle.size());
+    MSG_DEBUG("Search expression prefilter literal: \"" << mNeedle.toStdString() << "\"");
+    return true;
+}
+
+/**
+ * @brief TSearch::rarestByte
+ * @param needle    The string to search for.
+ * @param nlen      The length of the string.
+ * @return The position of the byte expected to be the rarest in a logfile.
+ */
+qint64 TSearch::rarestByte(const char *needle, qint64 nlen)
+{
+    qint64 rare = 0;
+
+    for (qint64 i = 1; i < nlen; ++i)
+    {
+        if (byteRank(needle[i]) < byteRank(needle[rare]))
+            rare = i;
+    }
+
+    return rare;
+}
+
+/**
+ * @brief TSearch::findLiteral
+ * Finds the first occurrence of \p needle in \p hay. The byte at position
+ * \p rare of the needle is searched by memchr() and the needle is compared
+ * only where this byte was found.
+ *
+ * @param hay       The bytes to search.
+ * @param len       The number of bytes.
+ * @param needle    The string to search for.
+ * @param nlen      The length of the string.
+ * @param rare      The position of the rarest byte of the needle.
+ * @return A pointer to the first occurrence or NULL.
+ */
+const char *TSearch::findLiteral(const char *hay, qint64 len, const char *needle, qint64 nlen, qint64 rare)
+{
+    if (nlen == 0)
+        return hay;
+
+    if (len < nlen)
+        return nullptr;
+
+    const char *p = hay + rare;
+    const char *end = hay + len - nlen + rare + 1;  // Positions of the rare byte where the needle still fits
+
+    while (p < end)
+    {
+        p = static_cast<const char *>(memchr(p, needle[rare], end - p));
+
+        if (!p)
+            return nullptr;
+
+        const char *start = p - rare;
+
+        if (memcmp(start, needle, nlen) == 0)
+            return start;
+
+        p++;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief TSearch::addRange
+ * Adds records to the candidates. Adjacent ranges are joined.
+ */
+void TSearch::addRange(qsizetype from, qsizetype to)
+{
+    mLimited = true;
+
+    if (!mRanges.empty() && mRanges.back().to == from)
+        mRanges.back().to = to;
+    else
+        mRanges.push_back({from, to});
+}
+
+/**
+ * @brief TSearch::setCandidates
+ * Limits the search to some blocks of records, usually found by a
+ * TTrigramIndex.
+ *
+ * @param blocks        The sorted numbers of the blocks.
+ * @param blockRecords  The number of records of a block.
+ */
+void TSearch::setCandidates(const vector<quint32>& blocks, int blockRecords)
+{
+    DECL_TRACER("TSearch::setCandidates(const vector<quint32>& blocks, int blockRecords)");
+
+    qsizetype total = mIndex ? mIndex->size() : 0;
+    mRanges.clear();
+    mLimited = true;
+
+    for (quint32 block : blocks)
+    {
+        qsizetype from = static_cast<qsizetype>(block) * blockRecords;
+        addRange(from, std::min(from + blockRecords, total));
+    }
+}
+
+/**
+ * @brief TSearch::setRecords
+ * Limits the search to some records, usually the hits of a previous search
+ * for a part of the string. A search for a longer string can only find a
+ * subset of them.
+ *
+ * @param records   The sorted indexes of the records.
+ */
+void TSearch::setRecords(const vector<qsizetype>& records)
+{
+    DECL_TRACER("TSearch::setRecords(const vector<qsizetype>& records)");
+
+    mRanges.clear();
+    mLimited = true;
+
+    for (qsizetype rec : records)
+        addRange(rec, rec + 1);
+}
+
+/**
+ * @brief TSearch::find
+ * Finds all records containing the string.
+ *
+ * @param records   Receives the sorted indexes of all matching records.
+ * @param partial   If set, it is called by the searching threads with the
+ * hits of every finished part.
+ * @return If there is no file or the search was canceled, FALSE is
+ * returned.
+ */
+bool TSearch::find(vector<qsizetype>& records, const HITS_t& partial)
+{
+    DECL_TRACER("TSearch::find(vector<qsizetype>& records, const HITS_t& partial)");
+
+    records.clear();
+    mAborted = false;
+
+    if (!mIndex || !mIndex->data() || mIndex->size() == 0)
+        return false;
+
+    // Split the records into parts of about PART_SIZE bytes
+    qsizetype total = mIndex->size();
+    const vector<qint64>& offsets = mIndex->offsets();
+    vector<vector<RANGE_t>> parts;
+
+    if (mLimited)                                       // Only some candidates?
+    {
+        for (size_t i = 0; i < mRanges.size(); i += PART_RANGES)
+            parts.emplace_back(mRanges.begin() + i, mRanges.begin() + std::min(i + PART_RANGES, mRanges.size()));
+    }
+    else
+    {
+        qsizetype from = 0;
+
+        while (from < total)
+        {
+            auto pos = std::lower_bound(offsets.begin() + from, offsets.end(), offsets[from] + PART_SIZE);
+            qsizetype to = std::max(from + 1, static_cast<qsizetype>(pos - offsets.begin()));
+            parts.push_back({ RANGE_t{from, to} });
+            from = to;
+        }
+    }
+
+    if (parts.empty())
+        return true;
+
+    size_t numThreads = std::max(1u, thread::hardware_concurrency());
+    numThreads = std::min(numThreads, parts.size());
+    vector<vector<qsizetype>> hits(parts.size());
+    std::atomic<size_t> next{0};
+    vector<thread> threads;
+
+    for (size_t t = 0; t < numThreads; ++t)
+        threads.emplace_back(searchParts, this, &next, &parts, &hits, partial ? &partial : nullptr);
+
+    for (thread& th : threads)
+        th.join();
+
+    size_t count = 0;
+
+    for (const vector<qsizetype>& h : hits)
+        count += h.size();
+
+    records.reserve(count);
+
+    for (const vector<qsizetype>& h : hits)             // The parts are in order, so the result is sorted
+        records.insert(records.end(), h.begin(), h.end());
+
+    if (mAborted)
+        MSG_WARN("The search was aborted because the expression exceeded " << MATCH_LIMIT << " steps for a record.");
+
+    MSG_DEBUG("Found " << count << " records in " << parts.size() << " parts using " << numThreads << " threads.");
+    return !mCanceled;
+}
+
+/**
+ * @brief TSearch::start
+ * Starts the search in the background.
+ *
+ * @param partial   Called with the hits of every finished part.
+ * @param done      Called when the search is finished, unless it was
+ * canceled. The parameter is TRUE if the expression was too slow.
+ * Afterwards all hits are available by records().
+ */
+void TSearch::start(const HITS_t& partial, const DONE_t& done)
+{
+    DECL_TRACER("TSearch::start(const HITS_t& partial, const DONE_t& done)");
+
+    if (mThread.joinable())
+        return;
+
+    mRunning = true;
+    mThread = thread([this, partial, done]() {
+        if (find(mRecords, partial) && done)
+            done(mAborted);
+
+        mRunning = false;
+    });
+}
+
+void TSearch::compile(QRegularExpression& re) const
+{
+    if (mPattern.isEmpty())
+        return;
+
+    // PCRE2 stops a match after MATCH_LIMIT steps and reports an error,
+    // which leaves the QRegularExpressionMatch invalid.
+    re.setPattern(QString("(*LIMIT_MATCH=%1)").arg(MATCH_LIMIT) + mPattern);
+    re.setPatternOptions(mOptions);
+    re.optimize();                                  // Compile it now by the JIT
+}
+
+/**
+ * @brief TSearch::searchParts
+ * Takes the next part not searched yet until all parts are searched.
+ */
+void TSearch::searchParts(const TSearch *search, std::atomic<size_t> *next, const vector<vector<RANGE_t>> *parts,
+                          vector<vector<qsizetype>> *hits, const HITS_t *partial)
+{
+    QRegularExpression re;                          // Every thread uses its own compiled expression
+    search->compile(re);
+
+    for (size_t i = (*next)++; i < parts->size() && !search->stopped(); i = (*next)++)
+    {
+        vector<qsizetype>& h = (*hits)[i];
+
+        for (const RANGE_t& range : (*parts)[i])
+            searchRecords(search, re, range.from, range.to, &h);
+
+        if (partial && !h.empty() && !search->stopped())
+            (*partial)(vector<qsizetype>(h));
+    }
+}
+
+/**
+ * @brief TSearch::searchRecords
+ * Searches the records from \p from up to \p to. The bytes of consecutive
+ * records are searched in one go. A hit is assigned to its record by a
+ * binary search on the offsets of the records. If a regular expression is
+ * set, the hit is only a candidate and the record must match it. Without a
+ * literal every record is a candidate.
+ */
+void TSearch::searchRecords(const TSearch *search, const QRegularExpression& re, qsizetype from, qsizetype to, vector<qsizetype> *hits)
+{
+    if (from >= to)
+        return;
+
+    const TLogIndex *index = search->mIndex;
+    const vector<qint64>& offsets = index->offsets();
+    const char *data = index->data();
+    const char *needle = search->mNeedle.constData();
+    qint64 nlen = search->mNeedle.size();
+    qint64 end = offsets[to - 1] + index->length(to - 1);
+    qint64 pos = offsets[from];
+    qsizetype rec = from;
+    bool regex = !search->mPattern.isEmpty();
+
+    while (pos < end && !search->stopped())
+    {
+        const char *hit = findLiteral(data + pos, end - pos, needle, nlen, search->mRare);
+
+        if (!hit)
+            break;
+
+        qint64 off = hit - data;
+        rec = (std::upper_bound(offsets.begin() + rec, offsets.begin() + to, off) - offsets.begin()) - 1;
+        qint64 recEnd = offsets[rec] + index->length(rec);
+
+        if (off + nlen <= recEnd)                   // The hit must not cross the end of the record
+        {
+            bool match = true;
+
+            if (regex)
+            {
+                QRegularExpressionMatch m = re.match(QString::fromUtf8(data + offsets[rec], recEnd - offsets[rec]));
+
+                if (!m.isValid())                   // The match limit was hit
+                {
+                    search->mAborted = true;
+                    break;
+                }
+
+                match = m.hasMatch();
+            }
+
+            if (match)
+                hits->push_back(rec);
+
+            if (++rec >= to)
+                break;
+
+            pos = offsets[rec];                     // Skip the rest of the record
+        }
+        else
+            pos = off + 1;
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TSEARCH_H
+#define TSEARCH_H
+
+#include <QString>
+#include <QByteArray>
+#include <QRegularExpression>
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+class TLogIndex;
+
+/**
+ * @brief The TSearch class
+ * Finds all records of a TLogIndex containing a string. The search works on
+ * the raw bytes of the mapped file and never creates a QString. The file is
+ * split into parts at record boundaries. The threads take the parts one
+ * after the other until all parts are searched.
+ *
+ * To find a candidate, the byte of the string which is expected to be the
+ * rarest in a logfile is searched by memchr(), which is vectorized by the C
+ * library. Only at these positions the whole string is compared. After a
+ * hit, the rest of the record is skipped. The result is the sorted list of
+ * all matching records.
+ *
+ * A regular expression is searched the same way. A literal which must be
+ * part of every match is taken from the pattern and used to find the
+ * candidates. The expression (compiled by the JIT of PCRE2) runs only on
+ * the records containing the literal. Without such a literal every record
+ * is tested. The backtracking of the expression is limited to MATCH_LIMIT
+ * steps per record. If a record exceeds it, the pattern is considered
+ * pathological and the search is aborted.
+ *
+ * The search can be limited to some records: the blocks found by a
+ * TTrigramIndex (see setCandidates()) or the hits of a previous search
+ * (see setRecords()).
+ *
+ * A search started by start() runs in the background. The hits of every
+ * part are passed to a callback as soon as the part is finished, so they
+ * arrive in parts but not necessarily in order. A running search can be
+ * canceled at any time; deleting the object cancels it as well, but waits
+ * for the thread. To avoid this, delete it only when isRunning() returned
+ * FALSE.
+ */
+class TSearch
+{
+    public:
+        typedef std::function<void(std::vector<qsizetype>&& records)> HITS_t;     // Called with the hits of a part
+        typedef std::function<void(bool aborted)> DONE_t;                           // Called when the search is finished
+
+        explicit TSearch(const TLogIndex *index);
+        ~TSearch();
+
+        void setText(const QString& text);
+        bool setRegex(const QString& pattern, bool caseInsensitive=false);
+        QString& errorString() { return mError; }
+        const QByteArray& literal() const { return mNeedle; }
+        void setCandidates(const std::vector<quint32>& blocks, int blockRecords);
+        void setRecords(const std::vector<qsizetype>& records);
+        bool find(std::vector<qsizetype>& records, const HITS_t& partial=nullptr);
+        void start(const HITS_t& partial, const DONE_t& done);
+        void cancel() { mCanceled = true; }
+        bool isRunning() const { return mRunning; }
+        bool aborted() const { return mAborted; }
+        const std::vector<qsizetype>& records() const { return mRecords; }
+
+        static const char *findLiteral(const char *hay, qint64 len, const char *needle, qint64 nlen, qint64 rare);
+        static qint64 rarestByte(const char *needle, qint64 nlen);
+
+    private:
+        typedef struct RANGE_t
+        {
+            qsizetype from{0};                  // The first record
+            qsizetype to{0};                    // The record after the last one
+        }RANGE_t;
+
+        // Not copyable
+        TSearch(const TSearch&) = delete;
+        TSearch& operator=(const TSearch&) = delete;
+
+        void addRange(qsizetype from, qsizetype to);
+        bool stopped() const { return mAborted || mCanceled; }
+        static void searchParts(const TSearch *search, std::atomic<size_t> *next, const std::vector<std::vector<RANGE_t>> *parts,
+                                std::vector<std::vector<qsizetype>> *hits, const HITS_t *partial);
+        static void searchRecords(const TSearch *search, const QRegularExpression& re, qsizetype from, qsizetype to, std::vector<qsizetype> *hits);
+        void compile(QRegularExpression& re) const;
+
+        const TLogIndex *mIndex{nullptr};
+        QByteArray mNeedle;                     // The string to search for or the literal of the expression (UTF-8)
+        qint64 mRare{0};                        // The position of the rarest byte of the needle
+        QString mPattern;                       // The regular expression; empty = search for the string
+        QRegularExpression::PatternOptions mOptions{QRegularExpression::MultilineOption};
+        QString mError;
+        std::vector<RANGE_t> mRanges;           // The candidate records to search
+        bool mLimited{false};                   // TRUE = only the records of mRanges are searched
+        mutable std::atomic<bool> mAborted{false};  // TRUE = a record exceeded the match limit
+        std::atomic<bool> mCanceled{false};     // TRUE = the search was canceled
+        std::thread mThread;                    // The thread of a search started by start()
+        std::atomic<bool> mRunning{false};      // TRUE = the thread is searching
+        std::vector<qsizetype> mRecords;        // The hits of a search started by start(); valid when it is finished
+};
+
+#endif // TSEARCH_H
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QTableWidgetItem>
+#include <QHeaderView>
+#include <QPushButton>
+
+#include "ttemplatelist.h"
+#include "ui_ttemplatelist.h"
+#include "tlogger.h"
+
+#define ROLE_TEMPLATE   (Qt::UserRole + 1)      // The number of the template of a row of the table
+
+TTemplateList::TTemplateList(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::TTemplateList)
+{
+    DECL_TRACER("TTemplateList::TTemplateList(QWidget *parent)");
+
+    ui->setupUi(this);
+    ui->tableWidgetTemplates->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    ui->buttonBox->button(QDialogButtonBox::Reset)->setText(tr("Show all rows"));
+}
+
+TTemplateList::~TTemplateList()
+{
+    DECL_TRACER("TTemplateList::~TTemplateList()");
+
+    delete ui;
+}
+
+/**
+ * @brief TTemplateList::setTemplates
+ * Fills the table with the templates of a miner.
+ *
+ * @param miner     The miner after mining.
+ * @param rowValue  Returns the value shown for a row of the log, e.g. its
+ * time or its line number. The value is also used to sort the column.
+ */
+void TTemplateList::setTemplates(const TTemplateMiner& miner, std::function<QVariant(int row)> rowValue)
+{
+    DECL_TRACER("TTemplateList::setTemplates(const TTemplateMiner& miner, std::function<QVariant(int row)> rowValue)");
+
+    const std::vector<TTemplateMiner::TEMPLATE_t>& templates = miner.templates();
+    QTableWidget *table = ui->tableWidgetTemplates;
+    qint64 total = 0;
+
+    table->setSortingEnabled(false);
+    table->setRowCount(static_cast<int>(templates.size()));
+
+    for (int i = 0; i < static_cast<int>(templates.size()); ++i)
+    {
+        const TTemplateMiner::TEMPLATE_t& t = templates[static_cast<size_t>(i)];
+        QTableWidgetItem *count = new QTableWidgetItem;
+        count->setData(Qt::DisplayRole, static_cast<qlonglong>(t.count));
+        count->setData(ROLE_TEMPLATE, i);
+        count->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        table->setItem(i, 0, count);
+
+        QStringList examples;
+
+        for (int row : t.examples)
+            examples.append(QString::number(row + 1));
+
+        QTableWidgetItem *text = new QTableWidgetItem(t.text);
+        text->setToolTip(tr("Example lines: %1<br>Double click to show only the rows of this pattern").arg(examples.join(", ")));
+        table->setItem(i, 1, text);
+
+        QTableWidgetItem *first = new QTableWidgetItem;
+        first->setData(Qt::DisplayRole, rowValue(t.firstRow));
+        table->setItem(i, 2, first);
+
+        QTableWidgetItem *last = new QTableWidgetItem;
+        last->setData(Qt::DisplayRole, rowValue(t.lastRow));
+        table->setItem(i, 3, last);
+        total += t.count;
+    }
+
+    table->setSortingEnabled(true);
+    table->sortItems(0, Qt::DescendingOrder);
+    ui->labelSummary->setText(tr("%1 rows form %2 patterns.").arg(total).arg(templates.size()));
+}
+
+void TTemplateList::on_tableWidgetTemplates_cellDoubleClicked(int row, int)
+{
+    DECL_TRACER("TTemplateList::on_tableWidgetTemplates_cellDoubleClicked(int row, int)");
+
+    QTableWidgetItem *item = ui->tableWidgetTemplates->item(row, 0);
+
+    if (item)
+        emit templateSelected(item->data(ROLE_TEMPLATE).toInt());
+}
+
+void TTemplateList::on_buttonBox_clicked(QAbstractButton *button)
+{
+    DECL_TRACER("TTemplateList::on_buttonBox_clicked(QAbstractButton *button)");
+
+    if (ui->buttonBox->buttonRole(button) == QDialogButtonBox::ResetRole)
+        emit filterCleared();
+}
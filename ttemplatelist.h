@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTEMPLATELIST_H
+#define TTEMPLATELIST_H
+
+#include <QDialog>
+
+#include <functional>
+
+#include "ttemplateminer.h"
+
+namespace Ui {
+    class TTemplateList;
+}
+
+class QAbstractButton;
+
+/**
+ * @brief The TTemplateList class
+ * Shows the templates found by TTemplateMiner with their counts in a table
+ * sortable by every column. A double click on a template emits
+ * templateSelected(); the button "Reset" emits filterCleared().
+ */
+class TTemplateList : public QDialog
+{
+        Q_OBJECT
+
+    public:
+        explicit TTemplateList(QWidget *parent = nullptr);
+        ~TTemplateList();
+
+        void setTemplates(const TTemplateMiner& miner, std::function<QVariant(int row)> rowValue);
+
+    signals:
+        void templateSelected(int id);
+        void filterCleared();
+
+    private slots:
+        void on_tableWidgetTemplates_cellDoubleClicked(int row, int column);
+        void on_buttonBox_clicked(QAbstractButton *button);
+
+    private:
+        Ui::TTemplateList *ui;
+};
+
+#endif // TTEMPLATELIST_H
@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+#include <thread>
+
+#include "ttemplateminer.h"
+#include "tlogger.h"
+
+using std::vector;
+using std::thread;
+
+#define MAX_EXAMPLES    3                       // The number of example rows kept for every template
+
+/**
+ * @brief TTemplateMiner::TTemplateMiner
+ * @param similarity    The share of equal tokens (0.0 - 1.0) a message
+ * needs to join a template.
+ * @param depth         The depth of the parse tree. The messages are
+ * routed by their first depth - 2 tokens.
+ * @param maxChildren   The most children of a node. Further tokens are
+ * routed to the wildcard child.
+ */
+TTemplateMiner::TTemplateMiner(double similarity, int depth, int maxChildren)
+    : mSimilarity(similarity),
+      mDepth(std::max(3, depth)),
+      mMaxChildren(std::max(2, maxChildren))
+{
+    DECL_TRACER("TTemplateMiner::TTemplateMiner(double similarity, int depth, int maxChildren)");
+}
+
+/**
+ * @brief TTemplateMiner::addRow
+ * Adds the message of the next row. The rows must be added in order.
+ *
+ * @param row   The row of the table.
+ * @param text  The message.
+ */
+void TTemplateMiner::addRow(int row, const QString& text)
+{
+    mEntries.push_back({ row, text });
+}
+
+/**
+ * @brief TTemplateMiner::mine
+ * Groups the messages by their number of tokens and mines the groups in
+ * parallel. The largest groups are started first.
+ */
+void TTemplateMiner::mine()
+{
+    DECL_TRACER("TTemplateMiner::mine()");
+
+    mGroups.clear();
+    mTemplates.clear();
+    mTemplateOf.clear();
+    mAssigned.assign(mEntries.size(), -1);
+
+    QHash<int, size_t> groupOfLength;
+    vector<QStringView> tokens;
+
+    for (size_t e = 0; e < mEntries.size(); ++e)
+    {
+        tokenize(mEntries[e].text, tokens);
+
+        if (tokens.empty())
+            continue;
+
+        int length = static_cast<int>(tokens.size());
+        auto iter = groupOfLength.constFind(length);
+        size_t group = mGroups.size();
+
+        if (iter == groupOfLength.constEnd())
+        {
+            groupOfLength.insert(length, group);
+            mGroups.emplace_back();
+        }
+        else
+            group = iter.value();
+
+        mGroups[group].entries.push_back(e);
+    }
+
+    std::sort(mGroups.begin(), mGroups.end(), [](const GROUP_t& a, const GROUP_t& b) { return a.entries.size() > b.entries.size(); });
+    size_t numThreads = std::min(static_cast<size_t>(std::max(1u, thread::hardware_concurrency())), std::max(static_cast<size_t>(1), mGroups.size()));
+    std::atomic<size_t> next{0};
+    vector<thread> threads;
+
+    for (size_t t = 0; t < numThreads; ++t)
+        threads.emplace_back(mineGroups, this, &next);
+
+    for (thread& th : threads)
+        th.join();
+
+    // Collect the templates of all groups, the most frequent first
+    vector<std::pair<size_t, size_t>> order;                    // Group and cluster
+
+    for (size_t g = 0; g < mGroups.size(); ++g)
+    {
+        for (size_t c = 0; c < mGroups[g].clusters.size(); ++c)
+            order.emplace_back(g, c);
+    }
+
+    std::sort(order.begin(), order.end(), [this](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        const TEMPLATE_t& ta = mGroups[a.first].clusters[a.second].info;
+        const TEMPLATE_t& tb = mGroups[b.first].clusters[b.second].info;
+        return ta.count != tb.count ? ta.count > tb.count : ta.firstRow < tb.firstRow;
+    });
+
+    vector<vector<qint32>> ids(mGroups.size());
+
+    for (size_t g = 0; g < mGroups.size(); ++g)
+        ids[g].resize(mGroups[g].clusters.size());
+
+    for (const std::pair<size_t, size_t>& o : order)
+    {
+        CLUSTER_t& cluster = mGroups[o.first].clusters[o.second];
+        ids[o.first][o.second] = static_cast<qint32>(mTemplates.size());
+        cluster.info.text = cluster.tokens.join(' ');
+        mTemplates.push_back(std::move(cluster.info));
+    }
+
+    int rows = mEntries.empty() ? 0 : mEntries.back().row + 1;
+    mTemplateOf.assign(static_cast<size_t>(rows), -1);
+
+    for (size_t g = 0; g < mGroups.size(); ++g)
+    {
+        for (size_t e : mGroups[g].entries)
+            mTemplateOf[static_cast<size_t>(mEntries[e].row)] = ids[g][static_cast<size_t>(mAssigned[e])];
+    }
+
+    MSG_DEBUG("Mined " << mTemplates.size() << " templates from " << mEntries.size() << " messages of " << mGroups.size() << " lengths using " << numThreads << " threads");
+    mGroups.clear();
+    mEntries.clear();
+    mAssigned.clear();
+}
+
+/**
+ * @brief TTemplateMiner::rows
+ * @param id    The number of the template.
+ * @return The rows matching a template.
+ */
+TRowBitmap TTemplateMiner::rows(int id) const
+{
+    DECL_TRACER("TTemplateMiner::rows(int id) const");
+
+    size_t count = mTemplateOf.size();
+    vector<quint64> words((count + 63) / 64, 0);
+
+    for (size_t row = 0; row < count; ++row)
+    {
+        if (mTemplateOf[row] == id)
+            words[row >> 6] |= static_cast<quint64>(1) << (row & 63);
+    }
+
+    return TRowBitmap::fromWords(words);
+}
+
+void TTemplateMiner::mineGroups(TTemplateMiner *self, std::atomic<size_t> *next)
+{
+    for (size_t idx = (*next)++; idx < self->mGroups.size(); idx = (*next)++)
+        self->mineGroup(self->mGroups[idx]);
+}
+
+/**
+ * @brief TTemplateMiner::mineGroup
+ * Mines the messages of one length in order. The parse tree of the group
+ * starts below the length node.
+ *
+ * @param group The messages of one length.
+ */
+void TTemplateMiner::mineGroup(GROUP_t& group)
+{
+    vector<NODE_t> nodes(1);                                    // The first node is the length node
+    vector<QStringView> tokens;
+    const QString wild = wildcard();
+
+    for (size_t e : group.entries)
+    {
+        const ENTRY_t& entry = mEntries[e];
+        tokenize(entry.text, tokens);
+        int levels = std::min(mDepth - 2, static_cast<int>(tokens.size()));
+        int node = 0;
+
+        for (int level = 0; level < levels; ++level)            // Descend by the first tokens
+        {
+            QString token = tokens[static_cast<size_t>(level)].toString();
+            QHash<QString, int>& children = nodes[static_cast<size_t>(node)].children;
+            auto iter = children.constFind(token);
+
+            if (iter != children.constEnd())
+            {
+                node = iter.value();
+                continue;
+            }
+
+            // Like Drain: a new token gets its own child while the node has
+            // room, keeping the last place for the wildcard. Tokens with a
+            // digit (already <*>) and all tokens of a full node go to the
+            // wildcard child.
+            bool hasWild = children.contains(wild);
+
+            if (token != wild && children.size() + (hasWild ? 0 : 1) >= mMaxChildren)
+            {
+                token = wild;
+
+                if (hasWild)
+                {
+                    node = children.value(wild);
+                    continue;
+                }
+            }
+
+            int child = static_cast<int>(nodes.size());
+            children.insert(token, child);
+            nodes.emplace_back();
+            node = child;
+        }
+
+        vector<int>& clusters = nodes[static_cast<size_t>(node)].clusters;
+        int cluster = findCluster(group, clusters, tokens);
+
+        if (cluster < 0)                                        // A new template
+        {
+            cluster = static_cast<int>(group.clusters.size());
+            CLUSTER_t c;
+
+            for (const QStringView& token : tokens)
+                c.tokens.append(token.toString());
+
+            group.clusters.push_back(std::move(c));
+            clusters.push_back(cluster);
+        }
+        else                                                    // The tokens differing become wildcards
+        {
+            QStringList& templ = group.clusters[static_cast<size_t>(cluster)].tokens;
+
+            for (qsizetype i = 0; i < templ.size(); ++i)
+            {
+                if (templ[i] != wild && templ[i] != tokens[static_cast<size_t>(i)])
+                    templ[i] = wild;
+            }
+        }
+
+        TEMPLATE_t& info = group.clusters[static_cast<size_t>(cluster)].info;
+        info.count++;
+        info.lastRow = entry.row;
+
+        if (info.firstRow < 0)
+            info.firstRow = entry.row;
+
+        if (info.examples.size() < MAX_EXAMPLES)
+            info.examples.push_back(entry.row);
+
+        mAssigned[e] = cluster;
+    }
+}
+
+/**
+ * @brief TTemplateMiner::findCluster
+ * Finds the template of a leaf most similar to a message. The similarity
+ * is the share of tokens equal to the template; wildcards don't count. On
+ * a tie the template with more wildcards wins.
+ *
+ * @return The index of the template in the group or -1 if no template is
+ * similar enough.
+ */
+int TTemplateMiner::findCluster(const GROUP_t& group, const vector<int>& clusters, const vector<QStringView>& tokens) const
+{
+    int best = -1;
+    double bestSim = -1.0;
+    int bestParams = -1;
+    const QString wild = wildcard();
+
+    for (int cluster : clusters)
+    {
+        const QStringList& templ = group.clusters[static_cast<size_t>(cluster)].tokens;
+        int equal = 0, params = 0;
+
+        for (qsizetype i = 0; i < templ.size(); ++i)
+        {
+            if (templ[i] == wild)
+                params++;
+            else if (templ[i] == tokens[static_cast<size_t>(i)])
+                equal++;
+        }
+
+        double sim = static_cast<double>(equal) / static_cast<double>(templ.size());
+
+        if (sim > bestSim || (sim == bestSim && params > bestParams))
+        {
+            best = cluster;
+            bestSim = sim;
+            bestParams = params;
+        }
+    }
+
+    return bestSim >= mSimilarity ? best : -1;
+}
+
+/**
+ * @brief TTemplateMiner::tokenize
+ * Splits a message into tokens at white space. Tokens containing a digit
+ * are replaced by the wildcard, as they are nearly always variable
+ * (numbers, IDs, addresses, times).
+ *
+ * @param text      The message.
+ * @param tokens    Receives the tokens.
+ */
+void TTemplateMiner::tokenize(const QString& text, vector<QStringView>& tokens)
+{
+    static const QString wild = wildcard();
+    tokens.clear();
+    const QChar *data = text.constData();
+    qsizetype len = text.size();
+    qsizetype pos = 0;
+
+    while (pos < len)
+    {
+        while (pos < len && data[pos].isSpace())
+            pos++;
+
+        if (pos >= len)
+            break;
+
+        qsizetype start = pos;
+        bool digit = false;
+
+        while (pos < len && !data[pos].isSpace())
+        {
+            digit = digit || data[pos].isDigit();
+            pos++;
+        }
+
+        tokens.push_back(digit ? QStringView(wild) : QStringView(data + start, pos - start));
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTEMPLATEMINER_H
+#define TTEMPLATEMINER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+#include <vector>
+#include <atomic>
+
+#include "trowbitmap.h"
+
+/**
+ * @brief The TTemplateMiner class
+ * Clusters messages into templates like "Connection to <*> closed after
+ * <*> ms" with the Drain algorithm (He et al., ICWS 2017).
+ *
+ * A message is split into tokens at white space; tokens containing a digit
+ * are replaced by the wildcard <*>. Drain descends a tree of fixed depth:
+ * the first level is the number of tokens, the next levels are the first
+ * tokens of the message. A leaf holds the templates sharing this path and
+ * the message joins the most similar one if enough of its tokens are
+ * equal; the tokens that differ become wildcards. Otherwise the message
+ * starts a new template.
+ *
+ * Messages of different length never share a template, so every length is
+ * mined on its own, in parallel, with the rows of a length in order. The
+ * result is the same as mining all rows one by one.
+ */
+class TTemplateMiner
+{
+    public:
+        typedef struct TEMPLATE_t
+        {
+            QString text;                       // The template; variable tokens are <*>
+            qint64 count{0};                    // The number of rows matching the template
+            int firstRow{-1};                   // The first row matching the template
+            int lastRow{-1};                    // The last row matching the template
+            std::vector<int> examples;          // The first rows matching the template
+        }TEMPLATE_t;
+
+        explicit TTemplateMiner(double similarity=0.4, int depth=4, int maxChildren=100);
+
+        void addRow(int row, const QString& text);
+        void mine();
+        const std::vector<TEMPLATE_t>& templates() const { return mTemplates; }
+        int templateOf(int row) const { return (row >= 0 && row < static_cast<int>(mTemplateOf.size())) ? mTemplateOf[row] : -1; }
+        TRowBitmap rows(int id) const;
+
+        static QString wildcard() { return QStringLiteral("<*>"); }
+
+    private:
+        typedef struct ENTRY_t
+        {
+            int row{0};
+            QString text;
+        }ENTRY_t;
+
+        typedef struct NODE_t
+        {
+            QHash<QString, int> children;       // The child nodes by token
+            std::vector<int> clusters;          // The templates of a leaf
+        }NODE_t;
+
+        typedef struct CLUSTER_t
+        {
+            QStringList tokens;                 // The tokens of the template
+            TEMPLATE_t info;
+        }CLUSTER_t;
+
+        typedef struct GROUP_t
+        {
+            std::vector<size_t> entries;        // The entries of one message length in order
+            std::vector<CLUSTER_t> clusters;    // The templates found
+        }GROUP_t;
+
+        static void tokenize(const QString& text, std::vector<QStringView>& tokens);
+        static void mineGroups(TTemplateMiner *self, std::atomic<size_t> *next);
+        void mineGroup(GROUP_t& group);
+        int findCluster(const GROUP_t& group, const std::vector<int>& clusters, const std::vector<QStringView>& tokens) const;
+
+        double mSimilarity{0.4};                // The share of equal tokens needed to join a template
+        int mDepth{4};                          // The depth of the parse tree
+        int mMaxChildren{100};                  // The most children of a node
+        std::vector<ENTRY_t> mEntries;          // The messages to mine
+        std::vector<GROUP_t> mGroups;           // The messages grouped by length
+        std::vector<qint32> mAssigned;          // The template (within its group) of every entry
+        std::vector<TEMPLATE_t> mTemplates;     // The templates, the most frequent first
+        std::vector<qint32> mTemplateOf;        // The template of every row (-1 = none)
+};
+
+#endif // TTEMPLATEMINER_H
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+#include "ttimebins.h"
+#include "ttimeparser.h"
+#include "tlogger.h"
+
+#define MAX_BINS        65536                   // The highest number of bins of level 0
+#define MIN_BIN_WIDTH   1000                    // The smallest width of a bin in microseconds
+#define MAX_ZOOM        8                       // The most pixels a bin of level 0 may get
+
+TTimeBins::TTimeBins(qint64 first, qint64 last)
+    : mFirst(first),
+      mLast(std::max(first, last))
+{
+    DECL_TRACER("TTimeBins::TTimeBins(qint64 first, qint64 last)");
+
+    qint64 span = mLast - mFirst + 1;
+
+    while (mBins < MAX_BINS && static_cast<qint64>(mBins) * MIN_BIN_WIDTH < span)
+        mBins <<= 1;
+
+    mBinWidth = static_cast<double>(span) / static_cast<double>(mBins);
+    int offset = 0;
+
+    for (int bins = mBins; bins > 0; bins >>= 1)
+    {
+        mOffsets.push_back(offset);
+        offset += bins;
+    }
+
+    mSize = static_cast<size_t>(offset);
+}
+
+/**
+ * @brief TTimeBins::binOf
+ * @param usec  A time in microseconds.
+ * @return The bin of level 0 containing the time or -1 if the time is
+ * outside of the bins.
+ */
+int TTimeBins::binOf(qint64 usec) const
+{
+    if (usec < mFirst || usec > mLast)
+        return -1;
+
+    return std::min(mBins - 1, static_cast<int>(static_cast<double>(usec - mFirst) / mBinWidth));
+}
+
+/**
+ * @brief TTimeBins::levelOfDetail
+ * @param usecPerPixel  The time shown by one pixel.
+ * @return The highest level whose bins are not wider than a pixel.
+ */
+int TTimeBins::levelOfDetail(double usecPerPixel) const
+{
+    int level = 0;
+
+    while (level + 1 < levels() && binWidth(level + 1) <= usecPerPixel)
+        level++;
+
+    return level;
+}
+
+/**
+ * @brief TTimeView::reset
+ * Shows the whole time range of the bins.
+ *
+ * @param bins  The bins of the data or NULL.
+ */
+void TTimeView::reset(const TTimeBins *bins)
+{
+    mBins = bins;
+    mStart = mBins ? static_cast<double>(mBins->first()) : 0.0;
+    mSpan = mBins ? mBins->span() : 1.0;
+    mPanX = -1;
+}
+
+int TTimeView::levelOfDetail(const QRect& plot) const
+{
+    return mBins->levelOfDetail(mSpan / std::max(1, plot.width()));
+}
+
+/**
+ * @brief TTimeView::binsAt
+ * Calculates the bins of a level covered by a pixel column of the plot.
+ *
+ * @param x     The x position of the pixel column in the widget.
+ * @param plot  The area of the plot.
+ * @param level The level of the bins.
+ * @param from  Receives the first bin.
+ * @param to    Receives the bin after the last one.
+ */
+void TTimeView::binsAt(int x, const QRect& plot, int level, int *from, int *to) const
+{
+    double usecPerPixel = mSpan / std::max(1, plot.width());
+    double width = mBins->binWidth(level);
+    double time = timeAt(x, plot) - static_cast<double>(mBins->first());
+
+    *from = static_cast<int>(std::floor(time / width));
+    *to = std::max(*from + 1, static_cast<int>(std::ceil((time + usecPerPixel) / width)));
+}
+
+double TTimeView::timeAt(int x, const QRect& plot) const
+{
+    return mStart + static_cast<double>(x - plot.left()) * mSpan / std::max(1, plot.width());
+}
+
+int TTimeView::xOf(double usec, const QRect& plot) const
+{
+    double x = (usec - mStart) * std::max(1, plot.width()) / mSpan;
+    return plot.left() + static_cast<int>(std::clamp(x, -1.0, plot.width() + 1.0));
+}
+
+/**
+ * @brief TTimeView::zoom
+ * Zooms in or out around the time at the mouse. A bin of level 0 gets
+ * at most MAX_ZOOM pixels.
+ *
+ * @param x             The x position of the mouse in the widget.
+ * @param plot          The area of the plot.
+ * @param angleDelta    The rotation of the wheel in eighths of a degree.
+ */
+void TTimeView::zoom(int x, const QRect& plot, int angleDelta)
+{
+    if (!mBins || plot.width() <= 0)
+        return;
+
+    double anchor = timeAt(x, plot);
+    double factor = std::pow(0.8, angleDelta / 120.0);
+    double full = mBins->span();
+    double least = mBins->binWidth(0) * plot.width() / MAX_ZOOM;
+
+    mSpan = std::clamp(mSpan * factor, std::min(least, full), full);
+    mStart = anchor - static_cast<double>(x - plot.left()) / plot.width() * mSpan;
+    clamp();
+}
+
+void TTimeView::startPan(int x)
+{
+    mPanX = x;
+    mPanStart = mStart;
+}
+
+void TTimeView::panTo(int x, const QRect& plot)
+{
+    if (!mBins || mPanX < 0 || plot.width() <= 0)
+        return;
+
+    mStart = mPanStart - (x - mPanX) * mSpan / plot.width();
+    clamp();
+}
+
+void TTimeView::clamp()
+{
+    double first = static_cast<double>(mBins->first());
+    mStart = std::clamp(mStart, first, first + mBins->span() - mSpan);
+}
+
+/**
+ * @brief TTimeView::drawAxis
+ * Draws a time axis below a plot with the pen of the painter. The distance
+ * of the ticks is chosen so that the labels don't overlap.
+ *
+ * @param painter   The painter of the widget.
+ * @param plot      The area of the plot.
+ * @param height    The height of the axis.
+ */
+void TTimeView::drawAxis(QPainter& painter, const QRect& plot, int height) const
+{
+    static const double steps[] = {
+        1e3, 2e3, 5e3, 1e4, 2e4, 5e4, 1e5, 2e5, 5e5,                        // Milliseconds
+        1e6, 2e6, 5e6, 1e7, 3e7,                                            // Seconds
+        6e7, 1.2e8, 3e8, 6e8, 1.2e9, 1.8e9,                                 // Minutes
+        3.6e9, 7.2e9, 1.08e10, 2.16e10, 4.32e10, 8.64e10                    // Hours
+    };
+
+    double usecPerPixel = mSpan / std::max(1, plot.width());
+    int labelWidth = painter.fontMetrics().horizontalAdvance("00:00:00.000") + 20;
+    double step = steps[sizeof(steps) / sizeof(steps[0]) - 1];
+
+    for (double s : steps)
+    {
+        if (s / usecPerPixel >= labelWidth)
+        {
+            step = s;
+            break;
+        }
+    }
+
+    int y = plot.bottom() + 1;
+    painter.drawLine(plot.left(), y, plot.right(), y);
+
+    for (double tick = std::ceil(mStart / step) * step; tick < mStart + mSpan; tick += step)
+    {
+        int x = plot.left() + static_cast<int>((tick - mStart) / usecPerPixel);
+        QString text = TTimeParser::toString(static_cast<qint64>(tick)).mid(11, step < 1e6 ? 12 : 8);
+        painter.drawLine(x, y, x, y + 4);
+        painter.drawText(QRect(x - labelWidth / 2, y + 4, labelWidth, height - 4), Qt::AlignHCenter | Qt::AlignTop, text);
+    }
+}
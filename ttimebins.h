@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTIMEBINS_H
+#define TTIMEBINS_H
+
+#include <QRect>
+
+#include <vector>
+
+class QPainter;
+
+/**
+ * @brief The TTimeBins class
+ * Divides the time between the first and the last row into a power of two
+ * of bins of equal width, at most one bin per millisecond, and lays out a
+ * pyramid of levels on top of them, where a bin of a level merges two bins
+ * of the level below. The bins of all levels are stored one level after
+ * the other in one vector of the user, with a fixed number of values per
+ * bin.
+ *
+ * Any zoom can therefore be drawn by reading one or two bins per pixel
+ * from the level whose bins are just narrower than a pixel, no matter how
+ * many rows the file has. Used by TTimelineData and THistogramData.
+ */
+class TTimeBins
+{
+    public:
+        TTimeBins(qint64 first, qint64 last);
+
+        qint64 first() const { return mFirst; }
+        qint64 last() const { return mLast; }
+        double span() const { return static_cast<double>(mLast - mFirst + 1); }
+        int levels() const { return static_cast<int>(mOffsets.size()); }
+        int bins(int level) const { return mBins >> level; }
+        double binWidth(int level) const { return mBinWidth * static_cast<double>(1 << level); }
+        size_t offset(int level) const { return static_cast<size_t>(mOffsets[static_cast<size_t>(level)]); }
+        size_t size() const { return mSize; }
+        int binOf(qint64 usec) const;
+        int levelOfDetail(double usecPerPixel) const;
+
+        /**
+         * @brief buildLevels
+         * Fills all levels above level 0 by merging two neighbouring bins
+         * of the level below.
+         *
+         * @param values    The bins of all levels; size() * stride values.
+         * @param stride    The number of values of a bin.
+         * @param merge     Merges the values of two bins into one value.
+         */
+        template<typename T, typename MERGE>
+        void buildLevels(std::vector<T>& values, size_t stride, MERGE merge) const
+        {
+            for (int level = 1; level < levels(); ++level)
+            {
+                const T *lower = values.data() + offset(level - 1) * stride;
+                T *upper = values.data() + offset(level) * stride;
+                size_t count = static_cast<size_t>(bins(level)) * stride;
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    size_t bin = i / stride;
+                    size_t value = i % stride;
+                    upper[i] = merge(lower[2 * bin * stride + value], lower[(2 * bin + 1) * stride + value]);
+                }
+            }
+        }
+
+    private:
+        qint64 mFirst{0};                       // The time of the first row in microseconds
+        qint64 mLast{0};                        // The time of the last row in microseconds
+        int mBins{1};                           // The number of bins of level 0
+        double mBinWidth{1.0};                  // The width of a bin of level 0 in microseconds
+        std::vector<int> mOffsets;              // The first bin of every level
+        size_t mSize{0};                        // The number of bins of all levels
+};
+
+/**
+ * @brief The TTimeView class
+ * The part of the time range of a TTimeBins shown by a plot, and the zoom
+ * and pan of it by the mouse. Used by TTimeline and THistogram.
+ */
+class TTimeView
+{
+    public:
+        void reset(const TTimeBins *bins);
+        bool isValid() const { return mBins != nullptr; }
+        double start() const { return mStart; }
+        double span() const { return mSpan; }
+        int levelOfDetail(const QRect& plot) const;
+        void binsAt(int x, const QRect& plot, int level, int *from, int *to) const;
+        double timeAt(int x, const QRect& plot) const;
+        int xOf(double usec, const QRect& plot) const;
+        void zoom(int x, const QRect& plot, int angleDelta);
+        void startPan(int x);
+        void panTo(int x, const QRect& plot);
+        void endPan() { mPanX = -1; }
+        bool isPanning() const { return mPanX >= 0; }
+        void drawAxis(QPainter& painter, const QRect& plot, int height) const;
+
+    private:
+        void clamp();
+
+        const TTimeBins *mBins{nullptr};        // The bins of the data; not owned
+        double mStart{0.0};                     // The time at the left edge of the plot
+        double mSpan{1.0};                      // The time shown by the plot in microseconds
+        int mPanX{-1};                          // The x position where panning started (-1 = no pan)
+        double mPanStart{0.0};                  // mStart when panning started
+};
+
+#endif // TTIMEBINS_H
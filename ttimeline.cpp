@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QHelpEvent>
+#include <QToolTip>
+
+#include <algorithm>
+#include <cmath>
+
+#include "ttimeline.h"
+#include "ttimelinedata.h"
+#include "ttimeparser.h"
+#include "tlogger.h"
+
+#define LABEL_WIDTH     140                     // The width of the names of the lanes
+#define AXIS_HEIGHT     22                      // The height of the time axis
+#define MAX_LANE_HEIGHT 24                      // The highest height of a lane
+
+TTimeline::TTimeline(QWidget *parent)
+    : QWidget(parent)
+{
+    DECL_TRACER("TTimeline::TTimeline(QWidget *parent)");
+
+    setMinimumSize(LABEL_WIDTH + 200, AXIS_HEIGHT + 100);
+    setMouseTracking(false);
+}
+
+TTimeline::~TTimeline()
+{
+    DECL_TRACER("TTimeline::~TTimeline()");
+
+    if (mData)
+        delete mData;
+}
+
+/**
+ * @brief TTimeline::setData
+ * Sets the rows to show and shows the whole time range.
+ *
+ * @param data      The counted rows. The widget takes the ownership.
+ * @param colors    The color of every lane.
+ */
+void TTimeline::setData(TTimelineData *data, const QList<QColor>& colors)
+{
+    DECL_TRACER("TTimeline::setData(TTimelineData *data, const QList<QColor>& colors)");
+
+    if (mData && mData != data)
+        delete mData;
+
+    mData = data;
+    mColors = colors;
+    mView.reset(mData ? &mData->timeBins() : nullptr);
+    update();
+}
+
+bool TTimeline::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip && mData)
+    {
+        QHelpEvent *help = static_cast<QHelpEvent *>(event);
+        QRect plot = plotRect();
+        int lane = laneAt(help->pos().y());
+
+        if (lane < 0 || !plot.contains(help->pos()))
+        {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        int level = mView.levelOfDetail(plot);
+        int from, to;
+        quint32 count;
+        bool error;
+        mView.binsAt(help->pos().x(), plot, level, &from, &to);
+        mData->sample(lane, level, from, to, &count, &error);
+
+        QToolTip::showText(help->globalPos(), tr("Thread %1<br>%2<br>%3 rows here, %4 rows in total%5<br>Double click to go there")
+                           .arg(mData->laneName(lane).toHtmlEscaped())
+                           .arg(TTimeParser::toString(static_cast<qint64>(mView.timeAt(help->pos().x(), plot))))
+                           .arg(count).arg(mData->laneRows(lane))
+                           .arg(error ? tr("<br><b>Contains errors</b>") : QString()), this);
+        return true;
+    }
+
+    return QWidget::event(event);
+}
+
+/**
+ * @brief TTimeline::paintEvent
+ * Draws the lanes into an image with one pixel for every lane and pixel
+ * column and scales it to the height of the lanes. The count of a pixel
+ * is read from the level of detail whose bins are just narrower than a
+ * pixel.
+ */
+void TTimeline::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+
+    QRect plot = plotRect();
+
+    if (!mData || mData->lanes() == 0 || plot.width() <= 0)
+        return;
+
+    int lanes = mData->lanes();
+    int height = laneHeight();
+    int width = plot.width();
+    int level = mView.levelOfDetail(plot);
+
+    if (mImage.width() != width || mImage.height() != lanes)
+        mImage = QImage(width, lanes, QImage::Format_RGB32);
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        QRgb *line = reinterpret_cast<QRgb *>(mImage.scanLine(lane));
+        QColor color = lane < mColors.size() ? mColors[lane] : QColor(Qt::darkBlue);
+        QRgb background = (lane & 1) ? qRgb(0xf4, 0xf4, 0xf4) : qRgb(0xff, 0xff, 0xff);
+
+        for (int x = 0; x < width; ++x)
+        {
+            int from, to;
+            quint32 count;
+            bool error;
+
+            mView.binsAt(plot.left() + x, plot, level, &from, &to);
+            mData->sample(lane, level, from, to, &count, &error);
+
+            if (count == 0)
+                line[x] = background;
+            else if (error)
+                line[x] = qRgb(0xd0, 0x10, 0x10);
+            else
+            {
+                double max = static_cast<double>(mData->maxCount(level)) * (to - from);
+                double alpha = 0.25 + 0.75 * std::min(1.0, std::log1p(count) / std::log1p(max));
+                line[x] = qRgb(static_cast<int>(255 - alpha * (255 - color.red())),
+                               static_cast<int>(255 - alpha * (255 - color.green())),
+                               static_cast<int>(255 - alpha * (255 - color.blue())));
+            }
+        }
+    }
+
+    painter.drawImage(QRect(plot.left(), plot.top(), width, lanes * height), mImage);
+    painter.setPen(palette().windowText().color());
+
+    if (height >= painter.fontMetrics().height())                           // Names only if they fit
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            QRect label(0, plot.top() + lane * height, LABEL_WIDTH - 6, height);
+            painter.drawText(label, Qt::AlignRight | Qt::AlignVCenter, painter.fontMetrics().elidedText(mData->laneName(lane), Qt::ElideMiddle, label.width()));
+        }
+    }
+
+    mView.drawAxis(painter, plot, AXIS_HEIGHT);
+}
+
+void TTimeline::wheelEvent(QWheelEvent *event)
+{
+    if (!mData)
+        return;
+
+    mView.zoom(static_cast<int>(event->position().x()), plotRect(), event->angleDelta().y());
+    update();
+    event->accept();
+}
+
+void TTimeline::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton)
+        return;
+
+    mView.startPan(static_cast<int>(event->position().x()));
+    setCursor(Qt::ClosedHandCursor);
+}
+
+void TTimeline::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!mView.isPanning())
+        return;
+
+    mView.panTo(static_cast<int>(event->position().x()), plotRect());
+    update();
+}
+
+void TTimeline::mouseReleaseEvent(QMouseEvent *)
+{
+    mView.endPan();
+    unsetCursor();
+}
+
+void TTimeline::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (mData && plotRect().contains(event->position().toPoint()))
+        emit timeSelected(static_cast<qint64>(mView.timeAt(static_cast<int>(event->position().x()), plotRect())));
+}
+
+QRect TTimeline::plotRect() const
+{
+    int lanes = mData ? std::max(1, mData->lanes()) : 1;
+    int height = std::min(MAX_LANE_HEIGHT, std::max(1, (this->height() - AXIS_HEIGHT) / lanes));
+    return QRect(LABEL_WIDTH, 0, std::max(0, width() - LABEL_WIDTH - 4), height * lanes);
+}
+
+int TTimeline::laneHeight() const
+{
+    int lanes = mData ? std::max(1, mData->lanes()) : 1;
+    return plotRect().height() / lanes;
+}
+
+int TTimeline::laneAt(int y) const
+{
+    int height = laneHeight();
+
+    if (!mData || height <= 0 || y < 0)
+        return -1;
+
+    int lane = y / height;
+    return lane < mData->lanes() ? lane : -1;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTIMELINE_H
+#define TTIMELINE_H
+
+#include <QWidget>
+#include <QImage>
+
+#include "ttimebins.h"
+
+class TTimelineData;
+
+/**
+ * @brief The TTimeline class
+ * Draws the activity of every thread as a lane over time. The darker a
+ * lane, the more rows were logged; red marks errors. The mouse wheel
+ * zooms around the mouse pointer, dragging pans and a double click emits
+ * timeSelected() with the time under the pointer.
+ *
+ * Every repaint reads at most a few bins per pixel from the level of
+ * detail of TTimelineData matching the zoom, so zooming and panning stay
+ * fluent for files of any size.
+ */
+class TTimeline : public QWidget
+{
+        Q_OBJECT
+
+    public:
+        explicit TTimeline(QWidget *parent = nullptr);
+        ~TTimeline();
+
+        void setData(TTimelineData *data, const QList<QColor>& colors);
+
+    signals:
+        void timeSelected(qint64 usec);
+
+    protected:
+        bool event(QEvent *event) override;
+        void paintEvent(QPaintEvent *event) override;
+        void wheelEvent(QWheelEvent *event) override;
+        void mousePressEvent(QMouseEvent *event) override;
+        void mouseMoveEvent(QMouseEvent *event) override;
+        void mouseReleaseEvent(QMouseEvent *event) override;
+        void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+    private:
+        QRect plotRect() const;
+        int laneHeight() const;
+        int laneAt(int y) const;
+
+        TTimelineData *mData{nullptr};          // The counted rows; owned by this widget
+        QList<QColor> mColors;                  // The color of every lane
+        QImage mImage;                          // One pixel for every lane and pixel column
+        TTimeView mView;                        // The time shown by the lanes
+};
+
+#endif // TTIMELINE_H
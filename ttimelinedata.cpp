@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+
+#include <QCoreApplication>
+
+#include "ttimelinedata.h"
+#include "tlogger.h"
+
+/**
+ * @brief TTimelineData::TTimelineData
+ * @param lanes     The names of the threads.
+ * @param first     The time of the first row.
+ * @param last      The time of the last row.
+ * @param maxLanes  The most lanes, including the other lane.
+ */
+TTimelineData::TTimelineData(const QStringList& lanes, qint64 first, qint64 last, int maxLanes)
+    : mBins(first, last),
+      mNames(lanes),
+      mMaxLanes(std::max(1, maxLanes))
+{
+    DECL_TRACER("TTimelineData::TTimelineData(const QStringList& lanes, qint64 first, qint64 last, int maxLanes)");
+
+    mMaxCount.assign(static_cast<size_t>(mBins.levels()), 1);
+    mLaneOf.assign(static_cast<size_t>(lanes.size()), -1);
+}
+
+/**
+ * @brief TTimelineData::addLane
+ * Allocates the lane of a thread with its first row. Once only the place
+ * of the other lane is left, the thread goes to the other lane.
+ *
+ * @param lane  The thread.
+ * @return The lane of the thread.
+ */
+int TTimelineData::addLane(int lane)
+{
+    int idx = static_cast<int>(mLanes.size());
+
+    if (mNames.size() > mMaxLanes && idx + 1 >= mMaxLanes)
+    {
+        mOtherThreads++;
+
+        if (mOther >= 0)
+            return mOther;
+
+        mOther = idx;
+    }
+
+    LANE_t l;
+    l.name = mNames[lane];
+    l.counts.assign(mBins.size(), 0);
+    l.errors.assign(mBins.size(), 0);
+    mLanes.push_back(std::move(l));
+    return idx;
+}
+
+/**
+ * @brief TTimelineData::add
+ * Counts a row in its bin of level 0.
+ *
+ * @param lane  The thread of the row.
+ * @param usec  The time of the row.
+ * @param error TRUE = the row is an error.
+ */
+void TTimelineData::add(int lane, qint64 usec, bool error)
+{
+    int bin = mBins.binOf(usec);
+
+    if (lane < 0 || lane >= static_cast<int>(mLaneOf.size()) || bin < 0)
+        return;
+
+    int& laneOf = mLaneOf[static_cast<size_t>(lane)];
+
+    if (laneOf < 0)
+        laneOf = addLane(lane);
+
+    LANE_t& l = mLanes[static_cast<size_t>(laneOf)];
+
+    if (l.counts[static_cast<size_t>(bin)] < 0xffff)
+        l.counts[static_cast<size_t>(bin)]++;
+
+    if (error)
+        l.errors[static_cast<size_t>(bin)] = 1;
+
+    l.rows++;
+}
+
+/**
+ * @brief TTimelineData::finish
+ * Builds the levels above level 0 after the last row was added and names
+ * the other lane.
+ */
+void TTimelineData::finish()
+{
+    DECL_TRACER("TTimelineData::finish()");
+
+    if (mOther >= 0)
+        mLanes[static_cast<size_t>(mOther)].name = QCoreApplication::translate("TTimelineData", "%1 other threads").arg(mOtherThreads);
+
+    for (LANE_t& lane : mLanes)
+    {
+        mBins.buildLevels(lane.counts, 1, [](quint16 a, quint16 b) { return static_cast<quint16>(std::min(0xffff, a + b)); });
+        mBins.buildLevels(lane.errors, 1, [](quint8 a, quint8 b) { return static_cast<quint8>(a | b); });
+
+        for (int level = 0; level < mBins.levels(); ++level)
+        {
+            const quint16 *counts = lane.counts.data() + mBins.offset(level);
+            quint32& max = mMaxCount[static_cast<size_t>(level)];
+
+            for (int bin = 0; bin < mBins.bins(level); ++bin)
+                max = std::max(max, static_cast<quint32>(counts[bin]));
+        }
+    }
+
+    MSG_DEBUG("Timeline: " << mLanes.size() << " lanes, " << mBins.bins(0) << " bins of " << mBins.binWidth(0) << " us, " << mBins.levels() << " levels");
+}
+
+/**
+ * @brief TTimelineData::sample
+ * Reads a range of bins of a level.
+ *
+ * @param lane  The lane.
+ * @param level The level.
+ * @param from  The first bin.
+ * @param to    The bin after the last bin.
+ * @param count Returns the number of rows in the bins.
+ * @param error Returns TRUE if one of the bins contains an error.
+ */
+void TTimelineData::sample(int lane, int level, int from, int to, quint32 *count, bool *error) const
+{
+    *count = 0;
+    *error = false;
+    from = std::max(0, from);
+    to = std::min(mBins.bins(level), to);
+
+    const LANE_t& l = mLanes[static_cast<size_t>(lane)];
+    size_t offset = mBins.offset(level);
+
+    for (int bin = from; bin < to; ++bin)
+    {
+        *count += l.counts[offset + static_cast<size_t>(bin)];
+        *error = *error || l.errors[offset + static_cast<size_t>(bin)] != 0;
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTIMELINEDATA_H
+#define TTIMELINEDATA_H
+
+#include <QStringList>
+
+#include <vector>
+
+#include "ttimebins.h"
+
+/**
+ * @brief The TTimelineData class
+ * Counts the rows of every thread (lane) over time for TTimeline.
+ *
+ * Every lane keeps the number of rows and a flag for errors in every bin
+ * of a TTimeBins pyramid.
+ *
+ * The counts saturate at 65535 per bin; they are shown on a logarithmic
+ * scale anyway.
+ *
+ * The bins of a lane are allocated with its first row, so threads without
+ * rows cost nothing. At most \p maxLanes lanes are kept; if there are more
+ * threads, the threads starting last share one "other" lane.
+ */
+class TTimelineData
+{
+    public:
+        TTimelineData(const QStringList& lanes, qint64 first, qint64 last, int maxLanes=256);
+
+        void add(int lane, qint64 usec, bool error);
+        void finish();
+
+        int lanes() const { return static_cast<int>(mLanes.size()); }
+        const QString& laneName(int lane) const { return mLanes[lane].name; }
+        qint64 laneRows(int lane) const { return mLanes[lane].rows; }
+        const TTimeBins& timeBins() const { return mBins; }
+        quint32 maxCount(int level) const { return mMaxCount[level]; }
+        void sample(int lane, int level, int from, int to, quint32 *count, bool *error) const;
+
+    private:
+        typedef struct LANE_t
+        {
+            QString name;
+            qint64 rows{0};                     // The number of rows of the lane
+            std::vector<quint16> counts;        // The rows of every bin of every level
+            std::vector<quint8> errors;         // 1 = the bin contains an error
+        }LANE_t;
+
+        int addLane(int lane);
+
+        TTimeBins mBins;                        // The layout of the bins of a lane
+        QStringList mNames;                     // The names of all threads
+        std::vector<int> mLaneOf;               // The lane of every thread (-1 = no rows yet)
+        int mMaxLanes{256};
+        int mOther{-1};                         // The lane shared by the remaining threads
+        int mOtherThreads{0};                   // The number of threads in the other lane
+        std::vector<LANE_t> mLanes;
+        std::vector<quint32> mMaxCount;         // The highest count of a bin of every level
+};
+
+#endif // TTIMELINEDATA_H
@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include "ttimeparser.h"
+#include "tlogger.h"
+
+#define USEC_PER_SEC    1000000LL
+#define SEC_PER_DAY     86400LL
+#define ISO_DATE_LENGTH 10              // Length of "yyyy-mm-dd"
+
+namespace
+{
+    const char *monthNames[] = { "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec" };
+
+    inline unsigned code(char c) { return static_cast<unsigned char>(c); }
+    inline unsigned code(QChar c) { return c.unicode(); }
+
+    // Reads a number with a fixed number of digits. The digits are checked
+    // all together after the loop, which keeps the loop free of branches.
+    template<typename C>
+    inline bool number(const C *str, qsizetype len, qsizetype& pos, int width, int& value)
+    {
+        if (pos + width > len)
+            return false;
+
+        unsigned bad = 0;
+        int val = 0;
+
+        for (int i = 0; i < width; ++i)
+        {
+            unsigned digit = code(str[pos + i]) - '0';
+            bad |= (digit > 9);
+            val = val * 10 + static_cast<int>(digit);
+        }
+
+        pos += width;
+        value = val;
+        return bad == 0;
+    }
+
+    // Reads 1 to 9 digits of a fraction of a second and converts it into
+    // microseconds.
+    template<typename C>
+    inline bool fraction(const C *str, qsizetype len, qsizetype& pos, qint64& usec)
+    {
+        static const qint64 scale[] = { 0, 100000, 10000, 1000, 100, 10, 1 };
+        qint64 val = 0;
+        int digits = 0;
+
+        while (pos < len && digits < 9 && code(str[pos]) - '0' <= 9)
+        {
+            val = val * 10 + (code(str[pos]) - '0');
+            pos++;
+            digits++;
+        }
+
+        while (pos < len && code(str[pos]) - '0' <= 9)     // Ignore more precise digits
+            pos++;
+
+        if (digits == 0)
+            return false;
+
+        if (digits <= 6)
+            usec = val * scale[digits];
+        else
+            usec = val / (digits == 7 ? 10 : (digits == 8 ? 100 : 1000));
+
+        return true;
+    }
+
+    // Reads a time zone (Z, +hh, +hhmm or +hh:mm) and returns its offset in
+    // seconds. A missing time zone is treated as UTC.
+    template<typename C>
+    inline bool zone(const C *str, qsizetype len, qsizetype& pos, qint64& offset)
+    {
+        offset = 0;
+
+        if (pos >= len)
+            return true;
+
+        unsigned c = code(str[pos]);
+
+        if (c == 'Z' || c == 'z')
+        {
+            pos++;
+            return true;
+        }
+
+        if (c != '+' && c != '-')
+            return true;
+
+        int hours = 0, minutes = 0;
+        pos++;
+
+        if (!number(str, len, pos, 2, hours))
+            return false;
+
+        if (pos < len && code(str[pos]) == ':')
+            pos++;
+
+        if (pos + 2 <= len && code(str[pos]) - '0' <= 9)
+        {
+            if (!number(str, len, pos, 2, minutes))
+                return false;
+        }
+
+        offset = (hours * 3600 + minutes * 60) * (c == '-' ? -1 : 1);
+        return true;
+    }
+
+    template<typename C>
+    inline int monthOf(const C *str)
+    {
+        char name[3];
+
+        for (int i = 0; i < 3; ++i)
+            name[i] = static_cast<char>(code(str[i]) | 0x20);      // Lower case (letters only)
+
+        for (int m = 0; m < 12; ++m)
+        {
+            if (name[0] == monthNames[m][0] && name[1] == monthNames[m][1] && name[2] == monthNames[m][2])
+                return m + 1;
+        }
+
+        return 0;
+    }
+}
+
+TTimeParser::TTimeParser(const QString& layout)
+{
+    DECL_TRACER("TTimeParser::TTimeParser(const QString& layout)");
+
+    if (layout.trimmed().isEmpty())
+    {
+        mDateLength = ISO_DATE_LENGTH;
+        return;
+    }
+
+    for (qsizetype i = 0; i < layout.size(); ++i)
+    {
+        FIELD_t field;
+        char c = layout[i].toLatin1();
+
+        if (c != '%')
+        {
+            field.literal = c;
+            mFields.push_back(field);
+            continue;
+        }
+
+        if (++i >= layout.size())
+        {
+            mValid = false;
+            mError = "Incomplete conversion at the end of the layout";
+            break;
+        }
+
+        switch(layout[i].toLatin1())
+        {
+            case 'Y': field.op = OP_YEAR4; break;
+            case 'y': field.op = OP_YEAR2; break;
+            case 'm': field.op = OP_MONTH; break;
+            case 'b': field.op = OP_MONTH_NAME; break;
+            case 'd': field.op = OP_DAY; break;
+            case 'e': field.op = OP_DAY_BLANK; break;
+            case 'H': field.op = OP_HOUR; break;
+            case 'M': field.op = OP_MINUTE; break;
+            case 'S': field.op = OP_SECOND; break;
+            case 'f': field.op = OP_FRACTION; break;
+            case 'z': field.op = OP_ZONE; break;
+            case 's': field.op = OP_EPOCH; break;
+            case '%': field.literal = '%'; break;
+
+            case 'F':
+                mFields.push_back({OP_YEAR4, 0});
+                mFields.push_back({OP_LITERAL, '-'});
+                mFields.push_back({OP_MONTH, 0});
+                mFields.push_back({OP_LITERAL, '-'});
+                field.op = OP_DAY;
+            break;
+
+            case 'T':
+                mFields.push_back({OP_HOUR, 0});
+                mFields.push_back({OP_LITERAL, ':'});
+                mFields.push_back({OP_MINUTE, 0});
+                mFields.push_back({OP_LITERAL, ':'});
+                field.op = OP_SECOND;
+            break;
+
+            default:
+                mValid = false;
+                mError = QString("Unknown conversion %%1 in the layout").arg(layout[i]);
+        }
+
+        if (!mValid)
+            break;
+
+        mFields.push_back(field);
+    }
+
+    if (!mValid)
+    {
+        MSG_ERROR("Invalid timestamp layout \"" << layout.toStdString() << "\": " << mError.toStdString());
+        mFields.clear();
+        mDateLength = ISO_DATE_LENGTH;
+        return;
+    }
+
+    // Find the date at the start of the layout. It can be cached if all
+    // fields of it have a fixed width.
+    int length = 0;
+    bool date = false;
+
+    for (size_t f = 0; f < mFields.size(); ++f)
+    {
+        OP_t op = mFields[f].op;
+
+        if (op == OP_LITERAL)
+            length++;
+        else if (op == OP_YEAR4)
+            length += 4;
+        else if (op == OP_MONTH_NAME)
+            length += 3;
+        else if (op == OP_YEAR2 || op == OP_MONTH || op == OP_DAY || op == OP_DAY_BLANK)
+            length += 2;
+        else
+            break;
+
+        if (op != OP_LITERAL)
+        {
+            date = true;
+            mDateFields = f + 1;
+            mDateLength = length;
+        }
+    }
+
+    if (!date || mDateLength > static_cast<int>(sizeof(mDate) / sizeof(mDate[0])))
+    {
+        mDateFields = 0;
+        mDateLength = 0;
+    }
+}
+
+qint64 TTimeParser::parse(const char *str, qsizetype len)
+{
+    while (len > 0 && (*str == ' ' || *str == '\t' || (*str == '[' && skipBracket())))
+    {
+        str++;
+        len--;
+    }
+
+    return mFields.empty() ? parseAuto(str, len) : parseLayout(str, len);
+}
+
+qint64 TTimeParser::parse(const QChar *str, qsizetype len)
+{
+    while (len > 0 && (str->unicode() == ' ' || str->unicode() == '\t' || (str->unicode() == '[' && skipBracket())))
+    {
+        str++;
+        len--;
+    }
+
+    return mFields.empty() ? parseAuto(str, len) : parseLayout(str, len);
+}
+
+template<typename C>
+qint64 TTimeParser::parseLayout(const C *str, qsizetype len)
+{
+    int year = 1970, month = 1, day = 1, hour = 0, minute = 0, second = 0;
+    qint64 usec = 0, offset = 0, epoch = 0, days = 0;
+    bool isEpoch = false;
+    bool haveDays = false;
+    qsizetype pos = 0;
+    size_t f = 0;
+
+    if (mDateLength > 0 && cachedDate(str, len))   // Same date as before?
+    {
+        f = mDateFields;
+        pos = mDateLength;
+        days = mDays;
+        haveDays = true;
+    }
+
+    for (; f < mFields.size(); ++f)
+    {
+        bool ok = true;
+
+        switch(mFields[f].op)
+        {
+            case OP_LITERAL:
+                ok = (pos < len && code(str[pos]) == code(mFields[f].literal));
+                pos++;
+            break;
+
+            case OP_YEAR4:      ok = number(str, len, pos, 4, year); break;
+            case OP_YEAR2:      ok = number(str, len, pos, 2, year); year += 2000; break;
+            case OP_MONTH:      ok = number(str, len, pos, 2, month); break;
+            case OP_DAY:        ok = number(str, len, pos, 2, day); break;
+            case OP_HOUR:       ok = number(str, len, pos, 2, hour); break;
+            case OP_MINUTE:     ok = number(str, len, pos, 2, minute); break;
+            case OP_SECOND:     ok = number(str, len, pos, 2, second); break;
+            case OP_FRACTION:   ok = fraction(str, len, pos, usec); break;
+            case OP_ZONE:       ok = zone(str, len, pos, offset); break;
+
+            case OP_MONTH_NAME:
+                ok = (pos + 3 <= len && (month = monthOf(str + pos)) > 0);
+                pos += 3;
+            break;
+
+            case OP_DAY_BLANK:
+                if (pos < len && code(str[pos]) == ' ')
+                {
+                    pos++;
+                    ok = number(str, len, pos, 1, day);
+                }
+                else
+                    ok = number(str, len, pos, 2, day);
+            break;
+
+            case OP_EPOCH:
+            {
+                int digits = 0;
+
+                while (pos < len && digits < 19 && code(str[pos]) - '0' <= 9)
+                {
+                    epoch = epoch * 10 + (code(str[pos]) - '0');
+                    pos++;
+                    digits++;
+                }
+
+                ok = (digits > 0);
+                isEpoch = true;
+            }
+            break;
+        }
+
+        if (!ok)
+            return INVALID;
+    }
+
+    if (isEpoch)
+        return (epoch - offset) * USEC_PER_SEC + usec;
+
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+        return INVALID;
+
+    if (!haveDays)
+    {
+        days = daysFromCivil(year, month, day);
+
+        if (mDateLength > 0)
+            cacheDate(str, days);
+    }
+
+    return ((days * SEC_PER_DAY + hour * 3600 + minute * 60 + second) - offset) * USEC_PER_SEC + usec;
+}
+
+template<typename C>
+qint64 TTimeParser::parseAuto(const C *str, qsizetype len)
+{
+    qsizetype digits = 0;
+
+    while (digits < len && digits < 20 && code(str[digits]) - '0' <= 9)
+        digits++;
+
+    if (digits != 4 || len < ISO_DATE_LENGTH || code(str[4]) != '-')      // Not a date; maybe an epoch value
+    {
+        if (digits < len && (code(str[digits]) - '0' <= 9 || code(str[digits]) == '-'))
+            return INVALID;
+
+        qint64 val = 0;
+
+        for (qsizetype i = 0; i < digits; ++i)
+            val = val * 10 + (code(str[i]) - '0');
+
+        switch(digits)
+        {
+            case 10: return val * USEC_PER_SEC;
+            case 13: return val * 1000;
+            case 16: return val;
+        }
+
+        return INVALID;
+    }
+
+    qint64 days = 0;
+    qsizetype pos = 0;
+
+    if (cachedDate(str, len))
+    {
+        days = mDays;
+        pos = ISO_DATE_LENGTH;
+    }
+    else
+    {
+        int year = 0, month = 0, day = 0;
+
+        if (!number(str, len, pos, 4, year) || code(str[pos++]) != '-' ||
+            !number(str, len, pos, 2, month) || code(str[pos++]) != '-' ||
+            !number(str, len, pos, 2, day) || month < 1 || month > 12 || day < 1 || day > 31)
+            return INVALID;
+
+        days = daysFromCivil(year, month, day);
+        cacheDate(str, days);
+    }
+
+    qint64 usec = days * SEC_PER_DAY * USEC_PER_SEC;
+
+    if (pos >= len || (code(str[pos]) != 'T' && code(str[pos]) != 't' && code(str[pos]) != ' '))
+        return usec;                                // Only a date
+
+    int hour = 0, minute = 0, second = 0;
+    qint64 frac = 0, offset = 0;
+    pos++;
+
+    if (!number(str, len, pos, 2, hour) || pos >= len || code(str[pos++]) != ':' || !number(str, len, pos, 2, minute))
+        return usec;                                // The date is followed by something else
+
+    if (pos < len && code(str[pos]) == ':')
+    {
+        pos++;
+
+        if (!number(str, len, pos, 2, second))
+            return INVALID;
+    }
+
+    if (pos < len && (code(str[pos]) == '.' || code(str[pos]) == ','))
+    {
+        pos++;
+
+        if (!fraction(str, len, pos, frac))
+            return INVALID;
+    }
+
+    if (!zone(str, len, pos, offset) || hour > 23 || minute > 59 || second > 60)
+        return INVALID;
+
+    return usec + ((hour * 3600 + minute * 60 + second) - offset) * USEC_PER_SEC + frac;
+}
+
+template<typename C>
+bool TTimeParser::cachedDate(const C *str, qsizetype len)
+{
+    if (!mHaveDate || len < mDateLength)
+        return false;
+
+    for (int i = 0; i < mDateLength; ++i)
+    {
+        if (code(str[i]) != mDate[i])
+            return false;
+    }
+
+    return true;
+}
+
+template<typename C>
+void TTimeParser::cacheDate(const C *str, qint64 days)
+{
+    for (int i = 0; i < mDateLength; ++i)
+        mDate[i] = static_cast<char16_t>(code(str[i]));
+
+    mDays = days;
+    mHaveDate = true;
+}
+
+/**
+ * @brief TTimeParser::daysFromCivil
+ * Calculates the number of days since 1970-01-01 of a date of the
+ * proleptic Gregorian calendar.
+ *
+ * @param year  The year.
+ * @param month The month (1 - 12).
+ * @param day   The day (1 - 31).
+ * @return The number of days since 1970-01-01.
+ */
+qint64 TTimeParser::daysFromCivil(int year, int month, int day)
+{
+    year -= (month <= 2);
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const qint64 yoe = year - era * 400;                                    // [0, 399]
+    const qint64 doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;  // [0, 365]
+    const qint64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;               // [0, 146096]
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief TTimeParser::toString
+ * Converts microseconds since the epoch into a readable timestamp in the
+ * form "yyyy-mm-dd hh:mm:ss.uuuuuu".
+ *
+ * @param usec  Microseconds since 1970-01-01 00:00:00.
+ * @return The timestamp.
+ */
+QString TTimeParser::toString(qint64 usec)
+{
+    if (usec == INVALID)
+        return QString();
+
+    qint64 secs = usec / USEC_PER_SEC;
+    qint64 frac = usec % USEC_PER_SEC;
+
+    if (frac < 0)
+    {
+        frac += USEC_PER_SEC;
+        secs--;
+    }
+
+    qint64 days = secs / SEC_PER_DAY;
+    qint64 rest = secs % SEC_PER_DAY;
+
+    if (rest < 0)
+    {
+        rest += SEC_PER_DAY;
+        days--;
+    }
+
+    // Inverse of daysFromCivil()
+    days += 719468;
+    const qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+    const qint64 doe = days - era * 146097;
+    const qint64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const qint64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const qint64 mp = (5 * doy + 2) / 153;
+    const qint64 day = doy - (153 * mp + 2) / 5 + 1;
+    const qint64 month = mp < 10 ? mp + 3 : mp - 9;
+    const qint64 year = yoe + era * 400 + (month <= 2);
+
+    return QString("%1-%2-%3 %4:%5:%6.%7")
+        .arg(year, 4, 10, QChar('0'))
+        .arg(month, 2, 10, QChar('0'))
+        .arg(day, 2, 10, QChar('0'))
+        .arg(rest / 3600, 2, 10, QChar('0'))
+        .arg((rest / 60) % 60, 2, 10, QChar('0'))
+        .arg(rest % 60, 2, 10, QChar('0'))
+        .arg(frac, 6, 10, QChar('0'));
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTIMEPARSER_H
+#define TTIMEPARSER_H
+
+#include <QString>
+
+#include <vector>
+#include <climits>
+
+/**
+ * @brief The TTimeParser class
+ * Converts timestamps into microseconds since 1970-01-01 00:00:00. The
+ * layout of a timestamp is defined like the format of strftime(). The
+ * following conversions are supported:
+ *
+ *   %Y  Year with 4 digits         %y  Year with 2 digits (2000 - 2099)
+ *   %m  Month (01 - 12)            %b  Abbreviated month name (Jan - Dec)
+ *   %d  Day (01 - 31)              %e  Day, padded with a blank
+ *   %H  Hour (00 - 23)             %M  Minute (00 - 59)
+ *   %S  Second (00 - 60)           %f  Fraction of a second (1 - 9 digits)
+ *   %z  Time zone (Z, +hh, +hhmm or +hh:mm)
+ *   %s  Seconds since the epoch    %F  Same as %Y-%m-%d
+ *   %T  Same as %H:%M:%S           %%  The character %
+ *
+ * Without a layout, ISO 8601 timestamps (with a 'T' or a blank between date
+ * and time, optional fraction and optional time zone) and numeric epoch
+ * values with 10 (s), 13 (ms) or 16 (µs) digits are recognized. A '[' in
+ * front of the timestamp is skipped, unless the layout starts with one.
+ *
+ * A layout is compiled once into a list of fixed width fields. Because the
+ * date rarely changes between consecutive lines, the date part of the last
+ * timestamp is cached and only the time fields are parsed if the date is
+ * the same. Therefore a parser must not be shared between threads.
+ */
+class TTimeParser
+{
+    public:
+        static constexpr qint64 INVALID = LLONG_MIN;    // Returned if a timestamp can't be parsed
+
+        explicit TTimeParser(const QString& layout=QString());
+
+        bool isValid() { return mValid; }
+        QString& errorString() { return mError; }
+
+        qint64 parse(const char *str, qsizetype len);
+        qint64 parse(const QString& str) { return parse(str.constData(), str.size()); }
+        qint64 parse(const QChar *str, qsizetype len);
+
+        static qint64 daysFromCivil(int year, int month, int day);
+        static QString toString(qint64 usec);
+
+    private:
+        typedef enum OP_t
+        {
+            OP_LITERAL,
+            OP_YEAR4,
+            OP_YEAR2,
+            OP_MONTH,
+            OP_MONTH_NAME,
+            OP_DAY,
+            OP_DAY_BLANK,
+            OP_HOUR,
+            OP_MINUTE,
+            OP_SECOND,
+            OP_FRACTION,
+            OP_ZONE,
+            OP_EPOCH
+        }OP_t;
+
+        typedef struct FIELD_t
+        {
+            OP_t op{OP_LITERAL};
+            char literal{0};                    // The character of a literal
+        }FIELD_t;
+
+        bool skipBracket() const { return mFields.empty() || mFields.front().literal != '['; }
+        template<typename C> qint64 parseLayout(const C *str, qsizetype len);
+        template<typename C> qint64 parseAuto(const C *str, qsizetype len);
+        template<typename C> bool cachedDate(const C *str, qsizetype len);
+        template<typename C> void cacheDate(const C *str, qint64 days);
+
+        bool mValid{true};
+        QString mError;
+        std::vector<FIELD_t> mFields;           // The compiled layout; empty = ISO 8601 or epoch
+        size_t mDateFields{0};                  // Number of fields belonging to the date prefix
+        int mDateLength{0};                     // Number of characters of the date prefix (0 = not cacheable)
+        char16_t mDate[32];                     // The date prefix of the last timestamp
+        bool mHaveDate{false};                  // TRUE = mDate and mDays are valid
+        qint64 mDays{0};                        // The days since the epoch of the cached date
+};
+
+#endif // TTIMEPARSER_H
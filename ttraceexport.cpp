@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <filesystem>
+
+#include "ttraceexport.h"
+#include "tlogger.h"
+
+#define BUFFER_SIZE     (1024 * 1024)           // The buffer is written when it gets bigger than this
+
+namespace fs = std::filesystem;
+
+TTraceExport::TTraceExport(const QString& file)
+    : mFile(file),
+      mPartFile(file + ".part")
+{
+    DECL_TRACER("TTraceExport::TTraceExport(const QString& file)");
+}
+
+TTraceExport::~TTraceExport()
+{
+    DECL_TRACER("TTraceExport::~TTraceExport()");
+
+    if (mStream.is_open())                      // Not closed: canceled or failed
+    {
+        mStream.close();
+        std::error_code ec;
+        fs::remove(mPartFile.toStdString(), ec);
+    }
+}
+
+/**
+ * @brief TTraceExport::open
+ * Creates the file and writes the header of the trace.
+ *
+ * @param process   The name of the process shown in the trace viewer.
+ * @return TRUE on success.
+ */
+bool TTraceExport::open(const QString& process)
+{
+    DECL_TRACER("TTraceExport::open(const QString& process)");
+
+    mStream.open(mPartFile.toStdString(), std::ofstream::trunc | std::ofstream::binary);
+
+    if (!mStream.is_open())
+    {
+        mError = QString("Can't create the file %1!").arg(mFile);
+        MSG_ERROR("Can't create the file " << mFile.toStdString());
+        return false;
+    }
+
+    mBuffer.reserve(BUFFER_SIZE + 4096);
+    mBuffer.append("{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":");
+    appendString(process);
+    mBuffer.append("}}");
+    return true;
+}
+
+/**
+ * @brief TTraceExport::addCall
+ * Writes one call as a complete event. The signature matches
+ * TCallTree::CALL_HANDLER.
+ *
+ * @param method    The name of the method.
+ * @param thread    The thread ID as shown in the logfile.
+ * @param row       The row of the entry; it is shown as an argument.
+ * @param start     The time of the entry in microseconds.
+ * @param duration  The duration in microseconds.
+ */
+void TTraceExport::addCall(const QString& method, const QString& thread, int row, qint64 start, qint64 duration)
+{
+    if (!mStream.is_open())
+        return;
+
+    int tid = threadId(thread);
+    appendEvent();
+    mBuffer.append("{\"name\":");
+    appendString(method);
+    mBuffer.append(",\"cat\":\"block\",\"ph\":\"X\",\"ts\":");
+    mBuffer.append(std::to_string(start));
+    mBuffer.append(",\"dur\":");
+    mBuffer.append(std::to_string(duration));
+    mBuffer.append(",\"pid\":1,\"tid\":");
+    mBuffer.append(std::to_string(tid));
+    mBuffer.append(",\"args\":{\"line\":");
+    mBuffer.append(std::to_string(row + 1));
+    mBuffer.append("}}");
+    mEvents++;
+}
+
+/**
+ * @brief TTraceExport::close
+ * Writes the end of the trace, closes the file and renames it to the
+ * target.
+ *
+ * @return TRUE if the whole trace was written.
+ */
+bool TTraceExport::close()
+{
+    DECL_TRACER("TTraceExport::close()");
+
+    if (!mStream.is_open())
+        return false;
+
+    mBuffer.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+    flush();
+    mStream.close();
+    std::error_code ec;
+
+    if (mStream.fail())
+    {
+        mError = QString("Error writing the file %1!").arg(mFile);
+        MSG_ERROR("Error writing the file " << mFile.toStdString());
+        fs::remove(mPartFile.toStdString(), ec);
+        return false;
+    }
+
+    fs::rename(mPartFile.toStdString(), mFile.toStdString(), ec);
+
+    if (ec)
+    {
+        mError = QString("Can't rename the file %1 to %2: %3").arg(mPartFile, mFile, QString::fromStdString(ec.message()));
+        MSG_ERROR("Can't rename " << mPartFile.toStdString() << " to " << mFile.toStdString() << ": " << ec.message());
+        fs::remove(mPartFile.toStdString(), ec);
+        return false;
+    }
+
+    MSG_DEBUG("Exported " << mEvents << " calls of " << mThreads.size() << " threads to " << mFile.toStdString());
+    return true;
+}
+
+/**
+ * @brief TTraceExport::threadId
+ * Returns the numeric ID of a thread. A thread seen the first time gets
+ * the next ID and a metadata event naming it.
+ *
+ * @param thread    The thread ID as shown in the logfile.
+ * @return The numeric ID of the thread.
+ */
+int TTraceExport::threadId(const QString& thread)
+{
+    auto iter = mThreads.constFind(thread);
+
+    if (iter != mThreads.constEnd())
+        return iter.value();
+
+    int tid = static_cast<int>(mThreads.size()) + 1;
+    mThreads.insert(thread, tid);
+    appendEvent();
+    mBuffer.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+    mBuffer.append(std::to_string(tid));
+    mBuffer.append(",\"args\":{\"name\":");
+    appendString(thread.isEmpty() ? QString("main") : thread);
+    mBuffer.append("}}");
+    return tid;
+}
+
+void TTraceExport::appendEvent()
+{
+    if (mBuffer.size() >= BUFFER_SIZE)
+        flush();
+
+    mBuffer.append(",\n");
+}
+
+void TTraceExport::flush()
+{
+    mStream.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+    mBuffer.clear();
+}
+
+/**
+ * @brief TTraceExport::appendString
+ * Appends a string as a quoted JSON string.
+ *
+ * @param str   The string.
+ */
+void TTraceExport::appendString(const QString& str)
+{
+    QByteArray utf8 = str.toUtf8();
+    static const char hex[] = "0123456789abcdef";
+
+    mBuffer.push_back('"');
+
+    for (char c : utf8)
+    {
+        unsigned char ch = static_cast<unsigned char>(c);
+
+        if (ch == '"' || ch == '\\')
+        {
+            mBuffer.push_back('\\');
+            mBuffer.push_back(c);
+        }
+        else if (ch < 0x20)
+        {
+            mBuffer.append("\\u00");
+            mBuffer.push_back(hex[ch >> 4]);
+            mBuffer.push_back(hex[ch & 0x0f]);
+        }
+        else
+            mBuffer.push_back(c);
+    }
+
+    mBuffer.push_back('"');
+}
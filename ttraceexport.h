@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTRACEEXPORT_H
+#define TTRACEEXPORT_H
+
+#include <QString>
+#include <QHash>
+
+#include <string>
+#include <fstream>
+
+/**
+ * @brief The TTraceExport class
+ * Writes calls as a trace in the Chrome trace event format (JSON). The file
+ * can be opened by Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Every call becomes a complete event ("ph":"X") with the time of its entry
+ * and its duration. Every thread gets a numeric ID and a metadata event
+ * with its name. The events are written through a small buffer as they
+ * arrive, so the memory needed doesn't depend on the size of the trace.
+ *
+ * The trace is written to a temporary file beside the target, which is
+ * renamed only when close() succeeded. If the export is canceled or fails,
+ * the temporary file is removed and an existing target stays untouched.
+ */
+class TTraceExport
+{
+    public:
+        explicit TTraceExport(const QString& file);
+        ~TTraceExport();
+
+        bool open(const QString& process);
+        void addCall(const QString& method, const QString& thread, int row, qint64 start, qint64 duration);
+        bool close();
+        qint64 events() const { return mEvents; }
+        const QString& errorString() const { return mError; }
+
+    private:
+        int threadId(const QString& thread);
+        void appendEvent();
+        void flush();
+        void appendString(const QString& str);
+
+        QString mFile;
+        QString mPartFile;                      // The temporary file written until close()
+        std::ofstream mStream;
+        std::string mBuffer;                    // The events not written yet
+        QHash<QString, int> mThreads;           // The numeric ID of every thread
+        qint64 mEvents{0};                      // The number of calls written
+        QString mError;
+};
+
+#endif // TTRACEEXPORT_H
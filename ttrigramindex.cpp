@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <climits>
+
+#include "ttrigramindex.h"
+#include "tlogindex.h"
+#include "tlogger.h"
+
+#define MAX_THREADS     4                   // Every thread needs about 30 MB for its part
+#define MIN_PART_BLOCKS 1024                // Minimum number of blocks indexed by one thread
+#define KEYS            (1 << TTrigramIndex::KEY_BITS)
+#define NO_BLOCK        UINT_MAX
+
+using std::vector;
+using std::thread;
+
+TTrigramIndex::TTrigramIndex(const TLogIndex *index)
+    : mIndex(index)
+{
+    DECL_TRACER("TTrigramIndex::TTrigramIndex(const TLogIndex *index)");
+}
+
+TTrigramIndex::~TTrigramIndex()
+{
+    DECL_TRACER("TTrigramIndex::~TTrigramIndex()");
+
+    mCancel = true;
+
+    if (mThread.joinable())
+        mThread.join();
+}
+
+/**
+ * @brief TTrigramIndex::start
+ * Starts to build the index in the background.
+ *
+ * @param ready     Called by the background thread when the index is ready.
+ */
+void TTrigramIndex::start(const std::function<void()>& ready)
+{
+    DECL_TRACER("TTrigramIndex::start(const std::function<void()>& ready)");
+
+    if (mThread.joinable() || !mIndex || mIndex->size() == 0)
+        return;
+
+    mReadyCallback = ready;
+    mThread = thread(&TTrigramIndex::build, this);
+}
+
+quint32 TTrigramIndex::key(const char *tri)
+{
+    quint32 v = (static_cast<quint8>(tri[0]) << 16) | (static_cast<quint8>(tri[1]) << 8) | static_cast<quint8>(tri[2]);
+    return (v * 2654435761u) >> (32 - KEY_BITS);
+}
+
+void TTrigramIndex::putVarint(vector<quint8>& out, quint32 value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<quint8>(value | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<quint8>(value));
+}
+
+quint32 TTrigramIndex::getVarint(const quint8 *& pos)
+{
+    quint32 value = 0;
+    int shift = 0;
+
+    while (*pos & 0x80)
+    {
+        value |= static_cast<quint32>(*pos++ & 0x7f) << shift;
+        shift += 7;
+    }
+
+    value |= static_cast<quint32>(*pos++) << shift;
+    return value;
+}
+
+void TTrigramIndex::build()
+{
+    DECL_TRACER("TTrigramIndex::build()");
+
+    QElapsedTimer timer;
+    timer.start();
+    qsizetype total = mIndex->size();
+    mBlocks = static_cast<quint32>((total + BLOCK_RECORDS - 1) / BLOCK_RECORDS);
+    qint64 numThreads = std::min(static_cast<qint64>(std::max(1u, thread::hardware_concurrency())), static_cast<qint64>(MAX_THREADS));
+    numThreads = std::max(static_cast<qint64>(1), std::min(numThreads, static_cast<qint64>(mBlocks / MIN_PART_BLOCKS)));
+    vector<PART_t> parts(numThreads);
+    vector<thread> threads;
+
+    for (qint64 t = 0; t < numThreads; ++t)
+    {
+        quint32 from = static_cast<quint32>(mBlocks * t / numThreads);
+        quint32 to = static_cast<quint32>(mBlocks * (t + 1) / numThreads);
+        threads.emplace_back(buildPart, this, from, to, &parts[t]);
+    }
+
+    for (thread& th : threads)
+        th.join();
+
+    if (mCancel)
+        return;
+
+    // Concatenate the parts. The first block of a part was stored absolute
+    // and must be made relative to the last block of the previous part.
+    mStarts.assign(KEYS + 1, 0);
+    size_t size = 0;
+
+    for (const PART_t& part : parts)
+    {
+        for (const vector<quint8>& list : part.lists)
+            size += list.size();
+    }
+
+    mPostings.reserve(size);
+
+    for (quint32 k = 0; k < KEYS; ++k)
+    {
+        mStarts[k] = mPostings.size();
+        quint32 last = NO_BLOCK;
+
+        for (PART_t& part : parts)
+        {
+            vector<quint8>& list = part.lists[k];
+
+            if (list.empty())
+                continue;
+
+            const quint8 *pos = list.data();
+
+            if (last != NO_BLOCK)
+            {
+                quint32 first = getVarint(pos) - 1;     // Absolute
+                putVarint(mPostings, first - last);
+            }
+
+            const quint8 *end = list.data() + list.size();
+            mPostings.insert(mPostings.end(), pos, end);
+            last = part.last[k];
+            vector<quint8>().swap(list);
+        }
+    }
+
+    mStarts[KEYS] = mPostings.size();
+    mBuildTime = timer.elapsed();
+    mReady = true;
+    MSG_INFO("Search index of " << mBlocks << " blocks built in " << mBuildTime << " ms using " << numThreads << " threads; " << (memoryUsage() / 1024) << " KB");
+
+    if (mReadyCallback)
+        mReadyCallback();
+}
+
+/**
+ * @brief TTrigramIndex::buildPart
+ * Indexes the blocks from \p from up to \p to. The first block of a list is
+ * stored as block + 1, all others as difference to the previous block.
+ */
+void TTrigramIndex::buildPart(const TTrigramIndex *trigrams, quint32 from, quint32 to, PART_t *part)
+{
+    const TLogIndex *index = trigrams->mIndex;
+    const char *data = index->data();
+    qsizetype total = index->size();
+    part->lists.resize(KEYS);
+    part->last.assign(KEYS, NO_BLOCK);
+
+    for (quint32 block = from; block < to && !trigrams->mCancel; ++block)
+    {
+        qsizetype end = std::min(static_cast<qsizetype>(block + 1) * BLOCK_RECORDS, total);
+
+        for (qsizetype rec = static_cast<qsizetype>(block) * BLOCK_RECORDS; rec < end; ++rec)
+        {
+            const char *start = data + index->offset(rec);
+            qint64 len = index->length(rec);
+
+            for (qint64 i = 0; i + 2 < len; ++i)
+            {
+                quint32 k = key(start + i);
+                quint32& last = part->last[k];
+
+                if (last == block)
+                    continue;
+
+                putVarint(part->lists[k], last == NO_BLOCK ? block + 1 : block - last);
+                last = block;
+            }
+        }
+    }
+}
+
+/**
+ * @brief TTrigramIndex::candidates
+ * Finds the blocks which may contain \p literal. These are the blocks
+ * contained in the lists of all trigrams of the literal. The lists are
+ * intersected starting with the shortest one.
+ *
+ * @param literal   The string every matching record contains.
+ * @param blocks    Receives the sorted numbers of the blocks.
+ * @return If the index is not ready or the literal is shorter than 3 bytes,
+ * FALSE is returned. The whole file must be searched then.
+ */
+bool TTrigramIndex::candidates(const QByteArray& literal, vector<quint32>& blocks) const
+{
+    DECL_TRACER("TTrigramIndex::candidates(const QByteArray& literal, vector<quint32>& blocks)");
+
+    blocks.clear();
+
+    if (!mReady || literal.size() < 3)
+        return false;
+
+    vector<quint32> keys;
+
+    for (qsizetype i = 0; i + 2 < literal.size(); ++i)
+        keys.push_back(key(literal.constData() + i));
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    // The shortest list first, so the candidates shrink fast
+    std::sort(keys.begin(), keys.end(), [this](quint32 a, quint32 b) {
+        return mStarts[a + 1] - mStarts[a] < mStarts[b + 1] - mStarts[b];
+    });
+
+    for (size_t n = 0; n < keys.size(); ++n)
+    {
+        const quint8 *pos = mPostings.data() + mStarts[keys[n]];
+        const quint8 *end = mPostings.data() + mStarts[keys[n] + 1];
+        qint64 block = -1;
+
+        if (n == 0)
+        {
+            while (pos < end)
+            {
+                block += getVarint(pos);
+                blocks.push_back(static_cast<quint32>(block));
+            }
+
+            continue;
+        }
+
+        size_t out = 0;                         // Keep the candidates also found in this list
+
+        for (size_t i = 0; i < blocks.size(); )
+        {
+            if (block < blocks[i])
+            {
+                if (pos >= end)
+                    break;
+
+                block += getVarint(pos);
+                continue;
+            }
+
+            if (block == blocks[i])
+                blocks[out++] = blocks[i];
+
+            i++;
+        }
+
+        blocks.resize(out);
+
+        if (blocks.empty())
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief TTrigramIndex::memoryUsage
+ * @return The number of bytes used by the index.
+ */
+qint64 TTrigramIndex::memoryUsage() const
+{
+    return static_cast<qint64>(mPostings.capacity() + mStarts.capacity() * sizeof(quint64));
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TTRIGRAMINDEX_H
+#define TTRIGRAMINDEX_H
+
+#include <QByteArray>
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+class TLogIndex;
+
+/**
+ * @brief The TTrigramIndex class
+ * An inverted index of all trigrams (3 consecutive bytes) of the records of
+ * a TLogIndex. It lets a search test only the records which contain every
+ * trigram of the searched literal instead of scanning the whole file.
+ *
+ * The records are grouped into blocks of BLOCK_RECORDS records. For every
+ * trigram the sorted list of blocks containing it is kept. The trigrams are
+ * hashed into 2^KEY_BITS keys, so a list may contain a few blocks too many,
+ * but never misses one. The lists are stored as differences of consecutive
+ * block numbers, encoded as variable length integers (7 bits per byte). A
+ * trigram occurring in every block costs one byte per block.
+ *
+ * The index is built in the background by several threads, each working on
+ * a part of the blocks. The parts are concatenated afterwards. Until the
+ * index is ready, candidates() returns FALSE and the search scans the file.
+ */
+class TTrigramIndex
+{
+    public:
+        static constexpr int BLOCK_RECORDS = 64;    // Number of records of a block
+        static constexpr int KEY_BITS = 20;         // Number of bits of a hashed trigram
+
+        explicit TTrigramIndex(const TLogIndex *index);
+        ~TTrigramIndex();
+
+        void start(const std::function<void()>& ready=nullptr);
+        bool isReady() const { return mReady; }
+        bool candidates(const QByteArray& literal, std::vector<quint32>& blocks) const;
+        qint64 memoryUsage() const;
+        qint64 buildTime() const { return mBuildTime; }
+        quint32 blocks() const { return mBlocks; }
+
+    private:
+        typedef struct PART_t
+        {
+            std::vector<std::vector<quint8>> lists; // The encoded list of every key
+            std::vector<quint32> last;          // The last block added to every key
+        }PART_t;
+
+        // Not copyable
+        TTrigramIndex(const TTrigramIndex&) = delete;
+        TTrigramIndex& operator=(const TTrigramIndex&) = delete;
+
+        void build();
+        static void buildPart(const TTrigramIndex *trigrams, quint32 from, quint32 to, PART_t *part);
+        static quint32 key(const char *tri);
+        static void putVarint(std::vector<quint8>& out, quint32 value);
+        static quint32 getVarint(const quint8 *& pos);
+
+        const TLogIndex *mIndex{nullptr};
+        std::thread mThread;
+        std::atomic<bool> mReady{false};
+        std::atomic<bool> mCancel{false};
+        std::function<void()> mReadyCallback;
+        quint32 mBlocks{0};                     // Number of blocks
+        std::vector<quint64> mStarts;           // The start of the list of every key in mPostings (one more than keys)
+        std::vector<quint8> mPostings;          // All lists of blocks, delta and varint encoded
+        qint64 mBuildTime{0};                   // Milliseconds used to build the index
+};
+
+#endif // TTRIGRAMINDEX_H
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#include <algorithm>
+#include <thread>
+
+#include "tvalidator.h"
+#include "tlogger.h"
+
+using std::vector;
+using std::thread;
+
+TValidator::TValidator(const QString& blockEntry, const QString& blockExit)
+    : mMatcher(blockEntry, blockExit)
+{
+    DECL_TRACER("TValidator::TValidator(const QString& blockEntry, const QString& blockExit)");
+}
+
+/**
+ * @brief TValidator::addRow
+ * Adds the next row. Lines without a block entry or exit are ignored.
+ *
+ * @param row       The row of the table.
+ * @param text      The text of the line.
+ * @param thread    The thread ID of the line or an empty string, if there
+ * is no thread column.
+ */
+void TValidator::addRow(int row, const QString& text, const QString& thread)
+{
+    EVENT_t event;
+    event.kind = mMatcher.parse(text, &event.method);
+
+    if (event.kind == TBlockMatcher::KIND_NONE)
+        return;
+
+    event.row = row;
+    auto iter = mThreadIndex.constFind(thread);
+
+    if (iter == mThreadIndex.constEnd())
+    {
+        iter = mThreadIndex.insert(thread, static_cast<int>(mThreads.size()));
+        mThreads.emplace_back();
+    }
+
+    mThreads[iter.value()].push_back(std::move(event));
+}
+
+/**
+ * @brief TValidator::validate
+ * Validates all threads. The threads take the threads of the logfile one
+ * after the other, starting with the largest.
+ */
+void TValidator::validate()
+{
+    DECL_TRACER("TValidator::validate()");
+
+    mErrors.clear();
+    mMismatches.clear();
+
+    if (mThreads.empty())
+        return;
+
+    std::sort(mThreads.begin(), mThreads.end(), [](const vector<EVENT_t>& a, const vector<EVENT_t>& b) { return a.size() > b.size(); });
+    size_t numThreads = std::min(static_cast<size_t>(std::max(1u, thread::hardware_concurrency())), mThreads.size());
+    vector<RESULT_t> results(mThreads.size());
+    std::atomic<size_t> next{0};
+    vector<thread> threads;
+
+    for (size_t t = 0; t < numThreads; ++t)
+        threads.emplace_back(validateThreads, this, &next, &results);
+
+    for (thread& th : threads)
+        th.join();
+
+    for (const RESULT_t& result : results)
+    {
+        for (int row : result.errors)
+            mErrors.add(static_cast<quint32>(row));
+
+        mMismatches.insert(mMismatches.end(), result.mismatches.begin(), result.mismatches.end());
+    }
+
+    std::sort(mMismatches.begin(), mMismatches.end(), [](const MISMATCH_t& a, const MISMATCH_t& b) { return a.row < b.row; });
+    MSG_DEBUG("Validated " << mThreads.size() << " threads using " << numThreads << " threads: " << mErrors.cardinality() << " errors, " << mMismatches.size() << " mismatches");
+}
+
+void TValidator::validateThreads(TValidator *self, std::atomic<size_t> *next, vector<RESULT_t> *results)
+{
+    for (size_t idx = (*next)++; idx < self->mThreads.size(); idx = (*next)++)
+        self->validateThread(self->mThreads[idx], (*results)[idx]);
+}
+
+/**
+ * @brief TValidator::validateThread
+ * Validates the lines of one thread. The open blocks are kept on a stack
+ * and closed by TBlockMatcher::close(), the same way TBlockIndex and
+ * TCallTree pair them. The rows of the open constructors are kept by class name. A destructor
+ * closes the last constructor of its class.
+ *
+ * @param events    The block lines of the thread in order.
+ * @param result    Receives the errors.
+ */
+void TValidator::validateThread(const vector<EVENT_t>& events, RESULT_t& result)
+{
+    vector<FRAME_t> blocks;                                 // The open blocks
+    QHash<QString, vector<int>> objects;                    // The rows of the open constructors by class
+
+    for (const EVENT_t& event : events)
+    {
+        const QString& method = mMatcher.name(event.method);
+
+        if (event.kind == TBlockMatcher::KIND_ENTRY)
+        {
+            blocks.push_back({ event.method, event.row });
+            qsizetype pos = method.indexOf("::");
+
+            if (pos != -1)
+            {
+                QString left = method.left(pos);
+                QStringView right = QStringView(method).mid(pos + 2);
+
+                if (right.contains(left) && !right.startsWith(u'~'))    // A constructor?
+                    objects[left].push_back(event.row);
+            }
+
+            continue;
+        }
+
+        FRAME_t frame;
+        TBlockMatcher::CLOSE_t closed = TBlockMatcher::close(blocks, event.method, &frame);
+
+        if (closed.entry < 0 || closed.dropped > 0)
+            result.errors.push_back(event.row);
+
+        QString className = destructedClass(method);
+
+        if (className.isEmpty())
+            continue;
+
+        auto iter = objects.find(className);
+
+        if (iter != objects.end() && !iter->empty())
+            iter->pop_back();
+    }
+
+    for (auto iter = objects.cbegin(); iter != objects.cend(); ++iter)
+    {
+        for (int row : iter.value())
+            result.mismatches.push_back({ row, iter.key() });
+    }
+}
+
+/**
+ * @brief TValidator::destructedClass
+ * @param text  The name of the method of a block exit.
+ * @return The name of the class of a destructor (Class::~Class) or an
+ * empty string.
+ */
+QString TValidator::destructedClass(const QString& text)
+{
+    qsizetype end = text.indexOf("::~");
+
+    if (end <= 0)
+        return QString();
+
+    qsizetype start = end;
+
+    while (start > 0 && (text[start - 1].isLetterOrNumber() || text[start - 1] == '_'))
+        start--;
+
+    return text.mid(start, end - start);
+}
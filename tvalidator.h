@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 by Andreas Theofilu <andreas@theosys.at>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+#ifndef TVALIDATOR_H
+#define TVALIDATOR_H
+
+#include <QString>
+#include <QHash>
+
+#include <vector>
+#include <atomic>
+
+#include "trowbitmap.h"
+#include "tblockmatcher.h"
+
+/**
+ * @brief The TValidator class
+ * Validates the blocks and the life time of objects in a logfile. A block
+ * starts with a line containing the block entry (see
+ * TConfig::getBlockEntry()) followed by the name of a method and ends with
+ * a line containing the block exit and the same name. The lines are paired
+ * by TBlockMatcher. A block exit without an open block of its method, or
+ * closing blocks above it that never got an exit, is an error. A constructor (Class::Class)
+ * without a following destructor (Class::~Class) is a method mismatch.
+ *
+ * The rows are added in order. Only the lines with a block entry or exit
+ * are kept, grouped by thread. Each thread has its own stack of blocks and
+ * a hash of the open constructors by class, so every line is handled in
+ * constant time. The threads are independent and are validated in
+ * parallel.
+ */
+class TValidator
+{
+    public:
+        typedef struct MISMATCH_t
+        {
+            int row{0};                         // The row of the constructor
+            QString className;                  // The class constructed
+        }MISMATCH_t;
+
+        TValidator(const QString& blockEntry, const QString& blockExit);
+
+        void addRow(int row, const QString& text, const QString& thread=QString());
+        void validate();
+        const TRowBitmap& errorRows() const { return mErrors; }
+        const std::vector<MISMATCH_t>& mismatches() const { return mMismatches; }
+
+    private:
+        typedef struct EVENT_t
+        {
+            int row{0};
+            TBlockMatcher::KIND_t kind{TBlockMatcher::KIND_ENTRY};
+            int method{0};                      // The number of the method (see TBlockMatcher::name())
+        }EVENT_t;
+
+        typedef struct FRAME_t
+        {
+            int method{0};
+            int row{0};
+        }FRAME_t;
+
+        typedef struct RESULT_t
+        {
+            std::vector<int> errors;            // The rows of the block exits not matching
+            std::vector<MISMATCH_t> mismatches;
+        }RESULT_t;
+
+        static void validateThreads(TValidator *self, std::atomic<size_t> *next, std::vector<RESULT_t> *results);
+        void validateThread(const std::vector<EVENT_t>& events, RESULT_t& result);
+        static QString destructedClass(const QString& text);
+
+        TBlockMatcher mMatcher;
+        QHash<QString, int> mThreadIndex;       // The index of a thread in mThreads
+        std::vector<std::vector<EVENT_t>> mThreads;     // The block lines of every thread in order
+        TRowBitmap mErrors;
+        std::vector<MISMATCH_t> mMismatches;
+};
+
+#endif // TVALIDATOR_H